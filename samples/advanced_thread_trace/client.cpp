@@ -267,46 +267,59 @@ dispatch_callback(rocprofiler_queue_id_t /* queue_id  */,
 }
 
 void
-get_trace_data(rocprofiler_att_parser_data_type_t type, void* att_data, void* userdata)
+get_trace_data(rocprofiler_att_parser_data_type_t type,
+               void*                              att_data,
+               size_t                             num_records,
+               void*                              userdata)
 {
     C_API_BEGIN
     assert(userdata && "ISA callback passed null!");
 
-    std::shared_lock<std::shared_mutex> shared_lock(tool->isa_map_mut);
-
-    if(type == ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY) tool->num_waves++;
+    if(type == ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY)
+        tool->num_waves += static_cast<int>(num_records);
 
     if(type != ROCPROFILER_ATT_PARSER_DATA_TYPE_ISA) return;
 
-    auto& event = *reinterpret_cast<rocprofiler_att_data_type_isa_t*>(att_data);
+    const auto* events = reinterpret_cast<rocprofiler_att_data_type_isa_t*>(att_data);
 
-    pcinfo_t pc{event.marker_id, event.offset};
-    auto     it = tool->isa_map.find(pc);
-    if(it == tool->isa_map.end())
+    std::shared_lock<std::shared_mutex> shared_lock(tool->isa_map_mut);
+
+    for(size_t i = 0; i < num_records; i++)
     {
-        shared_lock.unlock();
+        const auto& event = events[i];
+
+        pcinfo_t pc{event.marker_id, event.offset};
+        auto     it = tool->isa_map.find(pc);
+        if(it == tool->isa_map.end())
         {
-            std::unique_lock<std::shared_mutex> unique_lock(tool->isa_map_mut);
-            auto                                ptr = std::make_unique<isa_map_elem_t>();
-            try
+            shared_lock.unlock();
+            bool translated = true;
             {
-                ptr->code_line = tool->codeobjTranslate.get(pc.marker_id, pc.addr);
-            } catch(std::exception& e)
-            {
-                std::cerr << pc.marker_id << ":" << pc.addr << ' ' << e.what() << std::endl;
-                return;
-            } catch(...)
-            {
-                std::cerr << "Could not fetch: " << pc.marker_id << ':' << pc.addr << std::endl;
-                return;
+                std::unique_lock<std::shared_mutex> unique_lock(tool->isa_map_mut);
+                auto                                ptr = std::make_unique<isa_map_elem_t>();
+                try
+                {
+                    ptr->code_line = tool->codeobjTranslate.get(pc.marker_id, pc.addr);
+                    it             = tool->isa_map.emplace(pc, std::move(ptr)).first;
+                } catch(std::exception& e)
+                {
+                    std::cerr << pc.marker_id << ":" << pc.addr << ' ' << e.what() << std::endl;
+                    translated = false;
+                } catch(...)
+                {
+                    std::cerr << "Could not fetch: " << pc.marker_id << ':' << pc.addr
+                              << std::endl;
+                    translated = false;
+                }
             }
-            it = tool->isa_map.emplace(pc, std::move(ptr)).first;
+            // the unique_lock must be released before taking the shared lock again
+            shared_lock.lock();
+            if(!translated) continue;
         }
-        shared_lock.lock();
-    }
 
-    it->second->hitcount.fetch_add(event.hitcount, std::memory_order_relaxed);
-    it->second->latency.fetch_add(event.latency, std::memory_order_relaxed);
+        it->second->hitcount.fetch_add(event.hitcount, std::memory_order_relaxed);
+        it->second->latency.fetch_add(event.latency, std::memory_order_relaxed);
+    }
     C_API_END
 }
 
@@ -372,7 +385,8 @@ shader_data_callback(int64_t se_id,
         tool->output() << "SE ID: " << se_id << " with size " << data_size << std::hex << '\n';
     }
     trace_data_t data{.id = se_id, .data = (uint8_t*) se_data, .size = data_size};
-    auto status = rocprofiler_att_parse_data(copy_trace_data, get_trace_data, isa_callback, &data);
+    auto status =
+        rocprofiler_att_parse_data_batched(copy_trace_data, get_trace_data, isa_callback, &data);
     if(status != ROCPROFILER_STATUS_SUCCESS)
         std::cerr << "shader_data_callback failed with status " << status << std::endl;
     C_API_END
@@ -172,6 +172,10 @@ For MPI applications (or other job launchers such as SLURM), place rocprofv3 ins
         "--kernel-rename",
         help="Use region names defined by roctxRangePush/roctxRangePop regions to rename the kernels",
     )
+    add_parser_bool_argument(
+        "--compress-tmp-files",
+        help="Compress the records which are offloaded to temporary files during the run",
+    )
     parser.add_argument(
         "-i",
         "--input",
@@ -266,6 +270,22 @@ For MPI applications (or other job launchers such as SLURM), place rocprofv3 ins
         metavar="KB",
     )
 
+    parser.add_argument(
+        "--callback-thread-affinity",
+        help="Pin the threads which process the trace buffers to these CPUs, e.g. '0-3 8'. Other threads created by rocprofiler-sdk (e.g. the buffer flush timer, PC sampling parser workers) are not affected",
+        nargs="+",
+        default=None,
+        type=str,
+        metavar="CPU",
+    )
+    parser.add_argument(
+        "--callback-thread-priority",
+        help="Nice value [-20, 19] of the threads which process the trace buffers. Other threads created by rocprofiler-sdk are not affected",
+        default=None,
+        type=int,
+        metavar="NICE",
+    )
+
     if args is None:
         args = sys.argv[1:]
 
@@ -618,6 +638,7 @@ def run(app_args, args, **kwargs):
     for opt, env_val in dict(
         [
             ["kernel_rename", "KERNEL_RENAME"],
+            ["compress_tmp_files", "TMP_COMPRESSION"],
         ]
     ).items():
         val = getattr(args, f"{opt}")
@@ -630,6 +651,8 @@ def run(app_args, args, **kwargs):
             ["perfetto_shmem_size_hint", "PERFETTO_SHMEM_SIZE_HINT_KB"],
             ["perfetto_fill_policy", "PERFETTO_BUFFER_FILL_POLICY"],
             ["perfetto_backend", "PERFETTO_BACKEND"],
+            ["callback_thread_affinity", "CALLBACK_THREAD_AFFINITY"],
+            ["callback_thread_priority", "CALLBACK_THREAD_PRIORITY"],
         ]
     ).items():
         val = getattr(args, f"{opt}")
@@ -154,6 +154,22 @@ typedef void (*rocprofiler_att_parser_trace_callback_t)(rocprofiler_att_parser_d
                                                         void*                              att_data,
                                                         void* userdata);
 
+/**
+ * @brief Callback for rocprofiler to return batches of traces back to the caller.
+ * Each call delivers a contiguous array of records of the same type.
+ * @param[in] type Type of the records in att_data.
+ * @param[in] att_data Array of rocprofiler_att_data_type_isa_t (for
+ * ROCPROFILER_ATT_PARSER_DATA_TYPE_ISA) or rocprofiler_att_data_type_occupancy_t (for
+ * ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY). Only valid for the duration of the call.
+ * @param[in] num_records Number of records in att_data.
+ * @param[in] userdata Arbitrary data pointer to be sent back to the user via callback.
+ */
+typedef void (*rocprofiler_att_parser_trace_batch_callback_t)(
+    rocprofiler_att_parser_data_type_t type,
+    void*                              att_data,
+    size_t                             num_records,
+    void*                              userdata);
+
 /**
  * @brief Iterate over all event coordinates for a given agent_t and event_t.
  * @param[in] se_data_callback Callback to return shader engine data from.
@@ -167,6 +183,57 @@ rocprofiler_att_parse_data(rocprofiler_att_parser_se_data_callback_t se_data_cal
                            rocprofiler_att_parser_isa_callback_t     isa_callback,
                            void*                                     userdata) ROCPROFILER_API;
 
+/**
+ * @brief Same as rocprofiler_att_parse_data, but the trace data is delivered in batches: each
+ * chunk of decoded events is returned to trace_callback as a contiguous array, instead of one
+ * call per event.
+ * @param[in] se_data_callback Callback to return shader engine data from.
+ * @param[in] trace_callback Callback where the batches of trace data are returned to.
+ * @param[in] isa_callback Callback to return ISA lines.
+ * @param[in] userdata Userdata passed back to caller via callback.
+ */
+rocprofiler_status_t
+rocprofiler_att_parse_data_batched(rocprofiler_att_parser_se_data_callback_t     se_data_callback,
+                                   rocprofiler_att_parser_trace_batch_callback_t trace_callback,
+                                   rocprofiler_att_parser_isa_callback_t         isa_callback,
+                                   void* userdata) ROCPROFILER_API;
+
+/**
+ * @brief Trace data of a single shader engine, fully available in memory.
+ */
+typedef struct
+{
+    int64_t        shader_engine_id;  ///< ID of the shader engine, as enabled by SE_MASK
+    const uint8_t* data;              ///< Trace data of the shader engine
+    uint64_t       size;              ///< Number of bytes in data
+} rocprofiler_att_parser_se_data_t;
+
+/**
+ * @brief Decodes the trace data of several shader engines concurrently.
+ * Every shader engine is an independent stream, decoded by one of num_threads threads
+ * (including the calling thread). Batches are delivered to trace_callback on the calling thread,
+ * shader engine by shader engine in the order of se_data, as soon as each shader engine is
+ * decoded, hence the output does not depend on the number of threads.
+ * At most num_threads decoded shader engines are kept in memory until delivered.
+ * @param[in] se_data Array of shader engine data to decode.
+ * @param[in] num_se_data Number of elements in se_data.
+ * @param[in] trace_callback Callback where the batches of trace data are returned to.
+ * @param[in] isa_callback Callback to return ISA lines. May be invoked concurrently by
+ * several threads, hence it must be thread-safe.
+ * @param[in] num_threads Maximum number of threads decoding. Zero uses all hardware threads.
+ * @param[in] userdata Userdata passed back to caller via callback.
+ * @retval ROCPROFILER_STATUS_SUCCESS on success.
+ * @retval ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT for null se_data or callbacks.
+ * @returns The first error reported by the decoder, in the order of se_data.
+ */
+rocprofiler_status_t
+rocprofiler_att_parse_data_parallel(const rocprofiler_att_parser_se_data_t*       se_data,
+                                    size_t                                        num_se_data,
+                                    rocprofiler_att_parser_trace_batch_callback_t trace_callback,
+                                    rocprofiler_att_parser_isa_callback_t         isa_callback,
+                                    size_t                                        num_threads,
+                                    void* userdata) ROCPROFILER_API;
+
 /** @} */
 
 ROCPROFILER_EXTERN_C_FINI
@@ -63,7 +63,9 @@ typedef rocprofiler_att_control_flags_t (*rocprofiler_att_dispatch_callback_t)(
  * @param [in] parameters List of ATT-specific parameters.
  * @param [in] num_parameters Number of parameters. Zero is allowed.
  * @param [in] dispatch_callback Control fn which decides when ATT starts/stop collecting.
- * @param [in] shader_callback Callback fn where the collected data will be sent to.
+ * @param [in] shader_callback Callback fn where the collected data will be sent to. Invoked from
+ * an internal thread after the dispatch completes, in order of completion. All pending data is
+ * delivered before the context is stopped.
  * @param [in] callback_userdata Passed back to user.
  */
 rocprofiler_status_t
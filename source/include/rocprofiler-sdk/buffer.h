@@ -84,6 +84,77 @@ rocprofiler_create_buffer(rocprofiler_context_id_t        context,
                           rocprofiler_buffer_id_t*        buffer_id) ROCPROFILER_API
     ROCPROFILER_NONNULL(5, 7);
 
+/**
+ * @brief Memory placement flags of a buffer, see ::rocprofiler_buffer_properties_t
+ */
+typedef enum rocprofiler_buffer_memory_flags_t
+{
+    /// Base pages which are faulted in on first write
+    ROCPROFILER_BUFFER_MEMORY_NONE = 0,
+    /// Explicit huge pages (MAP_HUGETLB). Requires reserved huge pages, otherwise transparent huge
+    /// pages are used. The size of the buffer is rounded up to a multiple of the huge page size
+    ROCPROFILER_BUFFER_MEMORY_HUGE_PAGES = (1 << 0),
+    /// Advise the kernel to back the buffer with transparent huge pages (MADV_HUGEPAGE)
+    ROCPROFILER_BUFFER_MEMORY_TRANSPARENT_HUGE_PAGES = (1 << 1),
+    /// Fault in every page when the buffer is created instead of on the first write
+    ROCPROFILER_BUFFER_MEMORY_PREFAULT = (1 << 2),
+} rocprofiler_buffer_memory_flags_t;
+
+/**
+ * @brief Optional properties of a buffer, see ::rocprofiler_create_buffer_with_properties
+ *
+ * Buffers with a flush interval are flushed by an internal timer thread once their oldest record
+ * has been held for that long, which bounds the delivery latency of buffers receiving few records.
+ *
+ * Without a NUMA binding, the pages of a buffer are allocated on the NUMA node of the thread which
+ * first writes to them, i.e. the producer, unless ::ROCPROFILER_BUFFER_MEMORY_PREFAULT is set.
+ */
+typedef struct rocprofiler_buffer_properties_t
+{
+    /// Size of this struct
+    uint64_t size;
+    /// Bitwise-or of ::rocprofiler_buffer_memory_flags_t values
+    uint64_t memory_flags;
+    /// NUMA node to bind the memory of the buffer to. Negative values disable the binding
+    int64_t numa_node;
+    /// When @ref numa_node is negative and the handle is non-zero, bind the memory of the buffer to
+    /// the NUMA node of this agent (the node closest to the PCIe device for GPU agents)
+    rocprofiler_agent_id_t numa_agent;
+    /// Maximum time in nanoseconds a record is held in the buffer before the buffer is flushed,
+    /// even if the watermark has not been reached. Zero disables the flush timer for the buffer.
+    uint64_t flush_interval_ns;
+} rocprofiler_buffer_properties_t;
+
+/**
+ * @brief Create buffer with memory placement and flush timer properties. Equivalent to
+ * ::rocprofiler_create_buffer when the properties are zero-initialized except for
+ * rocprofiler_buffer_properties_t::size and rocprofiler_buffer_properties_t::numa_node is -1.
+ *
+ * @param [in] context Context identifier associated with buffer
+ * @param [in] size Size of the buffer in bytes
+ * @param [in] watermark - watermark size, where the callback is called, if set
+ * to 0 then the callback will be called on every record
+ * @param [in] policy Behavior policy when buffer is full
+ * @param [in] callback Callback to invoke when buffer is flushed/full
+ * @param [in] callback_data Data to provide in callback function
+ * @param [in] properties Memory placement and flush interval of the buffer
+ * @param [out] buffer_id Identification handle for buffer
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_ERROR_INCOMPATIBLE_ABI properties.size is not set
+ * @retval ::ROCPROFILER_STATUS_ERROR_AGENT_NOT_FOUND properties.numa_agent is not a valid agent
+ * @retval ::ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT Unknown memory flags
+ */
+rocprofiler_status_t
+rocprofiler_create_buffer_with_properties(rocprofiler_context_id_t        context,
+                                          size_t                          size,
+                                          size_t                          watermark,
+                                          rocprofiler_buffer_policy_t     policy,
+                                          rocprofiler_buffer_tracing_cb_t callback,
+                                          void*                           callback_data,
+                                          rocprofiler_buffer_properties_t properties,
+                                          rocprofiler_buffer_id_t*        buffer_id) ROCPROFILER_API
+    ROCPROFILER_NONNULL(5, 8);
+
 /**
  * @brief Destroy buffer.
  *
@@ -92,6 +163,8 @@ rocprofiler_create_buffer(rocprofiler_context_id_t        context,
  *
  * Note: This will destroy the buffer even if it is not empty. The user can
  * call @ref ::rocprofiler_flush_buffer before it to make sure the buffer is empty.
+ * Threads waiting in @ref ::rocprofiler_flush_buffer return
+ * ::ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND once the buffer is destroyed.
  */
 rocprofiler_status_t
 rocprofiler_destroy_buffer(rocprofiler_buffer_id_t buffer_id) ROCPROFILER_API;
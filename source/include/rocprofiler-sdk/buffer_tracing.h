@@ -25,6 +25,8 @@
 #include <rocprofiler-sdk/agent.h>
 #include <rocprofiler-sdk/defines.h>
 #include <rocprofiler-sdk/fwd.h>
+#include <rocprofiler-sdk/hip.h>
+#include <rocprofiler-sdk/hsa.h>
 
 #include <stdint.h>
 
@@ -125,6 +127,54 @@ typedef struct
     /// ::rocprofiler_hip_compiler_api_id_t
 } rocprofiler_buffer_tracing_hip_api_record_t;
 
+/**
+ * @brief ROCProfiler Buffer HSA API Tracer Record with the arguments and return value of the call.
+ *
+ * Emitted in place of ::rocprofiler_buffer_tracing_hsa_api_record_t when the argument capture was
+ * requested via ::rocprofiler_configure_buffer_tracing_api_args. The leading fields are identical
+ * to ::rocprofiler_buffer_tracing_hsa_api_record_t, a size field larger than the size of that
+ * record tells the two records apart. Only the member of the args union for the operation is
+ * stored, i.e. the size of the record is the offset of args plus the size of that member. The
+ * arguments are copied verbatim: pointer arguments refer to the memory of the application at the
+ * time of the call. See ::rocprofiler_iterate_buffer_tracing_record_args.
+ */
+typedef struct
+{
+    uint64_t                          size;  ///< size of this struct
+    rocprofiler_buffer_tracing_kind_t kind;
+    rocprofiler_tracing_operation_t   operation;
+    rocprofiler_correlation_id_t      correlation_id;   ///< correlation ids for record
+    rocprofiler_timestamp_t           start_timestamp;  ///< start time in nanoseconds
+    rocprofiler_timestamp_t           end_timestamp;    ///< end time in nanoseconds
+    rocprofiler_thread_id_t           thread_id;        ///< id for thread generating this record
+    rocprofiler_hsa_api_retval_t      retval;           ///< return value of the call
+    rocprofiler_hsa_api_args_t        args;             ///< arguments of the call, see size
+} rocprofiler_buffer_tracing_hsa_api_ext_record_t;
+
+/**
+ * @brief ROCProfiler Buffer HIP API Tracer Record with the arguments and return value of the call.
+ *
+ * Emitted in place of ::rocprofiler_buffer_tracing_hip_api_record_t when the argument capture was
+ * requested via ::rocprofiler_configure_buffer_tracing_api_args. The leading fields are identical
+ * to ::rocprofiler_buffer_tracing_hip_api_record_t, a size field larger than the size of that
+ * record tells the two records apart. Only the member of the args union for the operation is
+ * stored, i.e. the size of the record is the offset of args plus the size of that member. The
+ * arguments are copied verbatim: pointer arguments refer to the memory of the application at the
+ * time of the call. See ::rocprofiler_iterate_buffer_tracing_record_args.
+ */
+typedef struct
+{
+    uint64_t                          size;  ///< size of this struct
+    rocprofiler_buffer_tracing_kind_t kind;
+    rocprofiler_tracing_operation_t   operation;
+    rocprofiler_correlation_id_t      correlation_id;   ///< correlation ids for record
+    rocprofiler_timestamp_t           start_timestamp;  ///< start time in nanoseconds
+    rocprofiler_timestamp_t           end_timestamp;    ///< end time in nanoseconds
+    rocprofiler_thread_id_t           thread_id;        ///< id for thread generating this record
+    rocprofiler_hip_api_retval_t      retval;           ///< return value of the call
+    rocprofiler_hip_api_args_t        args;             ///< arguments of the call, see size
+} rocprofiler_buffer_tracing_hip_api_ext_record_t;
+
 /**
  * @brief ROCProfiler Buffer Marker Tracer Record.
  */
@@ -137,6 +187,7 @@ typedef struct
     rocprofiler_timestamp_t           start_timestamp;  ///< start time in nanoseconds
     rocprofiler_timestamp_t           end_timestamp;    ///< end time in nanoseconds
     rocprofiler_thread_id_t           thread_id;        ///< id for thread generating this record
+    uint64_t                          message_id;       ///< id of the interned message
 
     /// @var kind
     /// @brief ::ROCPROFILER_CALLBACK_TRACING_MARKER_CORE_API,
@@ -145,6 +196,11 @@ typedef struct
     /// @brief Specification of the API function, e.g., ::rocprofiler_marker_core_api_id_t,
     /// ::rocprofiler_marker_control_api_id_t, or
     /// ::rocprofiler_marker_name_api_id_t
+    /// @var message_id
+    /// @brief Message of the roctxMarkA, roctxRangePushA and roctxRangeStartA calls, resolved via
+    /// ::rocprofiler_query_buffer_tracing_marker_message. Identical messages share the same id.
+    /// Zero for the other operations, for null messages, and once the table of messages has run
+    /// out of ids (a warning is logged the first time).
 } rocprofiler_buffer_tracing_marker_api_record_t;
 
 /**
@@ -410,6 +466,93 @@ rocprofiler_iterate_buffer_tracing_kind_operations(
     rocprofiler_buffer_tracing_kind_operation_cb_t callback,
     void*                                          data) ROCPROFILER_API ROCPROFILER_NONNULL(2);
 
+/**
+ * @brief Callback function for iterating over the arguments of an API call captured in a buffer
+ * record. @see rocprofiler_iterate_buffer_tracing_record_args. The parameters match those of @ref
+ * rocprofiler_callback_tracing_operation_args_cb_t, except that kind is the buffer tracing kind of
+ * the record.
+ *
+ * @return int
+ * @retval 0 Continue iterating over the arguments
+ * @retval 1 Stop iterating over the arguments
+ */
+typedef int (*rocprofiler_buffer_tracing_operation_args_cb_t)(
+    rocprofiler_buffer_tracing_kind_t kind,
+    rocprofiler_tracing_operation_t   operation,
+    uint32_t                          arg_number,
+    const void* const                 arg_value_addr,
+    int32_t                           arg_indirection_count,
+    const char*                       arg_type,
+    const char*                       arg_name,
+    const char*                       arg_value_str,
+    int32_t                           arg_dereference_count,
+    void*                             data);
+
+/**
+ * @brief Request that the buffer records of the API tracing kind carry a copy of the arguments and
+ * of the return value of each call, i.e. ::rocprofiler_buffer_tracing_hsa_api_ext_record_t or
+ * ::rocprofiler_buffer_tracing_hip_api_ext_record_t instead of the records without arguments. The
+ * arguments are copied as-is on the calling thread; converting them to strings is left to the
+ * consumer of the buffer via ::rocprofiler_iterate_buffer_tracing_record_args.
+ *
+ * @param [in] context_id Context in which the buffer tracing service has been configured
+ * @param [in] kind One of the HSA or HIP API buffer tracing kinds
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_SUCCESS Records of the kind will carry the arguments
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED ::rocprofiler_configure initialization
+ * phase has passed
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONTEXT_NOT_FOUND context is not valid
+ * @retval ::ROCPROFILER_STATUS_ERROR_KIND_NOT_FOUND kind is not a HSA or HIP API tracing kind
+ * @retval ::ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT the buffer tracing service has not been
+ * configured for the kind in the context
+ */
+rocprofiler_status_t
+rocprofiler_configure_buffer_tracing_api_args(rocprofiler_context_id_t          context_id,
+                                              rocprofiler_buffer_tracing_kind_t kind)
+    ROCPROFILER_API;
+
+/**
+ * @brief Iterates over the arguments of an API call captured in a
+ * ::rocprofiler_buffer_tracing_hsa_api_ext_record_t or
+ * ::rocprofiler_buffer_tracing_hip_api_ext_record_t buffer record and provides each argument,
+ * converted to a string, to the callback. This is typically invoked from the buffer callback, so
+ * that the conversion is performed outside of the thread which made the API call.
+ *
+ * The memory of the application may no longer be valid at the time of this call, hence pointer and
+ * string arguments are never read: their address is provided instead and the dereference count
+ * passed to the callback is always zero.
+ *
+ * @param [in] header Buffer record whose payload is the record with arguments
+ * @param [in] callback Function invoked for each argument
+ * @param [in] user_data Data passed back to the callback
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_SUCCESS The arguments have been iterated over
+ * @retval ::ROCPROFILER_STATUS_ERROR_KIND_NOT_FOUND The record is not a HSA or HIP API tracing
+ * record
+ * @retval ::ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT The record does not carry the arguments
+ */
+rocprofiler_status_t
+rocprofiler_iterate_buffer_tracing_record_args(
+    rocprofiler_record_header_t                    header,
+    rocprofiler_buffer_tracing_operation_args_cb_t callback,
+    void* user_data) ROCPROFILER_API ROCPROFILER_NONNULL(2);
+
+/**
+ * @brief Query the message of a ::rocprofiler_buffer_tracing_marker_api_record_t. Marker messages
+ * are interned when the record is generated, hence this does not read the memory of the
+ * application and the returned string remains valid until the library is unloaded.
+ *
+ * @param [in] message_id The message_id field of the marker record
+ * @param [out] message Set to the null-terminated message
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_SUCCESS message has been set
+ * @retval ::ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT message_id does not refer to a message
+ */
+rocprofiler_status_t
+rocprofiler_query_buffer_tracing_marker_message(uint64_t     message_id,
+                                                const char** message) ROCPROFILER_API
+    ROCPROFILER_NONNULL(2);
+
 /** @} */
 
 ROCPROFILER_EXTERN_C_FINI
@@ -24,15 +24,19 @@
 
 #include <elfutils/libdw.h>
 #include <hsa/amd_hsa_elf.h>
+#include <libelf.h>
 
 #include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "disassembly.hpp"
@@ -64,98 +68,198 @@ struct Instruction
     marker_id_t codeobj_id{0};  // Instruction code object load id, if from loaded codeobj
 };
 
-class CodeobjDecoderComponent
+/**
+ * @brief Instructions of a kernel symbol, decoded in one pass. Every distinct instruction text and
+ * source line is stored once in strings, and entries refer to them by index. Tables can be saved
+ * to a stream and loaded back, e.g. to annotate samples offline.
+ */
+struct InstructionTable
 {
-    struct ProtectedFd
+    struct Entry
     {
-        ProtectedFd(std::string_view uri)
-        {
-#if defined(_GNU_SOURCE) && defined(MFD_ALLOW_SEALING) && defined(MFD_CLOEXEC)
-            m_fd = ::memfd_create(uri.data(), MFD_ALLOW_SEALING | MFD_CLOEXEC);
-#endif
-            if(m_fd == -1) m_fd = ::open("/tmp", O_TMPFILE | O_RDWR, 0666);
-            if(m_fd == -1) throw std::runtime_error("Could not create a file for codeobj!");
-        }
-        ~ProtectedFd()
-        {
-            if(m_fd != -1) ::close(m_fd);
-        }
-        int m_fd{-1};
+        uint64_t offset{0};   // Offset from InstructionTable::vaddr
+        uint32_t size{0};     // Size of the instruction in bytes
+        uint32_t inst{0};     // Index of the instruction text in strings
+        uint32_t comment{0};  // Index of the source line in strings, 0 if unknown
     };
 
-public:
-    CodeobjDecoderComponent(const char* codeobj_data, uint64_t codeobj_size)
+    std::string              symbol{};
+    uint64_t                 vaddr{0};  // Address of the symbol in the code object
+    uint64_t                 size{0};
+    std::vector<Entry>       entries{};  // Sorted by offset
+    std::vector<std::string> strings{std::string{}};
+
+    /// @brief Returns the instruction containing addr, nullptr if there is none
+    const Entry* find(uint64_t addr) const
     {
-        ProtectedFd prot("");
-        if(::write(prot.m_fd, codeobj_data, codeobj_size) != static_cast<int64_t>(codeobj_size))
-            throw std::runtime_error("Could not write to temporary file!");
+        if(addr < vaddr) return nullptr;
 
-        ::lseek(prot.m_fd, 0, SEEK_SET);
-        fsync(prot.m_fd);
+        uint64_t offset = addr - vaddr;
+        auto     it     = std::upper_bound(
+            entries.begin(), entries.end(), offset, [](uint64_t _offset, const Entry& entry) {
+                return _offset < entry.offset;
+            });
+        if(it == entries.begin()) return nullptr;
 
-        m_line_number_map = {};
+        --it;
+        return (offset < it->offset + it->size) ? &*it : nullptr;
+    }
 
-        std::unique_ptr<Dwarf, void (*)(Dwarf*)> dbg(dwarf_begin(prot.m_fd, DWARF_C_READ),
-                                                     [](Dwarf* _dbg) { dwarf_end(_dbg); });
+    const std::string& instruction(const Entry& entry) const { return strings.at(entry.inst); }
+    const std::string& comment(const Entry& entry) const { return strings.at(entry.comment); }
 
-        if(dbg)
+    void save(std::ostream& os) const
+    {
+        auto write_u64 = [&os](uint64_t val) {
+            os.write(reinterpret_cast<const char*>(&val), sizeof(val));
+        };
+        auto write_str = [&](const std::string& str) {
+            write_u64(str.size());
+            os.write(str.data(), str.size());
+        };
+
+        os.write(file_magic, sizeof(file_magic));
+        write_u64(file_version);
+        write_str(symbol);
+        write_u64(vaddr);
+        write_u64(size);
+        write_u64(strings.size());
+        for(const auto& str : strings)
+            write_str(str);
+        write_u64(entries.size());
+        for(const auto& entry : entries)
         {
-            Dwarf_Off cu_offset{0}, next_offset;
-            size_t    header_size;
+            write_u64(entry.offset);
+            write_u64((uint64_t{entry.inst} << 32) | entry.size);
+            write_u64(entry.comment);
+        }
+    }
 
-            std::map<uint64_t, std::string> line_addrs;
+    /// @brief Loads a table written by save(). Returns std::nullopt if the data is not valid or
+    /// is truncated. Sizes read from the stream are never trusted beyond the bytes left in it.
+    static std::optional<InstructionTable> load(std::istream& is)
+    {
+        // Bytes left in the stream, when it can be measured
+        auto avail = std::numeric_limits<uint64_t>::max();
+        if(auto pos = is.tellg(); pos != std::istream::pos_type(-1))
+        {
+            is.seekg(0, std::ios::end);
+            auto end = is.tellg();
+            is.seekg(pos);
+            if(!is || end < pos) return std::nullopt;
+            avail = static_cast<uint64_t>(end - pos);
+        }
 
-            while(!dwarf_nextcu(
-                dbg.get(), cu_offset, &next_offset, &header_size, nullptr, nullptr, nullptr))
-            {
-                Dwarf_Die die;
-                if(!dwarf_offdie(dbg.get(), cu_offset + header_size, &die)) continue;
+        auto read = [&](char* dst, uint64_t len) {
+            if(!is || len > avail) return false;
+            is.read(dst, len);
+            avail -= len;
+            return static_cast<bool>(is);
+        };
+        auto read_u64 = [&](uint64_t& val) {
+            return read(reinterpret_cast<char*>(&val), sizeof(val));
+        };
+        auto read_str = [&](std::string& str) {
+            uint64_t len = 0;
+            if(!read_u64(len) || len > avail || len > max_string_size) return false;
+            str.resize(len);
+            return read(str.data(), len);
+        };
+        // Number of elements of elem_size bytes which can still be stored in the stream
+        auto read_count = [&](uint64_t& count, uint64_t elem_size) {
+            return read_u64(count) && count <= avail / elem_size;
+        };
+
+        char     magic[sizeof(file_magic)] = {};
+        uint64_t version                   = 0;
+        if(!read(magic, sizeof(magic)) || std::memcmp(magic, file_magic, sizeof(magic)) != 0)
+            return std::nullopt;
+        if(!read_u64(version) || version != file_version) return std::nullopt;
+
+        auto table = InstructionTable{};
+        if(!read_str(table.symbol)) return std::nullopt;
+        if(!read_u64(table.vaddr) || !read_u64(table.size)) return std::nullopt;
+
+        // Grow the containers while reading, hence a bogus count on a stream of unknown length
+        // fails at the end of the stream instead of allocating up front
+        uint64_t num_strings = 0;
+        if(!read_count(num_strings, sizeof(uint64_t)) || num_strings == 0) return std::nullopt;
+        table.strings.clear();
+        table.strings.reserve(std::min<uint64_t>(num_strings, max_reserve));
+        for(uint64_t i = 0; i < num_strings; ++i)
+            if(!read_str(table.strings.emplace_back())) return std::nullopt;
+
+        uint64_t num_entries = 0;
+        if(!read_count(num_entries, 3 * sizeof(uint64_t))) return std::nullopt;
+        table.entries.reserve(std::min<uint64_t>(num_entries, max_reserve));
+        for(uint64_t i = 0; i < num_entries; ++i)
+        {
+            uint64_t offset  = 0;
+            uint64_t packed  = 0;
+            uint64_t comment = 0;
+            if(!read_u64(offset) || !read_u64(packed) || !read_u64(comment)) return std::nullopt;
+
+            auto& entry   = table.entries.emplace_back();
+            entry.offset  = offset;
+            entry.inst    = static_cast<uint32_t>(packed >> 32);
+            entry.size    = static_cast<uint32_t>(packed);
+            entry.comment = static_cast<uint32_t>(comment);
+            if(entry.inst >= table.strings.size() || comment >= table.strings.size())
+                return std::nullopt;
+        }
 
-                Dwarf_Lines* lines;
-                size_t       line_count;
-                if(dwarf_getsrclines(&die, &lines, &line_count)) continue;
+        return table;
+    }
 
-                for(size_t i = 0; i < line_count; ++i)
-                {
-                    Dwarf_Addr  addr;
-                    int         line_number;
-                    Dwarf_Line* line = dwarf_onesrcline(lines, i);
-
-                    if(line && !dwarf_lineaddr(line, &addr) && !dwarf_lineno(line, &line_number) &&
-                       line_number)
-                    {
-                        std::string src        = dwarf_linesrc(line, nullptr, nullptr);
-                        auto        dwarf_line = src + ':' + std::to_string(line_number);
-
-                        if(line_addrs.find(addr) != line_addrs.end())
-                        {
-                            line_addrs.at(addr) += ' ' + dwarf_line;
-                            continue;
-                        }
-
-                        line_addrs.emplace(addr, std::move(dwarf_line));
-                    }
-                }
-                cu_offset = next_offset;
-            }
+    static constexpr char     file_magic[8] = {'R', 'O', 'C', 'P', 'I', 'N', 'S', 'T'};
+    static constexpr uint64_t file_version  = 1;
 
-            auto it = line_addrs.begin();
-            if(it != line_addrs.end())
-            {
-                while(std::next(it) != line_addrs.end())
-                {
-                    uint64_t delta   = std::next(it)->first - it->first;
-                    auto     segment = segment::address_range_t{it->first, delta, 0};
-                    m_line_number_map.emplace(segment, std::move(it->second));
-                    it++;
-                }
-                auto segment = segment::address_range_t{it->first, codeobj_size - it->first, 0};
-                m_line_number_map.emplace(segment, std::move(it->second));
-            }
-        }
+    static constexpr uint64_t max_string_size = 1 << 20;  // Longest instruction or source line
+    static constexpr uint64_t max_reserve     = 1 << 16;  // Elements reserved ahead of reading
+};
+
+/**
+ * @brief Decodes the instructions of a code object. Source lines are read from the DWARF line
+ * table of a compile unit the first time one of its addresses is looked up, and decoded
+ * instructions are cached, so repeated lookups of an address do not call into comgr.
+ * Lookups are thread-safe.
+ */
+class CodeobjDecoderComponent
+{
+    using elf_ptr_t   = std::unique_ptr<Elf, int (*)(Elf*)>;
+    using dwarf_ptr_t = std::unique_ptr<Dwarf, int (*)(Dwarf*)>;
+    using table_ptr_t = std::shared_ptr<const InstructionTable>;
+
+public:
+    CodeobjDecoderComponent(const char* codeobj_data, uint64_t codeobj_size)
+    : CodeobjDecoderComponent(codeobj_data, codeobj_size, nullptr)
+    {}
+
+    /**
+     * @brief If file is given, codeobj_data points into the file mapping and neither the
+     * disassembler nor the DWARF reader copies the code object.
+     */
+    CodeobjDecoderComponent(const char*                 codeobj_data,
+                            uint64_t                    codeobj_size,
+                            std::shared_ptr<MappedFile> file)
+    : m_code_size(codeobj_size)
+    {
+        // File mappings are read-only. libelf only writes to the image when it has to convert
+        // the byte order, in which case the code object is copied
+        if(file && !is_native_byte_order(codeobj_data, codeobj_size)) file = nullptr;
 
         // Can throw
-        disassembly = std::make_unique<DisassemblyInstance>(codeobj_data, codeobj_size);
+        disassembly =
+            std::make_unique<DisassemblyInstance>(codeobj_data, codeobj_size, std::move(file));
+
+        // DWARF is read from the code object in place, see above
+        elf_version(EV_CURRENT);
+        auto* image = const_cast<char*>(disassembly->code_data());
+
+        m_elf = elf_ptr_t{elf_memory(image, codeobj_size), elf_end};
+        if(m_elf)
+            m_dwarf = dwarf_ptr_t{dwarf_begin_elf(m_elf.get(), DWARF_C_READ, nullptr), dwarf_end};
+
         try
         {
             m_symbol_map = disassembly->GetKernelMap();  // Can throw
@@ -174,22 +278,177 @@ public:
     {
         if(!disassembly) throw std::exception();
 
-        auto pair   = disassembly->ReadInstruction(faddr);
-        auto inst   = std::make_unique<Instruction>(std::move(pair.first), pair.second);
-        inst->faddr = faddr;
-        inst->vaddr = vaddr;
+        std::lock_guard<std::mutex> lk(m_mutex);
+
+        if(auto it = m_inst_cache.find(vaddr); it != m_inst_cache.end())
+            return std::make_unique<Instruction>(it->second);
+
+        auto pair  = disassembly->ReadInstruction(faddr);
+        auto inst  = Instruction{std::move(pair.first), pair.second};
+        inst.faddr = faddr;
+        inst.vaddr = vaddr;
 
-        auto it = m_line_number_map.find({vaddr, 0, 0});
-        if(it != m_line_number_map.end()) inst->comment = it->second;
+        if(const auto* line = get_source_line(vaddr)) inst.comment = *line;
 
-        return inst;
+        auto it = m_inst_cache.emplace(vaddr, std::move(inst)).first;
+        return std::make_unique<Instruction>(it->second);
+    }
+
+    /**
+     * @brief Decodes every instruction of symbol in one pass. Decoding stops at the end of the
+     * symbol or at the first instruction that fails to decode. Tables are cached per symbol.
+     */
+    table_ptr_t disassemble_symbol(const SymbolInfo& symbol)
+    {
+        if(!disassembly) throw std::exception();
+
+        std::lock_guard<std::mutex> lk(m_mutex);
+
+        if(auto it = m_tables.find(symbol.vaddr); it != m_tables.end()) return it->second;
+
+        auto table    = std::make_shared<InstructionTable>();
+        table->symbol = symbol.name;
+        table->vaddr  = symbol.vaddr;
+        table->size   = symbol.mem_size;
+
+        auto index     = std::unordered_map<std::string, uint32_t>{{table->strings.at(0), 0}};
+        auto intern_at = [&](const std::string& str) {
+            auto [it, inserted] = index.emplace(str, table->strings.size());
+            if(inserted) table->strings.emplace_back(str);
+            return it->second;
+        };
+
+        for(uint64_t offset = 0; offset < symbol.mem_size;)
+        {
+            auto pair = std::pair<std::string, size_t>{};
+            try
+            {
+                pair = disassembly->ReadInstruction(symbol.faddr + offset);
+            } catch(...)
+            {
+                break;
+            }
+            if(pair.second == 0) break;
+
+            const auto* line  = get_source_line(symbol.vaddr + offset);
+            auto        entry = InstructionTable::Entry{};
+            entry.offset      = offset;
+            entry.size        = static_cast<uint32_t>(pair.second);
+            entry.inst        = intern_at(pair.first);
+            entry.comment     = (line) ? intern_at(*line) : 0;
+            table->entries.emplace_back(entry);
+
+            offset += pair.second;
+        }
+
+        m_tables.emplace(symbol.vaddr, table);
+        return table;
     }
 
     std::map<uint64_t, SymbolInfo>            m_symbol_map{};
     std::vector<std::shared_ptr<Instruction>> instructions{};
     std::unique_ptr<DisassemblyInstance>      disassembly{};
 
-    std::map<segment::address_range_t, std::string> m_line_number_map{};
+private:
+    static bool is_native_byte_order(const char* codeobj_data, uint64_t codeobj_size)
+    {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        constexpr char native_data = ELFDATA2LSB;
+#else
+        constexpr char native_data = ELFDATA2MSB;
+#endif
+        return codeobj_size > EI_DATA && codeobj_data[EI_DATA] == native_data;
+    }
+
+    // Returns the "file:line" of vaddr, nullptr if unknown. m_mutex must be held.
+    const std::string* get_source_line(uint64_t vaddr)
+    {
+        if(!m_dwarf) return nullptr;
+
+        Dwarf_Die cu_die;
+        if(dwarf_addrdie(m_dwarf.get(), vaddr, &cu_die))
+            load_cu_lines(&cu_die);
+        else
+            load_all_lines();  // no address ranges for vaddr
+
+        auto it = m_lines.upper_bound(vaddr);
+        if(it == m_lines.begin()) return nullptr;
+
+        uint64_t end = (it != m_lines.end()) ? it->first : m_code_size;
+        --it;
+        return (vaddr < end) ? it->second : nullptr;
+    }
+
+    void load_all_lines()
+    {
+        if(m_all_lines_loaded) return;
+        m_all_lines_loaded = true;
+
+        Dwarf_Off cu_offset{0}, next_offset;
+        size_t    header_size;
+
+        while(!dwarf_nextcu(
+            m_dwarf.get(), cu_offset, &next_offset, &header_size, nullptr, nullptr, nullptr))
+        {
+            Dwarf_Die die;
+            if(dwarf_offdie(m_dwarf.get(), cu_offset + header_size, &die)) load_cu_lines(&die);
+            cu_offset = next_offset;
+        }
+    }
+
+    void load_cu_lines(Dwarf_Die* cu_die)
+    {
+        if(!m_loaded_cus.emplace(dwarf_dieoffset(cu_die)).second) return;
+
+        Dwarf_Lines* lines;
+        size_t       line_count;
+        if(dwarf_getsrclines(cu_die, &lines, &line_count)) return;
+
+        std::map<uint64_t, std::string> line_addrs;
+        for(size_t i = 0; i < line_count; ++i)
+        {
+            Dwarf_Addr  addr;
+            int         line_number;
+            Dwarf_Line* line = dwarf_onesrcline(lines, i);
+
+            if(line && !dwarf_lineaddr(line, &addr) && !dwarf_lineno(line, &line_number) &&
+               line_number)
+            {
+                std::string src        = dwarf_linesrc(line, nullptr, nullptr);
+                auto        dwarf_line = src + ':' + std::to_string(line_number);
+
+                if(line_addrs.find(addr) != line_addrs.end())
+                {
+                    line_addrs.at(addr) += ' ' + dwarf_line;
+                    continue;
+                }
+
+                line_addrs.emplace(addr, std::move(dwarf_line));
+            }
+        }
+
+        for(auto& [addr, dwarf_line] : line_addrs)
+        {
+            auto [it, inserted] = m_lines.emplace(addr, nullptr);
+            it->second = intern(inserted ? std::move(dwarf_line) : *it->second + ' ' + dwarf_line);
+        }
+    }
+
+    const std::string* intern(std::string&& str)
+    {
+        return &*m_strings.emplace(std::move(str)).first;
+    }
+
+    uint64_t                                  m_code_size{0};
+    elf_ptr_t                                 m_elf{nullptr, elf_end};
+    dwarf_ptr_t                               m_dwarf{nullptr, dwarf_end};
+    std::mutex                                m_mutex{};
+    bool                                      m_all_lines_loaded{false};
+    std::unordered_set<Dwarf_Off>             m_loaded_cus{};
+    std::unordered_set<std::string>           m_strings{};
+    std::map<uint64_t, const std::string*>    m_lines{};
+    std::unordered_map<uint64_t, Instruction> m_inst_cache{};  // keyed by vaddr
+    std::unordered_map<uint64_t, table_ptr_t> m_tables{};
 };
 
 class LoadedCodeobjDecoder
@@ -205,23 +464,14 @@ public:
 
         if(fpath.rfind(".out") + 4 == fpath.size())
         {
-            std::ifstream file(filepath, std::ios::in | std::ios::binary);
-
-            if(!file.is_open()) throw std::runtime_error("Invalid file " + std::string(filepath));
-
-            std::vector<char> buffer;
-            file.seekg(0, file.end);
-            buffer.resize(file.tellg());
-            file.seekg(0, file.beg);
-            file.read(buffer.data(), buffer.size());
-
-            decoder = std::make_unique<CodeobjDecoderComponent>(buffer.data(), buffer.size());
+            auto file = MappedFile::get(std::string{fpath});
+            decoder   = std::make_unique<CodeobjDecoderComponent>(file->data(), file->size(), file);
         }
         else
         {
-            std::unique_ptr<CodeObjectBinary> binary = std::make_unique<CodeObjectBinary>(filepath);
-            auto&                             buffer = binary->buffer;
-            decoder = std::make_unique<CodeobjDecoderComponent>(buffer.data(), buffer.size());
+            auto binary = CodeObjectBinary{filepath};
+            decoder     = std::make_unique<CodeobjDecoderComponent>(
+                binary.data(), binary.size(), binary.file());
         }
     }
     LoadedCodeobjDecoder(const void* data, uint64_t size, uint64_t _load_addr, size_t _memsize)
@@ -265,6 +515,24 @@ public:
         if(!decoder) throw std::exception();
         return decoder->m_symbol_map;
     }
+
+    /**
+     * @brief Decodes the kernel symbol containing ld_addr. Addresses in the table are relative to
+     * the code object: look up ld_addr - load_addr. Returns nullptr if no symbol contains ld_addr.
+     */
+    std::shared_ptr<const InstructionTable> getInstructionTable(uint64_t ld_addr) const
+    {
+        if(!decoder || !inrange(ld_addr)) return nullptr;
+
+        uint64_t voffset = ld_addr - load_addr;
+        auto&    symbols = decoder->m_symbol_map;
+        auto     it      = symbols.upper_bound(voffset);
+        if(it == symbols.begin()) return nullptr;
+
+        --it;
+        if(voffset >= it->first + it->second.mem_size) return nullptr;
+        return decoder->disassemble_symbol(it->second);
+    }
     const uint64_t load_addr;
 
 private:
@@ -315,6 +583,17 @@ public:
         return nullptr;
     }
 
+    /**
+     * @brief Decodes the kernel symbol containing offset of code object id.
+     * Returns nullptr if there is no such code object or symbol.
+     */
+    std::shared_ptr<const InstructionTable> getInstructionTable(marker_id_t id, uint64_t offset)
+    {
+        auto it = decoders.find(id);
+        if(it == decoders.end()) return nullptr;
+        return it->second->getInstructionTable(it->second->begin() + offset);
+    }
+
     const char* getSymbolName(marker_id_t id, uint64_t offset)
     {
         try
@@ -382,6 +661,25 @@ public:
             return this->Super::get(id, offset);
     }
 
+    /**
+     * @brief Decodes the kernel symbol loaded at vaddr. Addresses in the table are relative to the
+     * code object. Returns nullptr if no loaded symbol contains vaddr.
+     */
+    std::shared_ptr<const InstructionTable> getInstructionTable(uint64_t vaddr)
+    {
+        auto it = table.find(segment::address_range_t{vaddr, 0, 0});
+        if(it == table.end()) return nullptr;
+        return this->Super::getInstructionTable(it->id, vaddr - it->addr);
+    }
+
+    std::shared_ptr<const InstructionTable> getInstructionTable(marker_id_t id, uint64_t offset)
+    {
+        if(id == 0)
+            return getInstructionTable(offset);
+        else
+            return this->Super::getInstructionTable(id, offset);
+    }
+
     const char* getSymbolName(uint64_t vaddr)
     {
         for(auto& [_, decoder] : decoders)
@@ -36,8 +36,10 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -76,6 +78,91 @@ namespace codeobj
 {
 namespace disassembly
 {
+/**
+ * @brief Read-only mapping of a whole file. Mappings are shared by all the code objects
+ * referencing the same file, e.g. the code objects embedded in a fat binary. A file is identified
+ * by its device, inode, size and modification time, hence a file replaced or rewritten under the
+ * same path is mapped again instead of reusing a stale mapping.
+ */
+class MappedFile
+{
+public:
+    static std::shared_ptr<MappedFile> get(const std::string& path)
+    {
+        using key_t = std::tuple<dev_t, ino_t, off_t, time_t, long>;
+
+        static auto* _mutex = new std::mutex{};
+        static auto* _files = new std::map<key_t, std::weak_ptr<MappedFile>>{};
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd == -1) throw std::runtime_error("could not open " + path);
+
+        struct stat file_stat = {};
+        if(::fstat(fd, &file_stat) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("could not stat " + path);
+        }
+
+        auto key = key_t{file_stat.st_dev,
+                         file_stat.st_ino,
+                         file_stat.st_size,
+                         file_stat.st_mtim.tv_sec,
+                         file_stat.st_mtim.tv_nsec};
+
+        std::lock_guard<std::mutex> lk(*_mutex);
+
+        auto& entry = (*_files)[key];
+        auto  file  = entry.lock();
+        if(!file)
+        {
+            try
+            {
+                file = std::shared_ptr<MappedFile>(
+                    new MappedFile(path, fd, static_cast<size_t>(file_stat.st_size)));
+            } catch(...)
+            {
+                _files->erase(key);
+                ::close(fd);
+                throw;
+            }
+            entry = file;
+
+            // Forget the files which are no longer mapped
+            for(auto itr = _files->begin(); itr != _files->end();)
+                itr = (itr->second.expired()) ? _files->erase(itr) : std::next(itr);
+        }
+        ::close(fd);
+        return file;
+    }
+
+    ~MappedFile()
+    {
+        if(m_data != MAP_FAILED) ::munmap(m_data, m_size);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const
+    {
+        return (m_data != MAP_FAILED) ? static_cast<const char*>(m_data) : nullptr;
+    }
+    size_t size() const { return m_size; }
+
+private:
+    MappedFile(const std::string& path, int fd, size_t size)
+    : m_size(size)
+    {
+        if(m_size > 0) m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if(m_size > 0 && m_data == MAP_FAILED) throw std::runtime_error("could not map " + path);
+    }
+
+    void*  m_data = MAP_FAILED;
+    size_t m_size = 0;
+};
+
 class CodeObjectBinary
 {
 public:
@@ -142,7 +229,6 @@ public:
             }
         });
 
-        buffer        = std::vector<char>{};
         size_t offset = 0;
         size_t size   = 0;
 
@@ -158,27 +244,26 @@ public:
 
         if(protocol == "memory") throw std::runtime_error(protocol + " protocol not supported!");
 
-        std::ifstream file(decoded_path, std::ios::in | std::ios::binary);
-        if(!file || !file.is_open()) throw std::runtime_error("could not open " + decoded_path);
+        m_file = MappedFile::get(decoded_path);
 
-        if(!size)
-        {
-            file.ignore(std::numeric_limits<std::streamsize>::max());
-            size_t bytes = file.gcount();
-            file.clear();
+        if(offset > m_file->size()) throw std::runtime_error("invalid uri " + decoded_path);
+        if(!size) size = m_file->size() - offset;
+        if(size > m_file->size() - offset) throw std::runtime_error("invalid uri " + decoded_path);
 
-            if(bytes < offset) throw std::runtime_error("invalid uri " + decoded_path);
+        m_data = m_file->data() + offset;
+        m_size = size;
+    }
 
-            size = bytes - offset;
-        }
+    const char*                 data() const { return m_data; }
+    size_t                      size() const { return m_size; }
+    std::shared_ptr<MappedFile> file() const { return m_file; }
 
-        file.seekg(offset, std::ios_base::beg);
-        buffer.resize(size);
-        file.read(&buffer[0], size);
-    }
+    std::string m_uri;
 
-    std::string       m_uri;
-    std::vector<char> buffer;
+private:
+    std::shared_ptr<MappedFile> m_file{nullptr};
+    const char*                 m_data = nullptr;
+    size_t                      m_size = 0;
 };
 
 struct SymbolInfo
@@ -193,12 +278,32 @@ class DisassemblyInstance
 {
 public:
     DisassemblyInstance(const char* codeobj_data, uint64_t codeobj_size)
+    : DisassemblyInstance(codeobj_data, codeobj_size, nullptr)
+    {}
+
+    /**
+     * @brief If file is given, codeobj_data points into the file mapping and is used in place.
+     * Otherwise, the code object is copied.
+     */
+    DisassemblyInstance(const char*                 codeobj_data,
+                        uint64_t                    codeobj_size,
+                        std::shared_ptr<MappedFile> file)
+    : mapped_file(std::move(file))
     {
-        buffer = std::vector<char>(codeobj_size, 0);
-        std::memcpy(buffer.data(), codeobj_data, codeobj_size);
+        if(mapped_file)
+        {
+            m_data = codeobj_data;
+        }
+        else
+        {
+            buffer = std::vector<char>(codeobj_size, 0);
+            std::memcpy(buffer.data(), codeobj_data, codeobj_size);
+            m_data = buffer.data();
+        }
+        m_size = codeobj_size;
 
         THROW_COMGR(amd_comgr_create_data(AMD_COMGR_DATA_KIND_EXECUTABLE, &data));
-        THROW_COMGR(amd_comgr_set_data(data, buffer.size(), buffer.data()));
+        THROW_COMGR(amd_comgr_set_data(data, m_size, m_data));
 
         size_t      isa_size = 128;
         std::string input_isa{};
@@ -221,7 +326,7 @@ public:
     std::pair<std::string, size_t> ReadInstruction(uint64_t faddr)
     {
         uint64_t size_read;
-        uint64_t addr_in_buffer = reinterpret_cast<uint64_t>(buffer.data()) + faddr;
+        uint64_t addr_in_buffer = reinterpret_cast<uint64_t>(m_data) + faddr;
 
         THROW_COMGR(
             amd_comgr_disassemble_instruction(info, addr_in_buffer, (void*) this, &size_read));
@@ -266,8 +371,8 @@ public:
     static uint64_t memory_callback(uint64_t from, char* to, uint64_t size, void* user_data)
     {
         DisassemblyInstance& instance = *static_cast<DisassemblyInstance*>(user_data);
-        int64_t              copysize = reinterpret_cast<int64_t>(instance.buffer.data()) +
-                           instance.buffer.size() - static_cast<int64_t>(from);
+        int64_t              copysize = reinterpret_cast<int64_t>(instance.m_data) +
+                           instance.m_size - static_cast<int64_t>(from);
         copysize = std::min<int64_t>(size, copysize);
         std::memcpy(to, (char*) from, copysize);
         return copysize;
@@ -286,9 +391,9 @@ public:
 
     std::optional<uint64_t> va2fo(uint64_t va)
     {
-        CHECK_VA2FO(buffer.size() > sizeof(Elf64_Ehdr), "buffer is not large enough");
+        CHECK_VA2FO(m_size > sizeof(Elf64_Ehdr), "buffer is not large enough");
 
-        uint8_t* e_ident = (uint8_t*) buffer.data();
+        const uint8_t* e_ident = (const uint8_t*) m_data;
         CHECK_VA2FO(e_ident, "e_ident is nullptr");
 
         CHECK_VA2FO(e_ident[EI_MAG0] == ELFMAG0 || e_ident[EI_MAG1] == ELFMAG1 ||
@@ -304,16 +409,15 @@ public:
                         e_ident[EI_ABIVERSION] == 3,
                     "unexpected ei_abiversion");  // ELFABIVERSION_AMDGPU_HSA_V5
 
-        Elf64_Ehdr* ehdr = (Elf64_Ehdr*) buffer.data();
+        const Elf64_Ehdr* ehdr = (const Elf64_Ehdr*) m_data;
         CHECK_VA2FO(ehdr, "ehdr is nullptr");
         CHECK_VA2FO(ehdr->e_type == ET_DYN, "unexpected e_type");
         CHECK_VA2FO(ehdr->e_machine == ELF::EM_AMDGPU, "unexpected e_machine");
         CHECK_VA2FO(ehdr->e_phoff != 0, "unexpected e_phoff");
 
-        CHECK_VA2FO(buffer.size() > ehdr->e_phoff + sizeof(Elf64_Phdr),
-                    "buffer is not large enough");
+        CHECK_VA2FO(m_size > ehdr->e_phoff + sizeof(Elf64_Phdr), "buffer is not large enough");
 
-        Elf64_Phdr* phdr = (Elf64_Phdr*) ((uint8_t*) buffer.data() + ehdr->e_phoff);
+        const Elf64_Phdr* phdr = (const Elf64_Phdr*) ((const uint8_t*) m_data + ehdr->e_phoff);
         CHECK_VA2FO(phdr, "phdr is nullptr");
 
         for(uint16_t i = 0; i < ehdr->e_phnum; ++i)
@@ -326,11 +430,19 @@ public:
         return std::nullopt;
     }
 
+    const char* code_data() const { return m_data; }
+    uint64_t    code_size() const { return m_size; }
+
     std::vector<char>              buffer;
+    std::shared_ptr<MappedFile>    mapped_file;
     std::string                    last_instruction;
     amd_comgr_disassembly_info_t   info;
     amd_comgr_data_t               data;
     std::map<uint64_t, SymbolInfo> symbol_map;
+
+private:
+    const char* m_data = nullptr;
+    uint64_t    m_size = 0;
 };
 
 }  // namespace disassembly
@@ -22,11 +22,14 @@
 
 #pragma once
 #include <algorithm>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
 #include <random>
 #include <set>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace rocprofiler
@@ -59,34 +62,246 @@ struct address_range_t
 };
 
 /**
- * @brief Finds a candidate codeobj for the given vaddr
+ * @brief Finds a candidate codeobj for the given vaddr.
+ * Ranges are kept in a sorted array. Single lookups search a copy of the start addresses in
+ * Eytzinger (BFS) order, which is rebuilt on the first lookup after a modification.
+ * Overlapping ranges are not inserted.
+ * The class used to derive from std::set<address_range_t>: the read and modify members of the
+ * set are kept with the same semantics, and it converts to a std::set copy.
  */
-class CodeobjTableTranslator : public std::set<address_range_t>
+class CodeobjTableTranslator
 {
-    using Super = std::set<address_range_t>;
+    using container_t = std::vector<address_range_t>;
 
 public:
+    using key_type               = address_range_t;
+    using value_type             = address_range_t;
+    using size_type              = container_t::size_type;
+    using difference_type        = container_t::difference_type;
+    using key_compare            = std::less<address_range_t>;
+    using value_compare          = std::less<address_range_t>;
+    using reference              = const address_range_t&;
+    using const_reference        = const address_range_t&;
+    using const_iterator         = container_t::const_iterator;
+    using iterator               = const_iterator;
+    using const_reverse_iterator = container_t::const_reverse_iterator;
+    using reverse_iterator       = const_reverse_iterator;
+
+    CodeobjTableTranslator() = default;
+    CodeobjTableTranslator(std::initializer_list<address_range_t> ranges)
+    {
+        for(const auto& itr : ranges)
+            insert(itr);
+    }
+
+    operator std::set<address_range_t>() const { return {m_ranges.begin(), m_ranges.end()}; }
+
+    const_iterator         begin() const { return m_ranges.begin(); }
+    const_iterator         end() const { return m_ranges.end(); }
+    const_iterator         cbegin() const { return m_ranges.cbegin(); }
+    const_iterator         cend() const { return m_ranges.cend(); }
+    const_reverse_iterator rbegin() const { return m_ranges.rbegin(); }
+    const_reverse_iterator rend() const { return m_ranges.rend(); }
+    const_reverse_iterator crbegin() const { return m_ranges.crbegin(); }
+    const_reverse_iterator crend() const { return m_ranges.crend(); }
+    size_type              size() const { return m_ranges.size(); }
+    size_type              max_size() const { return m_ranges.max_size(); }
+    bool                   empty() const { return m_ranges.empty(); }
+    key_compare            key_comp() const { return {}; }
+    value_compare          value_comp() const { return {}; }
+
+    std::pair<const_iterator, bool> insert(const address_range_t& range)
+    {
+        auto it = upper_bound(range.addr);
+        if(it != m_ranges.begin() && *std::prev(it) == range) return {std::prev(it), false};
+        if(it != m_ranges.end() && *it == range) return {it, false};
+
+        invalidate();
+        return {m_ranges.insert(it, range), true};
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        for(; first != last; ++first)
+            insert(*first);
+    }
+
+    void insert(std::initializer_list<address_range_t> ranges)
+    {
+        insert(ranges.begin(), ranges.end());
+    }
+
+    const_iterator insert(const_iterator /* hint */, const address_range_t& range)
+    {
+        return insert(range).first;
+    }
+
+    template <typename... Args>
+    std::pair<const_iterator, bool> emplace(Args&&... args)
+    {
+        return insert(address_range_t{std::forward<Args>(args)...});
+    }
+
+    /// @brief Returns the range overlapping with range, end() if there is none
+    const_iterator find(const address_range_t& range) const
+    {
+        auto it = upper_bound(range.addr);
+        if(it != m_ranges.begin() && *std::prev(it) == range) return std::prev(it);
+        if(it != m_ranges.end() && *it == range) return it;
+        return m_ranges.end();
+    }
+
+    size_type count(const address_range_t& range) const { return (find(range) != end()) ? 1 : 0; }
+    bool      contains(const address_range_t& range) const { return find(range) != end(); }
+
+    /// @brief First range not ordered before range, i.e. overlapping with it or after it
+    const_iterator lower_bound(const address_range_t& range) const
+    {
+        return std::lower_bound(m_ranges.begin(), m_ranges.end(), range);
+    }
+
+    /// @brief First range ordered after range
+    const_iterator upper_bound(const address_range_t& range) const
+    {
+        return std::upper_bound(m_ranges.begin(), m_ranges.end(), range);
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const address_range_t& range) const
+    {
+        return {lower_bound(range), upper_bound(range)};
+    }
+
+    size_type erase(const address_range_t& range) { return remove(range) ? 1 : 0; }
+
+    const_iterator erase(const_iterator pos)
+    {
+        clear_cache();
+        invalidate();
+        return m_ranges.erase(pos);
+    }
+
+    const_iterator erase(const_iterator first, const_iterator last)
+    {
+        clear_cache();
+        invalidate();
+        return m_ranges.erase(first, last);
+    }
+
+    void swap(CodeobjTableTranslator& other) noexcept
+    {
+        clear_cache();
+        other.clear_cache();
+        invalidate();
+        other.invalidate();
+        m_ranges.swap(other.m_ranges);
+    }
+
     address_range_t find_codeobj_in_range(uint64_t addr)
     {
         if(!cached_segment.inrange(addr))
         {
-            auto it = this->find(address_range_t{addr, 0, 0});
-            if(it == this->end()) throw std::exception();
-            cached_segment = *it;
+            auto idx = find_index(addr);
+            if(idx >= m_ranges.size() || !m_ranges[idx].inrange(addr)) throw std::exception();
+            cached_segment = m_ranges[idx];
         }
         return cached_segment;
     }
 
+    /**
+     * @brief Resolves sorted_addrs, which must be sorted in ascending order, in a single merge
+     * pass over the ranges. For each address, writes the range containing it to the matching
+     * index of result, or a range with size 0 if there is none.
+     */
+    void find_codeobj_in_range(const std::vector<uint64_t>&  sorted_addrs,
+                               std::vector<address_range_t>& result) const
+    {
+        result.assign(sorted_addrs.size(), address_range_t{});
+
+        auto it = m_ranges.begin();
+        for(size_t i = 0; i < sorted_addrs.size(); i++)
+        {
+            uint64_t addr = sorted_addrs[i];
+            while(it != m_ranges.end() && it->addr + it->size <= addr)
+                ++it;
+            if(it == m_ranges.end()) break;
+            if(it->inrange(addr)) result[i] = *it;
+        }
+    }
+
     void clear_cache() { cached_segment = {}; }
     bool remove(const address_range_t& range)
     {
         clear_cache();
-        return this->erase(range) != 0;
+
+        auto it = find(range);
+        if(it == m_ranges.end()) return false;
+
+        invalidate();
+        m_ranges.erase(it);
+        return true;
     }
     bool remove(uint64_t addr) { return remove(address_range_t{addr, 0, 0}); }
+    void clear()
+    {
+        clear_cache();
+        invalidate();
+        m_ranges.clear();
+    }
 
 private:
-    address_range_t cached_segment{};
+    struct eytzinger_node_t
+    {
+        uint64_t addr{0};
+        size_t   index{0};  // Index in m_ranges
+    };
+
+    const_iterator upper_bound(uint64_t addr) const
+    {
+        return std::upper_bound(
+            m_ranges.begin(), m_ranges.end(), addr, [](uint64_t _addr, const address_range_t& r) {
+                return _addr < r.addr;
+            });
+    }
+
+    void invalidate() { m_eytzinger.clear(); }
+
+    // In-order traversal of the implicit tree (node k has children 2k and 2k+1) assigns the
+    // sorted ranges to their Eytzinger positions
+    size_t build(size_t idx, size_t node)
+    {
+        if(node > m_ranges.size()) return idx;
+        idx               = build(idx, 2 * node);
+        m_eytzinger[node] = {m_ranges[idx].addr, idx};
+        return build(idx + 1, 2 * node + 1);
+    }
+
+    // Returns the index of the last range starting at or before addr, size() if there is none
+    size_t find_index(uint64_t addr)
+    {
+        if(m_ranges.empty()) return m_ranges.size();
+
+        if(m_eytzinger.empty())
+        {
+            m_eytzinger.resize(m_ranges.size() + 1);
+            build(0, 1);
+        }
+
+        // Descend to the first start address greater than addr. The node is recovered from the
+        // path by dropping the trailing right turns and the last left turn.
+        size_t node = 1;
+        while(node < m_eytzinger.size())
+            node = 2 * node + (m_eytzinger[node].addr <= addr);
+        node >>= __builtin_ffsll(static_cast<long long>(~node));
+
+        if(node == 0) return m_ranges.size() - 1;  // every range starts at or before addr
+        size_t upper = m_eytzinger[node].index;
+        return (upper > 0) ? upper - 1 : m_ranges.size();
+    }
+
+    container_t                   m_ranges{};
+    std::vector<eytzinger_node_t> m_eytzinger{};  // 1-based, empty when out of date
+    address_range_t               cached_segment{};
 };
 
 }  // namespace segment
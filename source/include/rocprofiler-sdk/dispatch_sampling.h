@@ -0,0 +1,99 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <rocprofiler-sdk/defines.h>
+#include <rocprofiler-sdk/fwd.h>
+
+ROCPROFILER_EXTERN_C_INIT
+
+/**
+ * @defgroup DISPATCH_SAMPLING Dispatch Sampling Policy
+ * @brief Selects which kernel dispatches are instrumented without invoking the tool
+ *
+ * The policy is evaluated by rocprofiler when a kernel is enqueued, before the dispatch callback
+ * of the dispatch counting and dispatch thread trace services. Dispatches rejected by the policy
+ * are not instrumented and the dispatch callback is not invoked for them.
+ *
+ * @{
+ */
+
+/**
+ * @brief Dispatch sampling policy types
+ */
+typedef enum rocprofiler_dispatch_sampling_policy_type_t
+{
+    ROCPROFILER_DISPATCH_SAMPLING_POLICY_NONE = 0,    ///< Every dispatch is instrumented
+    ROCPROFILER_DISPATCH_SAMPLING_POLICY_EVERY_NTH,   ///< Every Nth dispatch of each kernel
+    ROCPROFILER_DISPATCH_SAMPLING_POLICY_FIRST_N,     ///< First N dispatches of each kernel
+    ROCPROFILER_DISPATCH_SAMPLING_POLICY_DUTY_CYCLE,  ///< Active part of each time period
+    ROCPROFILER_DISPATCH_SAMPLING_POLICY_RANDOM,      ///< Each dispatch with a given probability
+    ROCPROFILER_DISPATCH_SAMPLING_POLICY_LAST,
+} rocprofiler_dispatch_sampling_policy_type_t;
+
+/**
+ * @brief Dispatch sampling policy configuration
+ */
+typedef struct rocprofiler_dispatch_sampling_policy_t
+{
+    /// Size of this struct
+    uint64_t size;
+    /// Policy type
+    rocprofiler_dispatch_sampling_policy_type_t type;
+    /// N of ::ROCPROFILER_DISPATCH_SAMPLING_POLICY_EVERY_NTH and
+    /// ::ROCPROFILER_DISPATCH_SAMPLING_POLICY_FIRST_N
+    uint64_t count;
+    /// Period in nanoseconds of ::ROCPROFILER_DISPATCH_SAMPLING_POLICY_DUTY_CYCLE
+    uint64_t period_ns;
+    /// Active part of each period in nanoseconds. Periods start when the policy is configured
+    uint64_t active_ns;
+    /// Probability of ::ROCPROFILER_DISPATCH_SAMPLING_POLICY_RANDOM, in [0, 1]
+    double probability;
+    /// Seed of ::ROCPROFILER_DISPATCH_SAMPLING_POLICY_RANDOM
+    uint64_t seed;
+} rocprofiler_dispatch_sampling_policy_t;
+
+/**
+ * @brief Configure the dispatch sampling policy of a context. The policy applies to the dispatch
+ * counting service and the dispatch thread trace service of the context. The policy is evaluated
+ * once per dispatch: when both services are configured, a dispatch is either instrumented by both
+ * or by neither. The random policy produces the same sequence of decisions for the same seed and
+ * order of dispatches.
+ *
+ * @param [in] context_id Context to configure
+ * @param [in] policy Policy configuration
+ * @retval ::ROCPROFILER_STATUS_SUCCESS Policy configured
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED Called outside of tool initialization
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONTEXT_NOT_FOUND Invalid context id
+ * @retval ::ROCPROFILER_STATUS_ERROR_SERVICE_ALREADY_CONFIGURED Policy already configured
+ * @retval ::ROCPROFILER_STATUS_ERROR_INCOMPATIBLE_ABI policy.size is not set
+ * @retval ::ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT Invalid policy type or parameters
+ */
+rocprofiler_status_t
+rocprofiler_configure_dispatch_sampling_policy(rocprofiler_context_id_t               context_id,
+                                               rocprofiler_dispatch_sampling_policy_t policy)
+    ROCPROFILER_API;
+
+/** @} */
+
+ROCPROFILER_EXTERN_C_FINI
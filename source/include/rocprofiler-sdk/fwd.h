@@ -304,6 +304,18 @@ typedef enum  // NOLINT(performance-enum-size)
     ROCPROFILER_PC_SAMPLING_UNIT_LAST,
 } rocprofiler_pc_sampling_unit_t;
 
+/**
+ * @brief PC Sampling Output Mode. Selects how the samples are delivered to the buffer.
+ */
+typedef enum  // NOLINT(performance-enum-size)
+{
+    ROCPROFILER_PC_SAMPLING_OUTPUT_MODE_RECORDS = 0,  ///< One record per sample (default)
+    ROCPROFILER_PC_SAMPLING_OUTPUT_MODE_HISTOGRAM,    ///< Sample count per code object offset
+    ROCPROFILER_PC_SAMPLING_OUTPUT_MODE_HISTOGRAM_PER_DISPATCH,  ///< Sample count per code object
+                                                                 ///< offset and dispatch
+    ROCPROFILER_PC_SAMPLING_OUTPUT_MODE_LAST,
+} rocprofiler_pc_sampling_output_mode_t;
+
 /**
  * @brief Actions when Buffer is full.
  */
@@ -414,6 +426,7 @@ typedef enum
     ROCPROFILER_PC_SAMPLING_RECORD_SAMPLE,                   ///< ::rocprofiler_pc_sampling_record_t
     ROCPROFILER_PC_SAMPLING_RECORD_CODE_OBJECT_LOAD_MARKER,  ///< ::rocprofiler_pc_sampling_code_object_load_marker_t
     ROCPROFILER_PC_SAMPLING_RECORD_CODE_OBJECT_UNLOAD_MARKER,  ///< ::rocprofiler_pc_sampling_code_object_unload_marker_t
+    ROCPROFILER_PC_SAMPLING_RECORD_HISTOGRAM,  ///< ::rocprofiler_pc_sampling_histogram_record_t
     ROCPROFILER_PC_SAMPLING_RECORD_LAST,
 } rocprofiler_pc_sampling_record_kind_t;
 
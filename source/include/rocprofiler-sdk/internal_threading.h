@@ -106,6 +106,55 @@ rocprofiler_status_t
 rocprofiler_create_callback_thread(rocprofiler_callback_thread_t* cb_thread_id) ROCPROFILER_API
     ROCPROFILER_NONNULL(1);
 
+/**
+ * @brief Scheduling properties of a callback thread, see
+ * ::rocprofiler_create_callback_thread_with_properties
+ *
+ * The properties are applied by the callback thread itself when it starts. Failing to apply them,
+ * e.g. due to insufficient privileges for a negative priority, is reported as a warning and does
+ * not prevent the thread from delivering buffer callbacks.
+ *
+ * The properties only apply to the thread created with them. The other threads created by
+ * rocprofiler-sdk keep the affinity and priority they inherit from the thread which creates them:
+ * the default callback thread, the buffer flush timer thread, the thread completing asynchronous
+ * memory copies, the page migration reporting thread, the PC sampling parser workers and the
+ * thread trace decoder threads. See ::rocprofiler_at_internal_thread_create.
+ */
+typedef struct rocprofiler_callback_thread_properties_t
+{
+    /// Size of this struct
+    uint64_t size;
+    /// Array of CPU indices the thread is allowed to run on. When NULL, the thread inherits the
+    /// CPU affinity of the thread which creates it.
+    const uint32_t* cpu_affinity;
+    /// Number of entries in @ref cpu_affinity
+    uint64_t cpu_affinity_count;
+    /// Nice value of the thread in the range [-20, 19]. Zero leaves the inherited priority
+    /// unchanged
+    int32_t priority;
+} rocprofiler_callback_thread_properties_t;
+
+/**
+ * @brief Create a callback thread (see ::rocprofiler_create_callback_thread) which is pinned to a
+ * set of CPUs and/or runs with a different priority, e.g. to isolate the processing of buffers from
+ * the cores used by the application.
+ *
+ * @param [in] properties Scheduling properties of the thread
+ * @param [in] cb_thread_id User-provided pointer to a @ref rocprofiler_callback_thread_t
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_SUCCESS Successful thread creation
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED Thread creation is no longer available
+ * post-initialization
+ * @retval ::ROCPROFILER_STATUS_ERROR_INCOMPATIBLE_ABI properties.size is not set
+ * @retval ::ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT The CPU affinity is NULL with a non-zero
+ * count, contains a CPU index which does not exist, or the priority is out of range
+ * @retval ::ROCPROFILER_STATUS_ERROR Failed to create thread
+ */
+rocprofiler_status_t
+rocprofiler_create_callback_thread_with_properties(
+    rocprofiler_callback_thread_properties_t properties,
+    rocprofiler_callback_thread_t*           cb_thread_id) ROCPROFILER_API ROCPROFILER_NONNULL(2);
+
 /**
  * @brief By default, all buffered results are delivered on the same thread. Using @ref
  * rocprofiler_create_callback_thread, one or more buffers can be assigned to deliever their results
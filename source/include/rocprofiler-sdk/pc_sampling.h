@@ -119,6 +119,37 @@ rocprofiler_configure_pc_sampling_service(rocprofiler_context_id_t         conte
                                           uint64_t                         interval,
                                           rocprofiler_buffer_id_t buffer_id) ROCPROFILER_API;
 
+/**
+ * @brief Function used to select how the PC samples of the agent with @p agent_id are delivered.
+ *
+ * By default (::ROCPROFILER_PC_SAMPLING_OUTPUT_MODE_RECORDS), every sample is delivered
+ * as a ::rocprofiler_pc_sampling_record_t. When only hot-spots are of interest, the histogram
+ * modes aggregate the samples internally and deliver one
+ * ::rocprofiler_pc_sampling_histogram_record_t per sampled instruction (and dispatch, for
+ * ::ROCPROFILER_PC_SAMPLING_OUTPUT_MODE_HISTOGRAM_PER_DISPATCH) whenever the PC sampling
+ * buffers are flushed: upon @see rocprofiler_flush_buffer, before code object unload markers
+ * and when the service is stopped.
+ *
+ * Must be called after @see rocprofiler_configure_pc_sampling_service for the same
+ * @p context_id and @p agent_id.
+ *
+ * @param [in] context_id - id of the context containing the PC sampling service
+ * @param [in] agent_id   - id of the agent on which the PC sampling service is configured
+ * @param [in] mode       - the output mode
+ * @return ::rocprofiler_status_t
+ * @retval ::ROCPROFILER_STATUS_SUCCESS output mode selected successfully
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED function called outside of the tool
+ * initialization
+ * @retval ::ROCPROFILER_STATUS_ERROR_CONTEXT_NOT_FOUND invalid @p context_id
+ * @retval ::ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT invalid @p mode, or the PC sampling service
+ * is not configured on @p agent_id within the context
+ */
+rocprofiler_status_t
+rocprofiler_configure_pc_sampling_output_mode(rocprofiler_context_id_t              context_id,
+                                              rocprofiler_agent_id_t                agent_id,
+                                              rocprofiler_pc_sampling_output_mode_t mode)
+    ROCPROFILER_API;
+
 /**
  * @brief PC sampling configuration supported by a GPU agent.
  */
@@ -278,6 +309,33 @@ typedef struct
     /// The interrupted wave is executed as part of the kernel.
 } rocprofiler_pc_sampling_record_t;
 
+/**
+ * @brief ROCProfiler PC Sampling Histogram Record. Number of samples which interrupted waves at
+ * the same instruction, delivered instead of ::rocprofiler_pc_sampling_record_t when the agent
+ * uses one of the histogram output modes.
+ *
+ * @see rocprofiler_configure_pc_sampling_output_mode
+ */
+typedef struct
+{
+    uint64_t                     size;            ///< Size of this struct
+    uint64_t                     code_object_id;  ///< code object containing the sampled PC
+    uint64_t                     code_object_offset;
+    rocprofiler_correlation_id_t correlation_id;
+    uint64_t                     count;  ///< number of samples aggregated in this record
+
+    /// @var code_object_id
+    /// @brief unique code object identifier, or zero if the sampled PC did not belong to
+    /// any code object loaded on the agent at the moment of the flush
+    /// @var code_object_offset
+    /// @brief address of the instruction within the code object, i.e., the PC minus the
+    /// load delta of the code object. Contains the raw PC if @ref code_object_id is zero.
+    /// @var correlation_id
+    /// @brief correlation id of the API call that initiated the kernel launch, when using
+    /// ::ROCPROFILER_PC_SAMPLING_OUTPUT_MODE_HISTOGRAM_PER_DISPATCH.
+    /// Otherwise, the internal correlation id is ::ROCPROFILER_CORRELATION_ID_INTERNAL_NONE.
+} rocprofiler_pc_sampling_histogram_record_t;
+
 /**
  * @brief Marker representing code object loading event.
  *
@@ -72,6 +72,7 @@ ROCPROFILER_EXTERN_C_FINI
 #include "rocprofiler-sdk/context.h"
 #include "rocprofiler-sdk/counters.h"
 #include "rocprofiler-sdk/dispatch_profile.h"
+#include "rocprofiler-sdk/dispatch_sampling.h"
 #include "rocprofiler-sdk/external_correlation.h"
 #include "rocprofiler-sdk/hip.h"
 #include "rocprofiler-sdk/hsa.h"
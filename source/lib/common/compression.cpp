@@ -0,0 +1,210 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/compression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace rocprofiler
+{
+namespace common
+{
+namespace compression
+{
+namespace
+{
+// sequences are encoded as:
+//
+//   token | [literal length bytes] | literals | offset (2 bytes) | [match length bytes]
+//
+// where the high nibble of the token is the number of literals and the low nibble is the match
+// length minus min_match. A nibble of 15 is followed by bytes which are added to it until a byte
+// is less than 255. The last sequence only has literals.
+constexpr size_t min_match     = 4;
+constexpr size_t last_literals = 5;   // the last bytes are always literals
+constexpr size_t match_limit   = 12;  // matches do not start within the last bytes
+constexpr size_t max_offset    = 65535;
+constexpr size_t hash_log      = 14;
+constexpr size_t nibble_max    = 15;
+
+uint32_t
+read32(const uint8_t* _p)
+{
+    auto _v = uint32_t{0};
+    ::memcpy(&_v, _p, sizeof(_v));
+    return _v;
+}
+
+uint32_t
+hash4(uint32_t _v)
+{
+    return (_v * 2654435761U) >> (32 - hash_log);
+}
+
+void
+write_length(std::vector<char>& _dst, size_t _len)
+{
+    for(; _len >= 255; _len -= 255)
+        _dst.emplace_back(static_cast<char>(255));
+    _dst.emplace_back(static_cast<char>(_len));
+}
+
+bool
+read_length(const uint8_t*& _src, const uint8_t* _end, size_t& _len)
+{
+    auto _v = uint8_t{255};
+    while(_v == 255)
+    {
+        if(_src >= _end) return false;
+        _v = *_src++;
+        _len += _v;
+    }
+    return true;
+}
+
+void
+write_sequence(std::vector<char>& _dst,
+               const uint8_t*     _literals,
+               size_t             _num_literals,
+               size_t             _offset,
+               size_t             _match_length)
+{
+    const bool _last = (_match_length == 0);
+    const auto _mlen = (_last) ? 0 : (_match_length - min_match);
+    const auto _token =
+        (std::min(_num_literals, nibble_max) << 4) | (_last ? 0 : std::min(_mlen, nibble_max));
+
+    _dst.emplace_back(static_cast<char>(_token));
+    if(_num_literals >= nibble_max) write_length(_dst, _num_literals - nibble_max);
+    _dst.insert(_dst.end(), _literals, _literals + _num_literals);
+
+    if(_last) return;
+
+    _dst.emplace_back(static_cast<char>(_offset & 0xff));
+    _dst.emplace_back(static_cast<char>((_offset >> 8) & 0xff));
+    if(_mlen >= nibble_max) write_length(_dst, _mlen - nibble_max);
+}
+}  // namespace
+
+size_t
+compress_bound(size_t size)
+{
+    return size + (size / 255) + 16;
+}
+
+void
+compress(const void* src, size_t size, std::vector<char>& dst)
+{
+    const auto* _src = static_cast<const uint8_t*>(src);
+
+    dst.reserve(dst.size() + compress_bound(size));
+
+    size_t _anchor = 0;
+    if(size > match_limit)
+    {
+        // positions of the last occurrence of each hashed 4-byte sequence
+        auto _table = std::array<uint32_t, (1 << hash_log)>{};
+
+        const size_t _search_end = size - match_limit;
+        const size_t _match_end  = size - last_literals;
+
+        size_t _pos = 0;
+        while(_pos < _search_end)
+        {
+            const auto _seq  = read32(_src + _pos);
+            auto&      _slot = _table.at(hash4(_seq));
+            const auto _cand = static_cast<size_t>(_slot);
+            _slot            = static_cast<uint32_t>(_pos);
+
+            if(_cand >= _pos || (_pos - _cand) > max_offset || read32(_src + _cand) != _seq)
+            {
+                // step faster through data which does not compress
+                _pos += 1 + ((_pos - _anchor) >> 6);
+                continue;
+            }
+
+            auto _len = min_match;
+            while(_pos + _len < _match_end && _src[_cand + _len] == _src[_pos + _len])
+                ++_len;
+
+            write_sequence(dst, _src + _anchor, _pos - _anchor, _pos - _cand, _len);
+            _pos += _len;
+            _anchor = _pos;
+        }
+    }
+
+    write_sequence(dst, _src + _anchor, size - _anchor, 0, 0);
+}
+
+bool
+decompress(const void* src, size_t src_size, void* dst, size_t size)
+{
+    const auto* _src = static_cast<const uint8_t*>(src);
+    const auto* _end = _src + src_size;
+    auto*       _out = static_cast<uint8_t*>(dst);
+    size_t      _pos = 0;
+
+    while(_src < _end)
+    {
+        const auto _token        = *_src++;
+        size_t     _num_literals = (_token >> 4);
+        if(_num_literals == nibble_max && !read_length(_src, _end, _num_literals)) return false;
+        if(_num_literals > static_cast<size_t>(_end - _src) || _num_literals > (size - _pos))
+            return false;
+
+        if(_num_literals > 0) ::memcpy(_out + _pos, _src, _num_literals);
+        _src += _num_literals;
+        _pos += _num_literals;
+
+        // the last sequence does not have a match
+        if(_src == _end) break;
+
+        if((_end - _src) < 2) return false;
+        const auto _offset = static_cast<size_t>(_src[0]) | (static_cast<size_t>(_src[1]) << 8);
+        _src += 2;
+        if(_offset == 0 || _offset > _pos) return false;
+
+        size_t _len = (_token & 0xf);
+        if(_len == nibble_max && !read_length(_src, _end, _len)) return false;
+        _len += min_match;
+        if(_len > (size - _pos)) return false;
+
+        if(_offset >= _len)
+        {
+            ::memcpy(_out + _pos, _out + _pos - _offset, _len);
+            _pos += _len;
+        }
+        else
+        {
+            // overlapping match, e.g. a run of a repeated byte
+            for(size_t i = 0; i < _len; ++i, ++_pos)
+                _out[_pos] = _out[_pos - _offset];
+        }
+    }
+
+    return (_pos == size);
+}
+}  // namespace compression
+}  // namespace common
+}  // namespace rocprofiler
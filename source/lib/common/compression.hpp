@@ -0,0 +1,54 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rocprofiler
+{
+namespace common
+{
+namespace compression
+{
+// A small LZ77 block codec in the spirit of LZ4: a greedy single-probe match finder with a 64 KiB
+// window. It trades compression ratio for speed and is intended for temporary files which are
+// written and read back by the same process, so the format is not compatible with any external
+// tool.
+
+// upper bound on the size of compressing size bytes
+size_t
+compress_bound(size_t size);
+
+// appends the compressed data to dst
+void
+compress(const void* src, size_t size, std::vector<char>& dst);
+
+// decompresses exactly size bytes into dst. Returns false if the data is corrupt or does not
+// decompress to exactly size bytes
+bool
+decompress(const void* src, size_t src_size, void* dst, size_t size);
+}  // namespace compression
+}  // namespace common
+}  // namespace rocprofiler
@@ -21,10 +21,12 @@
 // SOFTWARE.
 
 #include "lib/common/container/record_header_buffer.hpp"
+#include "lib/common/units.hpp"
 
 #include <rocprofiler-sdk/rocprofiler.h>
 #include <algorithm>
 #include <atomic>
+#include <cstdint>
 #include <new>
 
 namespace rocprofiler::common::container
@@ -68,16 +70,22 @@ record_header_buffer::operator=(record_header_buffer&& _rhs) noexcept
 }
 
 bool
-record_header_buffer::allocate(size_t num_bytes)
+record_header_buffer::allocate(size_t num_bytes, ring_buffer_options opts)
 {
     if(m_buffer.is_initialized()) return false;
 
     auto _lk = rhb_raii_lock{*this};
-    m_buffer.init(num_bytes);
+    m_buffer.init(num_bytes, opts);
+    // one header per requested byte rounded up to the page size: the capacity may be much larger
+    // after rounding up to the huge page size. emplace() treats the buffer as full once every
+    // header is used
+    auto _page_size = static_cast<size_t>(units::get_page_size());
+    auto _num       = ((num_bytes + _page_size - 1) / _page_size) * _page_size;
+
     rocprofiler_record_header_t record = {};
     record.hash                        = 0;
     record.payload                     = nullptr;
-    m_headers.resize(m_buffer.capacity(), record);
+    m_headers.resize(_num, record);
     return true;
 }
 
@@ -105,7 +113,6 @@ record_header_buffer::clear()
 
     auto _n = m_index.load(std::memory_order_acquire);
     {
-        auto _sz = m_buffer.capacity();
         if(!m_buffer.clear(std::nothrow_t{})) return 0;
         std::for_each(m_headers.begin(), m_headers.end(), [](auto& itr) {
             rocprofiler_record_header_t record = {};
@@ -113,10 +120,6 @@ record_header_buffer::clear()
             record.payload                     = nullptr;
             itr                                = record;
         });
-        rocprofiler_record_header_t record = {};
-        record.hash                        = 0;
-        record.payload                     = nullptr;
-        m_headers.resize(_sz, record);
         m_index.store(0, std::memory_order_release);
     }
 
@@ -138,16 +141,30 @@ record_header_buffer::reset()
 }
 
 void
-record_header_buffer::save(std::fstream& _fs)
+record_header_buffer::save(std::fstream& _fs, bool _compress)
 {
     auto _lk = rhb_raii_lock{*this};
 
     auto _idx = m_index.load(std::memory_order_acquire);
-    auto _sz  = m_headers.size();
+    auto _num = m_headers.size();
+    auto _sz  = std::min(_idx, _num);
     _fs.write(reinterpret_cast<char*>(&_idx), sizeof(_idx));
+    _fs.write(reinterpret_cast<char*>(&_num), sizeof(_num));
     _fs.write(reinterpret_cast<char*>(&_sz), sizeof(_sz));
-    _fs.write(reinterpret_cast<char*>(m_headers.data()), sizeof(rocprofiler_record_header_t) * _sz);
-    m_buffer.save(_fs);
+
+    // only the used headers are saved and the payloads are saved as offsets into the buffer
+    // (plus one so that zero remains a null payload) so that they can be relocated on load
+    const auto* _base    = static_cast<const char*>(m_buffer.data());
+    auto        _headers = record_vec_t{m_headers.begin(), m_headers.begin() + _sz};
+    for(auto& itr : _headers)
+    {
+        if(itr.payload == nullptr) continue;
+        auto _offset = static_cast<const char*>(itr.payload) - _base;
+        itr.payload  = reinterpret_cast<void*>(static_cast<uintptr_t>(_offset) + 1);
+    }
+
+    _fs.write(reinterpret_cast<char*>(_headers.data()), sizeof(rocprofiler_record_header_t) * _sz);
+    m_buffer.save(_fs, _compress);
 }
 
 void
@@ -161,6 +178,9 @@ record_header_buffer::load(std::fstream& _fs)
         m_index.store(_idx, std::memory_order_release);
     }
 
+    auto _num = size_t{0};
+    _fs.read(reinterpret_cast<char*>(&_num), sizeof(_num));
+
     {
         auto _sz = size_t{0};
         _fs.read(reinterpret_cast<char*>(&_sz), sizeof(_sz));
@@ -170,5 +190,19 @@ record_header_buffer::load(std::fstream& _fs)
     }
 
     m_buffer.load(_fs);
+
+    // relocate the payloads into the new allocation
+    auto* _base = static_cast<char*>(m_buffer.data());
+    for(auto& itr : m_headers)
+    {
+        if(itr.payload == nullptr) continue;
+        itr.payload = _base + (reinterpret_cast<uintptr_t>(itr.payload) - 1);
+    }
+
+    // as many headers as the saved buffer had, see allocate()
+    rocprofiler_record_header_t record = {};
+    record.hash                        = 0;
+    record.payload                     = nullptr;
+    m_headers.resize(std::max(m_headers.size(), _num), record);
 }
 }  // namespace rocprofiler::common::container
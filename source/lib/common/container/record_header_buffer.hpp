@@ -26,10 +26,13 @@
 
 #include "lib/common/container/ring_buffer.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <limits>
 #include <mutex>
 #include <shared_mutex>
+#include <type_traits>
 #include <vector>
 
 namespace rocprofiler
@@ -58,7 +61,7 @@ struct record_header_buffer
 
     // allocate the buffer if it is not already allocated. Will return false if buffer is already
     // allocated
-    bool allocate(size_t nbytes);
+    bool allocate(size_t nbytes, ring_buffer_options opts = {});
 
     // return whether the buffer has been allocated
     bool is_allocated() const;
@@ -75,6 +78,18 @@ struct record_header_buffer
     template <typename Tp>
     bool emplace(uint32_t, uint32_t, Tp&);
 
+    /// place the leading bytes of a trivially copyable object in the buffer, e.g. a record ending
+    /// in a union of which only one member is used. The size is rounded up to the alignment of Tp
+    template <typename Tp>
+    bool emplace(uint32_t, uint32_t, const Tp&, size_t);
+
+    /// reserve contiguous space for up to N objects of type Tp and invoke the functor with
+    /// a pointer to the (uninitialized) space and the number of objects reserved. The functor is
+    /// expected to construct every object in-place. Returns the number of objects placed in the
+    /// buffer, which is less than N when the buffer does not have enough free space.
+    template <typename Tp, typename FuncT>
+    size_t emplace_n(uint32_t, uint32_t, size_t, FuncT&&);
+
     /// this function will return a vector of pointers to the record headers
     /// at the time of invocation.
     record_ptr_vec_t get_record_headers(size_t _n = std::numeric_limits<size_t>::max());
@@ -99,10 +114,11 @@ struct record_header_buffer
     /// restores to original empty state
     size_t clear();
 
-    /// binary save to file
-    void save(std::fstream& _fs);
+    /// binary save of the used headers and the used region of the buffer to file, optionally
+    /// compressing the buffer
+    void save(std::fstream& _fs, bool _compress = false);
 
-    /// binary load from file
+    /// binary load from file. The payloads of the headers are relocated into the new allocation
     void load(std::fstream& _fs);
 
     /// full deallocation
@@ -240,19 +256,22 @@ record_header_buffer::emplace(uint64_t _hash, Tp& _v)
     m_requested.fetch_add(1);
 
     // in theory, we shouldn't need to lock here but the thread sanitizer says there is a race.
-    // the lock will be short-lived so hopefully, it will scale fine
+    // the lock will be short-lived so hopefully, it will scale fine.
+    // the header index is taken along with the space in the buffer since m_headers only has one
+    // entry per requested byte, which may be fewer than the capacity of the buffer
+    auto  idx   = size_t{0};
+    void* _addr = nullptr;
     write_lock();
-    auto* _addr = m_buffer.request(request_size, false);
+    if(m_index.load(std::memory_order_acquire) < m_headers.size())
+    {
+        _addr = m_buffer.request(request_size, false);
+        if(_addr) idx = m_index.fetch_add(1, std::memory_order_release);
+    }
     write_unlock();
 
     read_lock();
     if(_addr)
     {
-        // if there is space in the buffer, atomically get an index
-        // for where the header record should be placed.
-        // NOTE: m_headers was resized to be large enough to accomodate
-        // sizeof(Tp) == 1 for every entry in buffer
-        auto idx = m_index.fetch_add(1, std::memory_order_release);
 
         // placement new
         new(_addr) Tp{_v};
@@ -282,19 +301,22 @@ record_header_buffer::emplace(uint32_t _category, uint32_t _kind, Tp& _v)
     m_requested.fetch_add(1);
 
     // in theory, we shouldn't need to lock here but the thread sanitizer says there is a race.
-    // the lock will be short-lived so hopefully, it will scale fine
+    // the lock will be short-lived so hopefully, it will scale fine.
+    // the header index is taken along with the space in the buffer since m_headers only has one
+    // entry per requested byte, which may be fewer than the capacity of the buffer
+    auto  idx   = size_t{0};
+    void* _addr = nullptr;
     write_lock();
-    auto* _addr = m_buffer.request(request_size, false);
+    if(m_index.load(std::memory_order_acquire) < m_headers.size())
+    {
+        _addr = m_buffer.request(request_size, false);
+        if(_addr) idx = m_index.fetch_add(1, std::memory_order_release);
+    }
     write_unlock();
 
     read_lock();
     if(_addr)
     {
-        // if there is space in the buffer, atomically get an index
-        // for where the header record should be placed.
-        // NOTE: m_headers was resized to be large enough to accomodate
-        // sizeof(Tp) == 1 for every entry in buffer
-        auto idx = m_index.fetch_add(1, std::memory_order_release);
 
         // placement new
         new(_addr) Tp{_v};
@@ -313,6 +335,96 @@ record_header_buffer::emplace(uint32_t _category, uint32_t _kind, Tp& _v)
     return (_addr != nullptr);
 }
 
+template <typename Tp>
+bool
+record_header_buffer::emplace(uint32_t _category, uint32_t _kind, const Tp& _v, size_t _size)
+{
+    static_assert(std::is_trivially_copyable<Tp>::value,
+                  "partial copies are only supported for trivially copyable types");
+
+    if(m_headers.empty()) return false;
+
+    const auto request_size =
+        std::min<size_t>(((_size + alignof(Tp) - 1) / alignof(Tp)) * alignof(Tp), sizeof(Tp));
+
+    // notify there was a request
+    m_requested.fetch_add(1);
+
+    // see emplace(uint32_t, uint32_t, Tp&)
+    auto  idx   = size_t{0};
+    void* _addr = nullptr;
+    write_lock();
+    if(m_index.load(std::memory_order_acquire) < m_headers.size())
+    {
+        _addr = m_buffer.request(request_size, false);
+        if(_addr) idx = m_index.fetch_add(1, std::memory_order_release);
+    }
+    write_unlock();
+
+    read_lock();
+    if(_addr)
+    {
+        std::memcpy(_addr, &_v, request_size);
+
+        auto record       = rocprofiler_record_header_t{};
+        record.category   = _category;
+        record.kind       = _kind;
+        record.payload    = _addr;
+        m_headers.at(idx) = record;
+    }
+    read_unlock();
+
+    // remove notification of request
+    m_requested.fetch_sub(1);
+
+    return (_addr != nullptr);
+}
+
+template <typename Tp, typename FuncT>
+size_t
+record_header_buffer::emplace_n(uint32_t _category, uint32_t _kind, size_t _n, FuncT&& _func)
+{
+    if(m_headers.empty() || _n == 0) return 0;
+
+    // notify there was a request
+    m_requested.fetch_add(1);
+
+    // reserve a contiguous range of header indexes for the objects along with their space
+    auto idx = size_t{0};
+    write_lock();
+    auto _num_headers = m_headers.size() - std::min(m_index.load(), m_headers.size());
+    _n                = std::min<size_t>({_n, m_buffer.free() / sizeof(Tp), _num_headers});
+    auto* _addr       = (_n > 0) ? m_buffer.request(_n * sizeof(Tp), false) : nullptr;
+    if(_addr) idx = m_index.fetch_add(_n, std::memory_order_release);
+    write_unlock();
+
+    if(!_addr) _n = 0;
+
+    read_lock();
+    if(_addr)
+    {
+        auto* _arr = static_cast<Tp*>(_addr);
+
+        // objects are constructed in-place by the caller
+        _func(_arr, _n);
+
+        for(size_t i = 0; i < _n; ++i)
+        {
+            auto record           = rocprofiler_record_header_t{};
+            record.category       = _category;
+            record.kind           = _kind;
+            record.payload        = &_arr[i];
+            m_headers.at(idx + i) = record;
+        }
+    }
+    read_unlock();
+
+    // remove notification of request
+    m_requested.fetch_sub(1);
+
+    return _n;
+}
+
 template <typename Tp>
 bool
 record_header_buffer::emplace(Tp& _v)
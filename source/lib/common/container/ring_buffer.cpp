@@ -21,10 +21,15 @@
 // SOFTWARE.
 
 #include "ring_buffer.hpp"
+#include "lib/common/compression.hpp"
 #include "lib/common/environment.hpp"
+#include "lib/common/logging.hpp"
 #include "lib/common/units.hpp"
 
+#include <linux/mempolicy.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include <atomic>
 #include <cerrno>
 #include <cstddef>
@@ -32,7 +37,11 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <new>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace rocprofiler
 {
@@ -40,6 +49,91 @@ namespace common
 {
 namespace container
 {
+namespace
+{
+size_t
+get_huge_page_size()
+{
+    static auto _v = []() -> size_t {
+        auto _ifs  = std::ifstream{"/proc/meminfo"};
+        auto _line = std::string{};
+        while(std::getline(_ifs, _line))
+        {
+            // e.g. "Hugepagesize:       2048 kB"
+            constexpr auto key = std::string_view{"Hugepagesize:"};
+            if(_line.compare(0, key.length(), key) != 0) continue;
+
+            auto   _iss = std::istringstream{_line.substr(key.length())};
+            size_t _kb  = 0;
+            if(_iss >> _kb && _kb > 0) return _kb * units::KiB;
+        }
+        return 2 * units::MiB;
+    }();
+    return _v;
+}
+
+size_t
+round_up(size_t _size, size_t _multiple)
+{
+    return ((_size + _multiple - 1) / _multiple) * _multiple;
+}
+
+void
+bind_numa_node(void* _ptr, size_t _size, int64_t _node)
+{
+    constexpr size_t  bits_per_word = 8 * sizeof(unsigned long);
+    constexpr int64_t max_numa_node = 1 << 16;  // well above the kernel's MAX_NUMNODES
+
+    // the buffer API validates the node against the system, this only bounds the mask size
+    if(_node < 0 || _node >= max_numa_node)
+    {
+        ROCP_WARNING << "ring_buffer: invalid NUMA node " << _node;
+        return;
+    }
+
+    auto _mask = std::vector<unsigned long>((_node / bits_per_word) + 1, 0);
+    _mask.back() |= (1UL << (_node % bits_per_word));
+
+    // the kernel interprets maxnode as one more than the number of bits in the mask
+    auto _maxnode = (_mask.size() * bits_per_word) + 1;
+    if(syscall(SYS_mbind, _ptr, _size, MPOL_BIND, _mask.data(), _maxnode, 0) != 0)
+    {
+        auto _err = errno;
+        ROCP_WARNING << "ring_buffer: binding " << _size << " bytes to NUMA node " << _node
+                     << " failed: " << strerror(_err);
+    }
+}
+
+// spells "rocpRB02" in memory
+constexpr uint64_t save_magic = 0x3230425270636f72ULL;
+
+struct save_header
+{
+    uint64_t magic        = save_magic;
+    uint64_t capacity     = 0;
+    uint64_t read_count   = 0;
+    uint64_t write_count  = 0;
+    uint64_t compressed   = 0;  // payload is compressed via common::compression
+    uint64_t payload_size = 0;  // number of bytes following the header
+};
+
+// the used region of a buffer, [read, write), wraps around the end of the buffer at most once
+struct live_region
+{
+    live_region(uint64_t _capacity, uint64_t _read_count, uint64_t _write_count)
+    : count{_write_count - _read_count}
+    , begin{(_capacity > 0) ? (_read_count % _capacity) : 0}
+    , first{std::min<uint64_t>(count, _capacity - begin)}
+    {}
+
+    bool wraps() const { return first < count; }
+
+    uint64_t count = 0;  // total number of bytes
+    uint64_t begin = 0;  // offset of the first byte
+    uint64_t first = 0;  // number of bytes before the end of the buffer
+};
+}  // namespace
+
 namespace base
 {
 ring_buffer::~ring_buffer() { destroy(); }
@@ -48,6 +142,7 @@ ring_buffer::ring_buffer(ring_buffer&& rhs) noexcept
 : m_init{rhs.m_init}
 , m_ptr{rhs.m_ptr}
 , m_size{rhs.m_size}
+, m_options{rhs.m_options}
 , m_read_count{rhs.m_read_count.load()}
 , m_write_count{rhs.m_write_count.load()}
 {
@@ -62,6 +157,7 @@ ring_buffer::operator=(ring_buffer&& rhs) noexcept
     m_init        = rhs.m_init;
     m_ptr         = rhs.m_ptr;
     m_size        = rhs.m_size;
+    m_options     = rhs.m_options;
     m_read_count  = rhs.m_read_count.load();
     m_write_count = rhs.m_write_count.load();
     rhs.reset();
@@ -69,7 +165,7 @@ ring_buffer::operator=(ring_buffer&& rhs) noexcept
 }
 
 void
-ring_buffer::init(size_t _size)
+ring_buffer::init(size_t _size, ring_buffer_options _opts)
 {
     if(m_init)
         throw std::runtime_error("rocprofiler::common::container::base::ring_buffer::init(size_t) "
@@ -91,18 +187,58 @@ ring_buffer::init(size_t _size)
     }
 
     m_size        = _size;
+    m_options     = _opts;
     m_read_count  = 0;
     m_write_count = 0;
 
-    // Map twice the buffer size.
-    if((m_ptr =
-            mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0)) ==
-       MAP_FAILED)
+    constexpr int prot  = PROT_READ | PROT_WRITE;
+    constexpr int flags = MAP_ANONYMOUS | MAP_PRIVATE;
+
+    // pages must be bound to the NUMA node before they are faulted in
+    const bool bind_numa = (m_options.numa_node >= 0);
+    const int  populate  = (m_options.prefault && !bind_numa) ? MAP_POPULATE : 0;
+
+    m_ptr = MAP_FAILED;
+    if(m_options.huge_pages)
+    {
+        // explicit huge pages require reserved pages (vm.nr_hugepages) and a size which is a
+        // multiple of the huge page size. Fall back to transparent huge pages when unavailable
+        auto _huge_size = round_up(m_size, get_huge_page_size());
+        m_ptr           = mmap(nullptr, _huge_size, prot, flags | MAP_HUGETLB | populate, -1, 0);
+        if(m_ptr != MAP_FAILED)
+            m_size = _huge_size;
+        else
+            m_options.transparent_huge_pages = true;
+    }
+
+    if(m_ptr == MAP_FAILED) m_ptr = mmap(nullptr, m_size, prot, flags | populate, -1, 0);
+
+    if(m_ptr == MAP_FAILED)
     {
-        destroy();
         auto _err = errno;
+        m_ptr     = nullptr;
+        destroy();
         throw std::runtime_error(strerror(_err));
     }
+
+    if(m_options.transparent_huge_pages && madvise(m_ptr, m_size, MADV_HUGEPAGE) != 0)
+    {
+        auto _err = errno;
+        ROCP_INFO << "ring_buffer: madvise(MADV_HUGEPAGE) failed: " << strerror(_err);
+    }
+
+    if(bind_numa)
+    {
+        bind_numa_node(m_ptr, m_size, m_options.numa_node);
+
+        // touch every page so that the memory is allocated on the bound node now instead of on
+        // the first write from a producer
+        if(m_options.prefault)
+        {
+            for(size_t i = 0; i < m_size; i += units::get_page_size())
+                static_cast<volatile char*>(m_ptr)[i] = 0;
+        }
+    }
 }
 
 void
@@ -116,6 +252,7 @@ ring_buffer::destroy()
     }
     m_init        = false;
     m_size        = 0;
+    m_options     = {};
     m_read_count  = 0;
     m_write_count = 0;
     m_ptr         = nullptr;
@@ -194,47 +331,105 @@ ring_buffer::retrieve(size_t _length) const
 void
 ring_buffer::reset()
 {
-    m_init = false;
-    m_size = 0;
-    m_ptr  = nullptr;
+    m_init    = false;
+    m_size    = 0;
+    m_options = {};
+    m_ptr     = nullptr;
     m_read_count.store(0);
     m_write_count.store(0);
 }
 //
 
 void
-ring_buffer::save(std::fstream& _fs)
+ring_buffer::save(std::fstream& _fs, bool _compress)
 {
-    auto _read_count  = m_read_count.load();
-    auto _write_count = m_write_count.load();
-    _fs.write(reinterpret_cast<char*>(&m_size), sizeof(m_size));
-    _fs.write(reinterpret_cast<char*>(&_read_count), sizeof(_read_count));
-    _fs.write(reinterpret_cast<char*>(&_write_count), sizeof(_write_count));
-    _fs.write(reinterpret_cast<char*>(m_ptr), m_size * sizeof(char));
+    auto _header        = save_header{};
+    _header.capacity    = m_size;
+    _header.read_count  = m_read_count.load();
+    _header.write_count = m_write_count.load();
+
+    const auto* _data   = static_cast<const char*>(m_ptr);
+    const auto  _region = live_region{m_size, _header.read_count, _header.write_count};
+
+    if(!_compress || _region.count == 0)
+    {
+        _header.payload_size = _region.count;
+        _fs.write(reinterpret_cast<char*>(&_header), sizeof(_header));
+        _fs.write(_data + _region.begin, _region.first);
+        _fs.write(_data, _region.count - _region.first);
+        return;
+    }
+
+    // make the region contiguous before compressing it
+    auto        _contiguous = std::vector<char>{};
+    const char* _src        = _data + _region.begin;
+    if(_region.wraps())
+    {
+        _contiguous.reserve(_region.count);
+        _contiguous.insert(_contiguous.end(), _src, _src + _region.first);
+        _contiguous.insert(_contiguous.end(), _data, _data + (_region.count - _region.first));
+        _src = _contiguous.data();
+    }
+
+    auto _payload = std::vector<char>{};
+    compression::compress(_src, _region.count, _payload);
+
+    _header.compressed   = 1;
+    _header.payload_size = _payload.size();
+    _fs.write(reinterpret_cast<char*>(&_header), sizeof(_header));
+    _fs.write(_payload.data(), _payload.size());
 }
 //
 
 void
 ring_buffer::load(std::fstream& _fs)
 {
+    // explicit huge pages may round up the capacity, which would not match the saved offsets
+    auto _opts       = m_options;
+    _opts.huge_pages = false;
     destroy();
 
-    size_t _read_count  = 0;
-    size_t _write_count = 0;
-    size_t _size        = 0;
+    auto _header = save_header{};
+    _fs.read(reinterpret_cast<char*>(&_header), sizeof(_header));
 
-    _fs.read(reinterpret_cast<char*>(&_size), sizeof(_size));
+    if(!_fs || _header.magic != save_magic)
+        throw std::runtime_error("ring_buffer::load :: unrecognized buffer format");
 
-    init(_size);
+    init(_header.capacity, _opts);
 
     if(!m_ptr) throw std::bad_alloc{};
 
-    _fs.read(reinterpret_cast<char*>(&_read_count), sizeof(_read_count));
-    _fs.read(reinterpret_cast<char*>(&_write_count), sizeof(_write_count));
-    _fs.read(reinterpret_cast<char*>(m_ptr), m_size * sizeof(char));
+    auto* _data   = static_cast<char*>(m_ptr);
+    auto  _region = live_region{m_size, _header.read_count, _header.write_count};
+
+    if(_region.count > m_size)
+        throw std::runtime_error("ring_buffer::load :: saved region exceeds the capacity");
+
+    if(_header.compressed == 0)
+    {
+        _fs.read(_data + _region.begin, _region.first);
+        _fs.read(_data, _region.count - _region.first);
+    }
+    else
+    {
+        auto _payload = std::vector<char>(_header.payload_size);
+        _fs.read(_payload.data(), _payload.size());
+
+        // decompress directly into the buffer unless the region wraps around
+        auto  _contiguous = std::vector<char>(_region.wraps() ? _region.count : 0);
+        char* _dst        = (_region.wraps()) ? _contiguous.data() : (_data + _region.begin);
+        if(!compression::decompress(_payload.data(), _payload.size(), _dst, _region.count))
+            throw std::runtime_error("ring_buffer::load :: corrupt compressed buffer");
+
+        if(_region.wraps())
+        {
+            ::memcpy(_data + _region.begin, _dst, _region.first);
+            ::memcpy(_data, _dst + _region.first, _region.count - _region.first);
+        }
+    }
 
-    m_read_count.store(_read_count, std::memory_order_release);
-    m_write_count.store(_write_count, std::memory_order_release);
+    m_read_count.store(_header.read_count, std::memory_order_release);
+    m_write_count.store(_header.write_count, std::memory_order_release);
 }
 
 bool
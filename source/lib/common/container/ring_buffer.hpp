@@ -28,7 +28,9 @@
 #include <atomic>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -45,6 +47,16 @@ namespace container
 template <typename Tp>
 struct ring_buffer;
 //
+/// \struct rocprofiler::common::container::ring_buffer_options
+/// \brief Placement of the memory backing a ring buffer
+struct ring_buffer_options
+{
+    bool    huge_pages             = false;  ///< explicit huge pages, falls back to transparent
+    bool    transparent_huge_pages = false;  ///< advise the kernel to use transparent huge pages
+    bool    prefault               = false;  ///< fault in every page when the buffer is created
+    int64_t numa_node              = -1;     ///< bind the memory to this NUMA node if >= 0
+};
+//
 namespace base
 {
 /// \struct rocprofiler::common::container::base::ring_buffer
@@ -55,7 +67,7 @@ struct ring_buffer
     friend struct container::ring_buffer;
 
     ring_buffer() = default;
-    explicit ring_buffer(size_t _size) { init(_size); }
+    explicit ring_buffer(size_t _size, ring_buffer_options _opts = {}) { init(_size, _opts); }
 
     ~ring_buffer();
 
@@ -68,8 +80,12 @@ struct ring_buffer
     /// Get the total number of bytes supported
     size_t capacity() const { return m_size; }
 
-    /// Creates new ring buffer.
-    void init(size_t size);
+    /// Creates new ring buffer. The capacity is rounded up to a multiple of the page size (or
+    /// of the huge page size when explicit huge pages are used).
+    void init(size_t size, ring_buffer_options opts = {});
+
+    /// Returns the memory placement options of the buffer
+    const ring_buffer_options& options() const { return m_options; }
 
     /// Destroy ring buffer.
     void destroy();
@@ -123,10 +139,13 @@ struct ring_buffer
     /// Display info about buffer
     std::string as_string() const;
 
-    /// save the entire buffer to a filestream
-    void save(std::fstream& _fs);
+    /// Returns the base address of the allocation
+    void* data() const { return m_ptr; }
+
+    /// save the used region of the buffer to a filestream, optionally compressed
+    void save(std::fstream& _fs, bool _compress = false);
 
-    /// load the entire buffer from a filestream
+    /// load a buffer saved via save() from a filestream
     void load(std::fstream& _fs);
 
     /// query whether the read pointer is zero and thus clearing is supported
@@ -164,6 +183,7 @@ private:
     bool                        m_init        = false;
     void*                       m_ptr         = nullptr;
     size_t                      m_size        = 0;
+    ring_buffer_options         m_options     = {};
     mutable std::atomic<size_t> m_read_count  = 0;
     std::atomic<size_t>         m_write_count = 0;
 };
@@ -0,0 +1,303 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/container/string_table.hpp"
+#include "lib/common/logging.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace rocprofiler
+{
+namespace common
+{
+namespace container
+{
+namespace
+{
+constexpr uintptr_t child_tag         = 1;
+constexpr size_t    root_hash_bits    = 12;
+constexpr size_t    child_hash_bits   = 4;
+constexpr size_t    max_hash_bits     = std::numeric_limits<size_t>::digits;
+constexpr size_t    child_bucket_mask = string_table::num_child_buckets - 1;
+
+static_assert((size_t{1} << root_hash_bits) == string_table::num_buckets);
+static_assert((size_t{1} << child_hash_bits) == string_table::num_child_buckets);
+
+bool
+is_child(uintptr_t bucket)
+{
+    return (bucket & child_tag) != 0;
+}
+
+template <typename Tp>
+Tp*
+as_pointer(uintptr_t bucket)
+{
+    return reinterpret_cast<Tp*>(bucket & ~child_tag);
+}
+}  // namespace
+
+string_table::string_table(size_t max_ids)
+: m_max_ids{std::min(max_ids, id_capacity)}
+{}
+
+string_table::~string_table()
+{
+    // the entries are released through the lists, each entry is in exactly one live list
+    auto _release = [](uintptr_t _bucket, auto& _release_v) -> void {
+        if(is_child(_bucket))
+        {
+            auto* _children = as_pointer<child_table_t>(_bucket);
+            for(auto& itr : *_children)
+                _release_v(itr.load(std::memory_order_acquire), _release_v);
+            delete _children;
+            return;
+        }
+
+        const auto* _node = as_pointer<const node>(_bucket);
+        while(_node)
+        {
+            const auto* _next = _node->next;
+            delete _node->value;
+            delete _node;
+            _node = _next;
+        }
+    };
+
+    for(auto& itr : m_buckets)
+        _release(itr.load(std::memory_order_acquire), _release);
+
+    // the nodes of the retired lists refer to the entries moved to the child buckets
+    auto* _retired = m_retired.load(std::memory_order_acquire);
+    while(_retired)
+    {
+        const auto* _node = _retired->head;
+        while(_node)
+        {
+            const auto* _next = _node->next;
+            delete _node;
+            _node = _next;
+        }
+
+        auto* _next = _retired->next;
+        delete _retired;
+        _retired = _next;
+    }
+
+    for(auto& itr : m_chunks)
+        delete itr.load(std::memory_order_acquire);
+}
+
+std::pair<uint64_t, const std::string*>
+string_table::intern(std::string_view value, size_t _hash)
+{
+    auto* _bucket = &m_buckets.at(_hash % num_buckets);
+    auto  _shift  = root_hash_bits;
+
+    entry* _entry = nullptr;
+    node*  _node  = nullptr;
+
+    auto _result = [this](const entry* _value) {
+        if(_value->id == 0) m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return std::make_pair(_value->id, &_value->value);
+    };
+
+    while(true)
+    {
+        auto _head = _bucket->load(std::memory_order_acquire);
+        if(is_child(_head))
+        {
+            _bucket = &as_pointer<child_table_t>(_head)->at((_hash >> _shift) & child_bucket_mask);
+            _shift += child_hash_bits;
+            continue;
+        }
+
+        // another thread may have inserted the same string since the bucket was last searched
+        size_t _length = 0;
+        if(const auto* _existing = find(as_pointer<const node>(_head), _hash, value, _length))
+        {
+            if(_entry)
+            {
+                publish(_entry->id, nullptr);
+                delete _entry;
+                delete _node;
+            }
+            return _result(_existing);
+        }
+
+        // replace the bucket by child buckets while there are hash bits left to tell the entries
+        // apart. The bucket is searched again whether or not this thread split it
+        if(_length >= max_chain_length && _shift + child_hash_bits <= max_hash_bits)
+        {
+            split(*_bucket, _head, _shift);
+            continue;
+        }
+
+        if(!_entry)
+        {
+            _entry = new entry{next_id(), _hash, std::string{value}};
+            _node  = new node{_entry, nullptr};
+
+            // the id must resolve before the entry can be found via the bucket
+            publish(_entry->id, _entry);
+        }
+
+        _node->next = as_pointer<const node>(_head);
+        if(_bucket->compare_exchange_strong(_head,
+                                            reinterpret_cast<uintptr_t>(_node),
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_acquire))
+            return _result(_entry);
+    }
+}
+
+uint64_t
+string_table::find(std::string_view value, size_t _hash) const
+{
+    const auto* _entry = find_entry(value, _hash);
+    return (_entry) ? _entry->id : 0;
+}
+
+const std::string*
+string_table::find(uint64_t id) const
+{
+    if(id == 0 || id >= m_max_ids) return nullptr;
+
+    const auto* _chunk = m_chunks.at(id / chunk_size).load(std::memory_order_acquire);
+    if(!_chunk) return nullptr;
+
+    const auto* _entry = _chunk->at(id % chunk_size).load(std::memory_order_acquire);
+    return (_entry) ? &_entry->value : nullptr;
+}
+
+size_t
+string_table::size() const
+{
+    return std::min<size_t>(m_size.load(std::memory_order_acquire), m_max_ids);
+}
+
+const string_table::entry*
+string_table::find_entry(std::string_view value, size_t _hash) const
+{
+    const auto* _bucket = &m_buckets.at(_hash % num_buckets);
+    auto        _shift  = root_hash_bits;
+
+    auto _head = _bucket->load(std::memory_order_acquire);
+    while(is_child(_head))
+    {
+        _bucket = &as_pointer<child_table_t>(_head)->at((_hash >> _shift) & child_bucket_mask);
+        _shift += child_hash_bits;
+        _head = _bucket->load(std::memory_order_acquire);
+    }
+
+    size_t _length = 0;
+    return find(as_pointer<const node>(_head), _hash, value, _length);
+}
+
+// searches the list and counts the nodes visited
+const string_table::entry*
+string_table::find(const node* head, size_t _hash, std::string_view value, size_t& length) const
+{
+    for(const auto* itr = head; itr != nullptr; itr = itr->next, ++length)
+    {
+        if(itr->value->hash == _hash && itr->value->value == value) return itr->value;
+    }
+    return nullptr;
+}
+
+// replaces the list in the bucket with child buckets indexed by the hash bits starting at shift.
+// Fails without side effects if another thread changed the bucket in the meantime
+void
+string_table::split(bucket_t& bucket, uintptr_t head, size_t shift)
+{
+    auto* _children = new child_table_t{};
+    for(const auto* itr = as_pointer<const node>(head); itr != nullptr; itr = itr->next)
+    {
+        auto& _child = _children->at((itr->value->hash >> shift) & child_bucket_mask);
+        auto* _node  = new node{itr->value, as_pointer<const node>(_child.load())};
+        _child.store(reinterpret_cast<uintptr_t>(_node));
+    }
+
+    auto _expected = head;
+    if(bucket.compare_exchange_strong(_expected,
+                                      reinterpret_cast<uintptr_t>(_children) | child_tag,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_acquire))
+    {
+        // readers may still walk the old list
+        auto* _retired = new retired_list{as_pointer<const node>(head), nullptr};
+        _retired->next = m_retired.load(std::memory_order_relaxed);
+        while(!m_retired.compare_exchange_weak(
+            _retired->next, _retired, std::memory_order_release, std::memory_order_relaxed))
+        {}
+        return;
+    }
+
+    for(auto& itr : *_children)
+    {
+        const auto* _node = as_pointer<const node>(itr.load());
+        while(_node)
+        {
+            const auto* _next = _node->next;
+            delete _node;
+            _node = _next;
+        }
+    }
+    delete _children;
+}
+
+// returns zero once the ids are exhausted
+uint64_t
+string_table::next_id()
+{
+    auto _id = m_size.fetch_add(1, std::memory_order_acq_rel);
+    if(_id < m_max_ids) return _id;
+
+    ROCP_WARNING_IF(_id == m_max_ids)
+        << "string table exceeded the maximum number of entries (" << m_max_ids
+        << "). The strings interned from now on are assigned the id zero";
+    return 0;
+}
+
+void
+string_table::publish(uint64_t id, const entry* value)
+{
+    if(id == 0) return;
+
+    auto& _chunk_v = m_chunks.at(id / chunk_size);
+    auto* _chunk   = _chunk_v.load(std::memory_order_acquire);
+    if(!_chunk)
+    {
+        auto* _new_chunk = new entry_chunk_t{};
+        if(_chunk_v.compare_exchange_strong(
+               _chunk, _new_chunk, std::memory_order_acq_rel, std::memory_order_acquire))
+            _chunk = _new_chunk;
+        else
+            delete _new_chunk;
+    }
+
+    _chunk->at(id % chunk_size).store(value, std::memory_order_release);
+}
+}  // namespace container
+}  // namespace common
+}  // namespace rocprofiler
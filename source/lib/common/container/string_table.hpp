@@ -0,0 +1,143 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace rocprofiler
+{
+namespace common
+{
+namespace container
+{
+/// @brief Append-only table of unique strings, each identified by a small integer id assigned in
+/// insertion order (starting at one, zero is never used). Both the string -> id lookup (a
+/// hash-indexed trie of lock-free linked lists) and the id -> string lookup (fixed-size chunks
+/// addressed directly by the id) never take a lock, and concurrent insertions of the same string
+/// are resolved with a compare-and-swap, so it is safe to use on the hot path of the intercepted
+/// API calls. Strings are never removed hence the returned string references remain valid for
+/// the lifetime of the table.
+///
+/// The string lookup starts with num_buckets buckets. A bucket whose list grows past
+/// max_chain_length is replaced by num_child_buckets buckets indexed by the next bits of the hash,
+/// so the lookups stay short however many strings are interned. Once the ids below max_ids
+/// (id_capacity by default) have been assigned, the new strings are still interned but get the id
+/// zero, see dropped().
+class string_table
+{
+public:
+    static constexpr size_t num_buckets       = 4096;
+    static constexpr size_t num_child_buckets = 16;
+    static constexpr size_t max_chain_length  = 8;
+    static constexpr size_t chunk_size        = 1024;
+    static constexpr size_t max_chunks        = 16384;
+    static constexpr size_t id_capacity       = chunk_size * max_chunks;
+
+    string_table() = default;
+    explicit string_table(size_t max_ids);
+    ~string_table();
+
+    string_table(const string_table&) = delete;
+    string_table(string_table&&)      = delete;
+    string_table& operator=(const string_table&) = delete;
+    string_table& operator=(string_table&&) = delete;
+
+    /// returns the id of the string, inserting it if it is not in the table. Returns zero if the
+    /// string did not get an id because the table ran out of ids
+    uint64_t emplace(std::string_view value) { return emplace(value, hash(value)); }
+    uint64_t emplace(std::string_view value, size_t value_hash)
+    {
+        return intern(value, value_hash).first;
+    }
+
+    /// same as emplace but also returns the interned copy of the string, which is available even
+    /// when the string did not get an id
+    std::pair<uint64_t, const std::string*> intern(std::string_view value, size_t value_hash);
+
+    /// returns the id of the string or zero if it is not in the table (or did not get an id)
+    uint64_t find(std::string_view value) const { return find(value, hash(value)); }
+    uint64_t find(std::string_view value, size_t value_hash) const;
+
+    /// returns nullptr if the id is not in the table
+    const std::string* find(uint64_t id) const;
+
+    /// one past the largest id assigned
+    size_t size() const;
+
+    /// number of emplace/intern calls which returned the id zero because the table ran out of ids
+    size_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    /// hash of the string used by the table
+    static size_t hash(std::string_view value) { return std::hash<std::string_view>{}(value); }
+
+private:
+    struct entry
+    {
+        uint64_t    id    = 0;
+        size_t      hash  = 0;
+        std::string value = {};
+    };
+
+    // the entries are shared by the nodes of the lists, hence a bucket is split by building new
+    // lists while the readers may still walk the old one
+    struct node
+    {
+        const entry* value = nullptr;
+        const node*  next  = nullptr;
+    };
+
+    // a bucket holds either the head of a list (node*) or, with the low bit set, the child buckets
+    using bucket_t      = std::atomic<uintptr_t>;
+    using child_table_t = std::array<bucket_t, num_child_buckets>;
+    using entry_chunk_t = std::array<std::atomic<const entry*>, chunk_size>;
+
+    // lists replaced by child buckets, released when the table is destroyed
+    struct retired_list
+    {
+        const node*   head = nullptr;
+        retired_list* next = nullptr;
+    };
+
+    const entry* find_entry(std::string_view, size_t) const;
+    const entry* find(const node*, size_t, std::string_view, size_t&) const;
+    void         split(bucket_t&, uintptr_t, size_t);
+    uint64_t     next_id();
+    void         publish(uint64_t id, const entry* value);
+
+    size_t                                              m_max_ids = id_capacity;
+    std::atomic<uint64_t>                               m_size    = {1};
+    std::atomic<size_t>                                 m_dropped = {0};
+    std::atomic<retired_list*>                          m_retired = {nullptr};
+    std::array<bucket_t, num_buckets>                   m_buckets = {};
+    std::array<std::atomic<entry_chunk_t*>, max_chunks> m_chunks  = {};
+};
+}  // namespace container
+}  // namespace common
+}  // namespace rocprofiler
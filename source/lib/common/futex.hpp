@@ -0,0 +1,69 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+
+namespace rocprofiler
+{
+namespace common
+{
+// Minimal futex wrappers for waiting on a change of a 32-bit atomic without taking a lock.
+// Spurious wake-ups are possible so callers re-check their condition in a loop.
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex requires std::atomic<uint32_t> to be a plain 32-bit word");
+
+// blocks while the value equals the expected value
+inline void
+futex_wait(std::atomic<uint32_t>& _v, uint32_t _expected)
+{
+    ::syscall(SYS_futex,
+              reinterpret_cast<uint32_t*>(&_v),
+              FUTEX_WAIT_PRIVATE,
+              _expected,
+              nullptr,
+              nullptr,
+              0);
+}
+
+// wakes all the threads blocked in futex_wait on the value
+inline void
+futex_wake_all(std::atomic<uint32_t>& _v)
+{
+    ::syscall(SYS_futex,
+              reinterpret_cast<uint32_t*>(&_v),
+              FUTEX_WAKE_PRIVATE,
+              INT_MAX,
+              nullptr,
+              nullptr,
+              0);
+}
+}  // namespace common
+}  // namespace rocprofiler
@@ -21,15 +21,14 @@
 // THE SOFTWARE.
 
 #include "lib/common/string_entry.hpp"
-#include "lib/common/scope_destructor.hpp"
+#include "lib/common/container/string_table.hpp"
 #include "lib/common/static_object.hpp"
 
-#include <memory>
-#include <shared_mutex>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
-#include <unordered_map>
-#include <utility>
 
 namespace rocprofiler
 {
@@ -37,66 +36,78 @@ namespace common
 {
 namespace
 {
-using name_array_t = std::unordered_map<size_t, std::unique_ptr<std::string>>;
+using string_table_t = container::string_table;
 
-auto&
-get_sync()
+string_table_t*
+get_string_table()
 {
-    static auto*& _v = static_object<std::shared_mutex>::construct();
-    return *CHECK_NOTNULL(_v);
+    static auto*& _v = static_object<string_table_t>::construct();
+    return _v;
 }
 
-name_array_t*
-get_string_array()
+// direct-mapped per-thread cache in front of the string table: the small set of strings a thread
+// interns repeatedly (kernel names, marker messages) are resolved without walking the buckets
+// shared with the other threads
+struct cache_entry
 {
-    static auto*& _v = static_object<name_array_t>::construct();
-    return _v;
+    size_t             hash  = 0;
+    uint64_t           id    = 0;
+    const std::string* value = nullptr;
+};
+
+constexpr size_t thread_cache_size = 64;
+
+cache_entry&
+get_thread_cache_entry(size_t _hash)
+{
+    static thread_local auto _v = std::array<cache_entry, thread_cache_size>{};
+    return _v.at(_hash % thread_cache_size);
+}
+
+cache_entry
+intern(std::string_view name)
+{
+    auto* _table = get_string_table();
+    if(!_table) return cache_entry{};
+
+    auto  _hash  = string_table_t::hash(name);
+    auto& _entry = get_thread_cache_entry(_hash);
+    if(_entry.value && _entry.hash == _hash && *_entry.value == name) return _entry;
+
+    auto [_id, _value] = _table->intern(name, _hash);
+    auto _result       = cache_entry{_hash, _id, _value};
+
+    // strings interned after the table ran out of ids are not cached so that every lookup is
+    // accounted for in the dropped count of the table
+    if(_id != 0) _entry = _result;
+    return _result;
 }
 }  // namespace
 
 const std::string*
 get_string_entry(std::string_view name)
 {
-    if(!get_string_array()) return nullptr;
-
-    auto _hash_v = std::hash<std::string_view>{}(name);
-    {
-        auto _lk = std::shared_lock<std::shared_mutex>{get_sync()};
-        if(get_string_array()->count(_hash_v) > 0) return get_string_array()->at(_hash_v).get();
-    }
-
-    auto _lk = std::unique_lock<std::shared_mutex>{get_sync()};
-    return get_string_array()
-        ->emplace(_hash_v, std::make_unique<std::string>(name))
-        .first->second.get();
+    return intern(name).value;
 }
 
 const std::string*
-get_string_entry(size_t _hash_v)
+get_string_entry(size_t id)
 {
-    if(!get_string_array()) return nullptr;
+    if(!get_string_table()) return nullptr;
 
-    auto _lk = std::shared_lock<std::shared_mutex>{get_sync()};
-    if(get_string_array()->count(_hash_v) > 0) return get_string_array()->at(_hash_v).get();
-
-    return nullptr;
+    return get_string_table()->find(static_cast<uint64_t>(id));
 }
 
 size_t
 add_string_entry(std::string_view name)
 {
-    if(!get_string_array()) return 0;
-
-    auto _hash_v = std::hash<std::string_view>{}(name);
-    {
-        auto _lk = std::shared_lock<std::shared_mutex>{get_sync()};
-        if(get_string_array()->count(_hash_v) > 0) return _hash_v;
-    }
-
-    auto _lk = std::unique_lock<std::shared_mutex>{get_sync()};
-    get_string_array()->emplace(_hash_v, std::make_unique<std::string>(name));
+    return intern(name).id;
+}
 
-    return _hash_v;
+size_t
+get_dropped_string_entries()
+{
+    return (get_string_table()) ? get_string_table()->dropped() : 0;
 }
 }  // namespace common
 }  // namespace rocprofiler
@@ -30,13 +30,25 @@ namespace rocprofiler
 {
 namespace common
 {
+// Strings are interned in a process-wide, append-only table: the returned strings remain valid
+// until the library is unloaded and the ids identify a unique string. The ids are assigned
+// sequentially (they are not the hash of the string) and are only meaningful to
+// get_string_entry(size_t). Neither interning nor the lookups take a lock.
+
+// interns the string and returns the interned copy
 const std::string*
 get_string_entry(std::string_view name);
 
+// returns nullptr if the id does not refer to an interned string
 const std::string*
-get_string_entry(size_t hash);
+get_string_entry(size_t id);
 
+// interns the string and returns its id, or zero if the table has run out of ids
 size_t
 add_string_entry(std::string_view name);
+
+// number of times a string was interned without an id because the table has run out of ids
+size_t
+get_dropped_string_entries();
 }  // namespace common
 }  // namespace rocprofiler
@@ -26,11 +26,18 @@
 #include "lib/common/mpl.hpp"
 
 #include <fmt/core.h>
+#include <fmt/format.h>
 #include <fmt/ranges.h>
 
+#include <array>
 #include <cstdint>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <streambuf>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace rocprofiler
 {
@@ -49,6 +56,11 @@ template <size_t N>
 using stringified_argument_array_t =
     container::small_vector<stringified_argument, std::min<size_t>(N, 6)>;
 
+/// max_deref value which prints the address of string arguments instead of reading them. Used
+/// when the memory of the arguments may no longer be valid, e.g. when the arguments are formatted
+/// at the time a buffer is flushed. Pointer arguments are never dereferenced either.
+constexpr int32_t address_only_deref = -1;
+
 template <typename Tp, typename FuncT>
 auto
 stringize_arg_impl(const Tp& _v, const int32_t max_deref, int32_t& deref_cnt, FuncT&& impl)
@@ -62,6 +74,8 @@ stringize_arg_impl(const Tp& _v, const int32_t max_deref, int32_t& deref_cnt, Fu
         if constexpr(std::is_pointer<value_type>::value)
         {
             if(!_v) return std::string{"(null)"};
+            if(max_deref <= address_only_deref)
+                return std::forward<FuncT>(impl)(static_cast<const void*>(_v));
         }
 
         return std::string{_v};
@@ -124,5 +138,231 @@ stringize_arg(int32_t max_deref, const std::pair<const char*, Tp>& arg, FuncT&&
         arg.second, max_deref, _arg.dereference_count, std::forward<FuncT>(impl));
     return _arg;
 }
+
+/// Reusable storage for the string values of the arguments of an API call. The values are
+/// written back-to-back (each one null-terminated) into a single character buffer which keeps
+/// its capacity when cleared, so, once warmed up, formatting the arguments does not allocate.
+class format_buffer
+{
+public:
+    using buffer_type = fmt::memory_buffer;
+
+    format_buffer()
+    : m_streambuf{m_data}
+    , m_stream{&m_streambuf}
+    , m_flags{m_stream.flags()}
+    {}
+
+    ~format_buffer()                    = default;
+    format_buffer(const format_buffer&) = delete;
+    format_buffer(format_buffer&&)      = delete;
+    format_buffer& operator=(const format_buffer&) = delete;
+    format_buffer& operator=(format_buffer&&) = delete;
+
+    void        clear() { m_data.clear(); }
+    size_t      size() const { return m_data.size(); }
+    const char* at(size_t _offset) const { return m_data.data() + _offset; }
+
+    void append(std::string_view _v) { m_data.append(_v.data(), _v.data() + _v.size()); }
+
+    template <typename... Args>
+    void format(fmt::format_string<Args...> _fmt, Args&&... _args)
+    {
+        fmt::format_to(std::back_inserter(m_data), _fmt, std::forward<Args>(_args)...);
+    }
+
+    /// output stream which appends to the buffer, for the types which can only be written
+    /// via operator<<. The formatting state is reset to that of a newly constructed stream.
+    std::ostream& stream()
+    {
+        m_stream.clear();
+        m_stream.flags(m_flags);
+        m_stream.fill(' ');
+        m_stream.precision(6);
+        m_stream.width(0);
+        return m_stream;
+    }
+
+    /// null-terminates the value written since the previous call
+    void terminate() { m_data.push_back('\0'); }
+
+private:
+    struct streambuf : std::streambuf
+    {
+        explicit streambuf(buffer_type& _data)
+        : data{_data}
+        {}
+
+    protected:
+        int_type overflow(int_type _c) override
+        {
+            if(!traits_type::eq_int_type(_c, traits_type::eof()))
+                data.push_back(traits_type::to_char_type(_c));
+            return traits_type::not_eof(_c);
+        }
+
+        std::streamsize xsputn(const char* _s, std::streamsize _n) override
+        {
+            data.append(_s, _s + _n);
+            return _n;
+        }
+
+    private:
+        buffer_type& data;
+    };
+
+    buffer_type             m_data;
+    streambuf               m_streambuf;
+    std::ostream            m_stream;
+    std::ios_base::fmtflags m_flags;
+};
+
+/// Provides a thread-local format_buffer, cleared on entry. Nested instances on the same thread
+/// (e.g. a callback iterating over the arguments of another API call) get distinct buffers.
+class scoped_format_buffer
+{
+public:
+    scoped_format_buffer()
+    : m_buffer{acquire()}
+    {
+        m_buffer.clear();
+    }
+
+    ~scoped_format_buffer() { --get_depth(); }
+
+    scoped_format_buffer(const scoped_format_buffer&) = delete;
+    scoped_format_buffer(scoped_format_buffer&&)      = delete;
+    scoped_format_buffer& operator=(const scoped_format_buffer&) = delete;
+    scoped_format_buffer& operator=(scoped_format_buffer&&) = delete;
+
+    format_buffer& get() { return m_buffer; }
+    const char*    at(size_t _offset) const { return m_buffer.at(_offset); }
+
+private:
+    static size_t& get_depth()
+    {
+        static thread_local size_t _v = 0;
+        return _v;
+    }
+
+    static format_buffer& acquire()
+    {
+        static thread_local auto _pool = std::vector<std::unique_ptr<format_buffer>>{};
+
+        auto _idx = get_depth()++;
+        if(_idx >= _pool.size()) _pool.emplace_back(std::make_unique<format_buffer>());
+        return *_pool.at(_idx);
+    }
+
+    format_buffer& m_buffer;
+};
+
+struct formatted_argument
+{
+    int32_t     indirection_level = 0;
+    int32_t     dereference_count = 0;
+    const char* type              = nullptr;
+    const char* name              = nullptr;
+    size_t      offset            = 0;  // offset of the value in the format_buffer
+};
+
+template <size_t N>
+using formatted_argument_array_t = std::array<formatted_argument, N>;
+
+/// same as stringize_arg_impl but writes the value into the buffer. The impl function is
+/// invoked with the buffer and the value and must produce the same text as the impl function
+/// of stringize_arg_impl
+template <typename Tp, typename FuncT>
+void
+format_arg_impl(format_buffer& _buf,
+                const Tp&      _v,
+                const int32_t  max_deref,
+                int32_t&       deref_cnt,
+                FuncT&&        impl)
+{
+    using value_type      = std::decay_t<Tp>;
+    using nonpointer_type = std::remove_pointer_t<Tp>;
+
+    if constexpr(common::mpl::is_string_type<value_type>::value &&
+                 !std::is_pointer<nonpointer_type>::value)
+    {
+        if constexpr(std::is_pointer<value_type>::value)
+        {
+            if(!_v)
+            {
+                _buf.append("(null)");
+                return;
+            }
+
+            if(max_deref <= address_only_deref)
+            {
+                std::forward<FuncT>(impl)(_buf, static_cast<const void*>(_v));
+                return;
+            }
+        }
+
+        _buf.append(std::string_view{_v});
+    }
+    else if constexpr(fmt::is_formattable<value_type>::value && !std::is_pointer<value_type>::value)
+    {
+        _buf.format("{}", _v);
+    }
+    else if constexpr(std::is_pointer<value_type>::value &&
+                      !std::is_pointer<nonpointer_type>::value &&
+                      common::mpl::is_type_complete_v<nonpointer_type> &&
+                      !std::is_void<nonpointer_type>::value)
+    {
+        if(_v && deref_cnt < max_deref)
+            format_arg_impl(_buf, *_v, max_deref, ++deref_cnt, std::forward<FuncT>(impl));
+        else if(_v)
+            std::forward<FuncT>(impl)(_buf, _v);
+        else
+            _buf.append("(null)");
+    }
+    else if constexpr(std::is_pointer<value_type>::value && std::is_pointer<nonpointer_type>::value)
+    {
+        using next_nonpointer_type = std::remove_pointer_t<nonpointer_type>;
+
+        if(_v)
+        {
+            if constexpr(!std::is_void<next_nonpointer_type>::value)
+            {
+                if(deref_cnt < max_deref)
+                    format_arg_impl(_buf, *_v, max_deref, ++deref_cnt, std::forward<FuncT>(impl));
+                else
+                    std::forward<FuncT>(impl)(_buf, _v);
+            }
+            else
+            {
+                std::forward<FuncT>(impl)(_buf, _v);
+            }
+        }
+        else
+        {
+            _buf.append("(null)");
+        }
+    }
+    else
+    {
+        std::forward<FuncT>(impl)(_buf, _v);
+    }
+}
+
+template <typename Tp, typename FuncT>
+common::formatted_argument
+format_arg(format_buffer&                    _buf,
+           int32_t                           max_deref,
+           const std::pair<const char*, Tp>& arg,
+           FuncT&&                           impl)
+{
+    auto _arg              = common::formatted_argument{};
+    _arg.indirection_level = mpl::indirection_level<Tp>::value;
+    _arg.type              = typeid(Tp).name();
+    _arg.name              = arg.first;
+    _arg.offset            = _buf.size();
+    format_arg_impl(_buf, arg.second, max_deref, _arg.dereference_count, std::forward<FuncT>(impl));
+    _buf.terminate();
+    return _arg;
+}
 }  // namespace common
 }  // namespace rocprofiler
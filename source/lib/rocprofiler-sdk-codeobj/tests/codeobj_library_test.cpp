@@ -22,8 +22,11 @@
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <fstream>
+#include <limits>
 #include <rocprofiler-sdk/cxx/codeobj/code_printing.hpp>
+#include <sstream>
 #include <string_view>
 #include <vector>
 
@@ -122,6 +125,54 @@ TEST(codeobj_library, segment_test)
     }
 }
 
+TEST(codeobj_library, segment_lookup_test)
+{
+    using CodeobjTableTranslator = rocprofiler::sdk::codeobj::segment::CodeobjTableTranslator;
+    using address_range_t        = rocprofiler::sdk::codeobj::segment::address_range_t;
+
+    CodeobjTableTranslator table;
+
+    // ranges of 0x100 bytes every 0x400 bytes, ids 1..N
+    constexpr size_t num_ranges = 1000;
+    for(size_t i = 0; i < num_ranges; i++)
+        ASSERT_TRUE(table.insert({0x1000 + i * 0x400, 0x100, i + 1}).second);
+
+    // overlapping ranges are rejected
+    EXPECT_FALSE(table.insert({0x1080, 0x100, 0}).second);
+    EXPECT_FALSE(table.insert({0x0f80, 0x100, 0}).second);
+    EXPECT_EQ(table.size(), num_ranges);
+
+    std::vector<uint64_t> addrs{};
+    for(uint64_t addr = 0; addr < 0x1000 + num_ranges * 0x400 + 0x400; addr += 0x40)
+        addrs.emplace_back(addr);
+
+    std::vector<address_range_t> batch{};
+    table.find_codeobj_in_range(addrs, batch);
+    ASSERT_EQ(batch.size(), addrs.size());
+
+    for(size_t i = 0; i < addrs.size(); i++)
+    {
+        auto addr     = addrs.at(i);
+        bool inrange  = addr >= 0x1000 && ((addr - 0x1000) % 0x400) < 0x100;
+        auto expected = (addr >= 0x1000) ? (addr - 0x1000) / 0x400 + 1 : 0;
+
+        if(!inrange || expected > num_ranges)
+        {
+            EXPECT_EQ(batch.at(i).size, 0);
+            EXPECT_THROW(table.find_codeobj_in_range(addr), std::exception);
+            continue;
+        }
+
+        EXPECT_EQ(batch.at(i).id, expected);
+        EXPECT_EQ(table.find_codeobj_in_range(addr).id, expected);
+    }
+
+    // lookups see removals
+    ASSERT_TRUE(table.remove(0x1000 + 0x400 * 10 + 0x10));
+    EXPECT_THROW(table.find_codeobj_in_range(0x1000 + 0x400 * 10), std::exception);
+    EXPECT_EQ(table.find_codeobj_in_range(0x1000 + 0x400 * 11).id, 12);
+}
+
 namespace disassembly         = rocprofiler::sdk::codeobj::disassembly;
 namespace codeobjhelper       = rocprofiler::testing::codeobjhelper;
 using CodeobjDecoderComponent = rocprofiler::sdk::codeobj::disassembly::CodeobjDecoderComponent;
@@ -175,6 +226,112 @@ TEST(codeobj_library, decoder_component)
     }
 }
 
+TEST(codeobj_library, decoder_cached_lookup)
+{
+    const std::vector<char>& objdata = codeobjhelper::GetCodeobjContents();
+
+    CodeobjDecoderComponent component(objdata.data(), objdata.size());
+    ASSERT_EQ(component.m_symbol_map.size(), 1);
+
+    const auto& symbol = component.m_symbol_map.begin()->second;
+
+    std::vector<std::unique_ptr<disassembly::Instruction>> first_pass{};
+    for(size_t vaddr = symbol.vaddr; vaddr < symbol.vaddr + symbol.mem_size;)
+    {
+        auto inst = component.disassemble_instruction(*component.va2fo(vaddr), vaddr);
+        ASSERT_NE(inst->size, 0);
+        vaddr += inst->size;
+        first_pass.emplace_back(std::move(inst));
+    }
+
+    // second pass in reverse order is served from the instruction cache
+    for(auto itr = first_pass.rbegin(); itr != first_pass.rend(); ++itr)
+    {
+        const auto& expected = **itr;
+        auto        cached   = component.disassemble_instruction(expected.faddr, expected.vaddr);
+        EXPECT_EQ(cached->inst, expected.inst);
+        EXPECT_EQ(cached->comment, expected.comment);
+        EXPECT_EQ(cached->size, expected.size);
+        EXPECT_EQ(cached->faddr, expected.faddr);
+    }
+}
+
+TEST(codeobj_library, instruction_table)
+{
+    using marker_id_t = rocprofiler::sdk::codeobj::segment::marker_id_t;
+
+    const std::vector<std::string>& hiplines = codeobjhelper::GetHipccOutput();
+    const std::vector<char>&        objdata  = codeobjhelper::GetCodeobjContents();
+    constexpr size_t                laddr    = 0x1000;
+
+    disassembly::CodeobjAddressTranslate map;
+    map.addDecoder((const void*) objdata.data(), objdata.size(), marker_id_t{1}, laddr, 0x2000);
+
+    const auto symbols = map.getSymbolMap(marker_id_t{1});
+    ASSERT_EQ(symbols.size(), 1);
+    const auto& symbol = symbols.begin()->second;
+
+    EXPECT_EQ(map.getInstructionTable(laddr + 0x2000), nullptr);
+    EXPECT_EQ(map.getInstructionTable(marker_id_t{2}, symbol.vaddr), nullptr);
+
+    auto table = map.getInstructionTable(laddr + symbol.vaddr);
+    ASSERT_NE(table, nullptr);
+    EXPECT_EQ(table, map.getInstructionTable(marker_id_t{1}, symbol.vaddr + 4));
+    EXPECT_EQ(table->symbol, symbol.name);
+    ASSERT_FALSE(table->entries.empty());
+
+    for(size_t i = 0; i < table->entries.size(); ++i)
+    {
+        const auto& entry = table->entries.at(i);
+        auto        vaddr = table->vaddr + entry.offset;
+        auto        inst  = map.get(laddr + vaddr);
+
+        ASSERT_NE(inst, nullptr);
+        EXPECT_EQ(table->find(vaddr), &entry);
+        EXPECT_EQ(table->find(vaddr + entry.size - 1), &entry);
+        EXPECT_EQ(table->instruction(entry), inst->inst);
+        EXPECT_EQ(table->comment(entry), inst->comment);
+        EXPECT_EQ(entry.size, inst->size);
+        EXPECT_NE(codeobjhelper::removeNull(table->instruction(entry)).find(hiplines.at(i)),
+                  std::string::npos);
+    }
+
+    std::stringstream stream{};
+    table->save(stream);
+
+    auto loaded = disassembly::InstructionTable::load(stream);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->symbol, table->symbol);
+    EXPECT_EQ(loaded->vaddr, table->vaddr);
+    EXPECT_EQ(loaded->strings, table->strings);
+    ASSERT_EQ(loaded->entries.size(), table->entries.size());
+    for(size_t i = 0; i < table->entries.size(); ++i)
+        EXPECT_EQ(loaded->instruction(loaded->entries.at(i)),
+                  table->instruction(table->entries.at(i)));
+
+    std::stringstream invalid{"not an instruction table"};
+    EXPECT_FALSE(disassembly::InstructionTable::load(invalid).has_value());
+
+    // Every truncation of a valid table is rejected
+    const auto saved = stream.str();
+    for(size_t len = 0; len < saved.size(); len += std::max<size_t>(saved.size() / 64, 1))
+    {
+        std::stringstream truncated{saved.substr(0, len)};
+        EXPECT_FALSE(disassembly::InstructionTable::load(truncated).has_value()) << len;
+    }
+    std::stringstream truncated{saved.substr(0, saved.size() - 1)};
+    EXPECT_FALSE(disassembly::InstructionTable::load(truncated).has_value());
+
+    // A string count larger than the stream is rejected before allocating
+    auto     corrupted     = saved;
+    uint64_t num_strings   = std::numeric_limits<uint64_t>::max() / 2;
+    size_t   strings_count = 5 * sizeof(uint64_t) + table->symbol.size();
+    corrupted.replace(
+        strings_count, sizeof(num_strings), (const char*) &num_strings, sizeof(num_strings));
+    std::stringstream corrupted_stream{corrupted};
+    EXPECT_FALSE(disassembly::InstructionTable::load(corrupted_stream).has_value());
+}
+
 TEST(codeobj_library, loaded_codeobj_component)
 {
     const std::vector<char>& objdata = rocprofiler::testing::codeobjhelper::GetCodeobjContents();
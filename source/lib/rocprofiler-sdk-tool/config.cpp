@@ -187,6 +187,16 @@ get_kernel_filter_range(const std::string& kernel_filter)
     return range_set;
 }
 
+// parse a list of CPUs, e.g. "0-3,8"
+std::vector<uint32_t>
+get_cpu_list(const std::string& cpus)
+{
+    auto cpu_set  = get_kernel_filter_range(cpus);
+    auto cpu_list = std::vector<uint32_t>{cpu_set.begin(), cpu_set.end()};
+    std::sort(cpu_list.begin(), cpu_list.end());
+    return cpu_list;
+}
+
 std::set<std::string>
 parse_counters(std::string line)
 {
@@ -251,6 +261,8 @@ config::config()
 : kernel_filter_range{get_kernel_filter_range(
       get_env("ROCPROF_KERNEL_FILTER_RANGE", std::string{}))}
 , counters{parse_counters(get_env("ROCPROF_COUNTERS", std::string{}))}
+, callback_thread_affinity{
+      get_cpu_list(get_env("ROCPROF_CALLBACK_THREAD_AFFINITY", std::string{}))}
 {
     auto to_upper = [](std::string val) {
         for(auto& vitr : val)
@@ -79,8 +79,10 @@ struct config
     bool        pftrace_output              = false;
     bool        otf2_output                 = false;
     bool        kernel_rename               = get_env("ROCPROF_KERNEL_RENAME", false);
+    bool        tmp_compression             = get_env("ROCPROF_TMP_COMPRESSION", false);
     int         mpi_size                    = get_mpi_size();
     int         mpi_rank                    = get_mpi_rank();
+    int         callback_thread_priority    = get_env("ROCPROF_CALLBACK_THREAD_PRIORITY", 0);
     size_t      perfetto_shmem_size_hint    = get_env("ROCPROF_PERFETTO_SHMEM_SIZE_HINT_KB", 64);
     size_t      perfetto_buffer_size        = get_env("ROCPROF_PERFETTO_BUFFER_SIZE_KB", 1024000);
     std::string output_path   = get_env("ROCPROF_OUTPUT_PATH", fs::current_path().string());
@@ -94,8 +96,9 @@ struct config
     std::string perfetto_buffer_fill_policy =
         get_env("ROCPROF_PERFETTO_BUFFER_FILL_POLICY", std::string{"discard"});
     std::string perfetto_backend = get_env("ROCPROF_PERFETTO_BACKEND", std::string{"inprocess"});
-    std::unordered_set<uint32_t> kernel_filter_range = {};
-    std::set<std::string>        counters            = {};
+    std::unordered_set<uint32_t> kernel_filter_range      = {};
+    std::set<std::string>        counters                 = {};
+    std::vector<uint32_t>        callback_thread_affinity = {};
 };
 
 template <config_context ContextT = config_context::global>
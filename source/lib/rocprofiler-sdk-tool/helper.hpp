@@ -125,8 +125,6 @@ inline kernel_symbol_data::kernel_symbol_data()
 : base_type{0, 0, 0, "", 0, 0, 0, 0, 0, 0, 0, 0}
 {}
 
-using kernel_symbol_data_map_t = std::unordered_map<rocprofiler_kernel_id_t, kernel_symbol_data>;
-
 struct rocprofiler_tool_counter_info_t : rocprofiler_counter_info_v0_t
 {
     using parent_type          = rocprofiler_counter_info_v0_t;
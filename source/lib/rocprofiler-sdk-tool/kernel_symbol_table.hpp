@@ -0,0 +1,161 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "helper.hpp"
+
+#include "lib/common/logging.hpp"
+
+#include <rocprofiler-sdk/fwd.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace rocprofiler
+{
+namespace tool
+{
+/**
+ * @brief Append-only table of kernel symbols indexed by kernel id.
+ *
+ * Kernel ids are small integers assigned in increasing order, so the symbols are stored in
+ * fixed-size chunks addressed directly by the id. Entries are never modified or removed once
+ * published, hence lookups are lock-free: a chunk pointer load and an entry pointer load. Only
+ * insertions are serialized.
+ */
+class kernel_symbol_table
+{
+public:
+    static constexpr size_t chunk_size = 256;
+    static constexpr size_t max_chunks = 16384;
+
+    kernel_symbol_table() = default;
+    ~kernel_symbol_table();
+
+    kernel_symbol_table(const kernel_symbol_table&) = delete;
+    kernel_symbol_table& operator=(const kernel_symbol_table&) = delete;
+
+    // returns the symbol for the kernel id and whether it was inserted
+    std::pair<const kernel_symbol_data*, bool> emplace(rocprofiler_kernel_id_t kernel_id,
+                                                       kernel_symbol_data&&    data);
+
+    // returns nullptr if the kernel id has no symbol
+    const kernel_symbol_data* find(rocprofiler_kernel_id_t kernel_id) const;
+
+    // throws std::out_of_range if the kernel id has no symbol
+    const kernel_symbol_data& at(rocprofiler_kernel_id_t kernel_id) const;
+
+    // one past the largest kernel id inserted
+    size_t size() const { return m_size.load(std::memory_order_acquire); }
+
+    template <typename FuncT>
+    void for_each(FuncT&& _func) const;
+
+private:
+    using entry_t = std::atomic<const kernel_symbol_data*>;
+    using chunk_t = std::array<entry_t, chunk_size>;
+
+    std::mutex                                    m_mutex  = {};
+    std::atomic<size_t>                           m_size   = {0};
+    std::array<std::atomic<chunk_t*>, max_chunks> m_chunks = {};
+};
+
+inline kernel_symbol_table::~kernel_symbol_table()
+{
+    for(auto& citr : m_chunks)
+    {
+        auto* _chunk = citr.exchange(nullptr);
+        if(!_chunk) continue;
+        for(auto& eitr : *_chunk)
+            delete eitr.load();
+        delete _chunk;
+    }
+}
+
+inline std::pair<const kernel_symbol_data*, bool>
+kernel_symbol_table::emplace(rocprofiler_kernel_id_t kernel_id, kernel_symbol_data&& data)
+{
+    auto _chunk_idx = kernel_id / chunk_size;
+    ROCP_FATAL_IF(_chunk_idx >= max_chunks)
+        << "kernel_id=" << kernel_id << " exceeds the capacity of the kernel symbol table ("
+        << (max_chunks * chunk_size) << ")";
+
+    auto  _lk    = std::unique_lock<std::mutex>{m_mutex};
+    auto* _chunk = m_chunks.at(_chunk_idx).load(std::memory_order_relaxed);
+    if(!_chunk)
+    {
+        _chunk = new chunk_t{};
+        m_chunks.at(_chunk_idx).store(_chunk, std::memory_order_release);
+    }
+
+    auto& _entry = _chunk->at(kernel_id % chunk_size);
+    if(const auto* _existing = _entry.load(std::memory_order_relaxed)) return {_existing, false};
+
+    const auto* _symbol = new kernel_symbol_data{std::move(data)};
+    _entry.store(_symbol, std::memory_order_release);
+    if(kernel_id + 1 > m_size.load(std::memory_order_relaxed))
+        m_size.store(kernel_id + 1, std::memory_order_release);
+
+    return {_symbol, true};
+}
+
+inline const kernel_symbol_data*
+kernel_symbol_table::find(rocprofiler_kernel_id_t kernel_id) const
+{
+    auto _chunk_idx = kernel_id / chunk_size;
+    if(_chunk_idx >= max_chunks) return nullptr;
+
+    const auto* _chunk = m_chunks[_chunk_idx].load(std::memory_order_acquire);
+    if(!_chunk) return nullptr;
+
+    return (*_chunk)[kernel_id % chunk_size].load(std::memory_order_acquire);
+}
+
+inline const kernel_symbol_data&
+kernel_symbol_table::at(rocprofiler_kernel_id_t kernel_id) const
+{
+    const auto* _symbol = find(kernel_id);
+    if(!_symbol)
+        throw std::out_of_range{"no kernel symbol data for kernel_id=" +
+                                std::to_string(kernel_id)};
+    return *_symbol;
+}
+
+template <typename FuncT>
+void
+kernel_symbol_table::for_each(FuncT&& _func) const
+{
+    auto _size = size();
+    for(size_t i = 0; i < _size; ++i)
+    {
+        if(const auto* _symbol = find(i)) _func(*_symbol);
+    }
+}
+}  // namespace tool
+}  // namespace rocprofiler
@@ -61,7 +61,7 @@ offload_buffer(domain_type type)
     [[maybe_unused]] static auto _success = _tmp_file->open();
     auto&                        _fs      = _tmp_file->stream;
     _tmp_file->file_pos.emplace(_fs.tellg());
-    _tmp_buf->save(_fs);
+    _tmp_buf->save(_fs, rocprofiler::tool::get_config().tmp_compression);
     _tmp_buf->clear();
     CHECK(_tmp_buf->is_empty() == true);
 }
@@ -29,6 +29,7 @@
 #include "generateOTF2.hpp"
 #include "generatePerfetto.hpp"
 #include "helper.hpp"
+#include "kernel_symbol_table.hpp"
 #include "output_file.hpp"
 #include "tmp_file.hpp"
 
@@ -194,7 +195,7 @@ using kernel_rename_map_t   = std::unordered_map<uint64_t, uint64_t>;
 using kernel_rename_stack_t = std::stack<uint64_t>;
 
 auto  code_obj_data          = as_pointer<common::Synchronized<code_object_data_map_t, true>>();
-auto* kernel_data            = as_pointer<common::Synchronized<kernel_symbol_data_map_t, true>>();
+auto* kernel_data            = as_pointer<tool::kernel_symbol_table>();
 auto* marker_msg_data        = as_pointer<common::Synchronized<marker_message_map_t, true>>();
 auto  counter_dimension_data = common::Synchronized<counter_dimension_info_map_t, true>{};
 auto  target_kernels         = common::Synchronized<targeted_kernels_map_t>{};
@@ -585,10 +586,8 @@ code_object_tracing_callback(rocprofiler_callback_tracing_record_t record,
         auto* sym_data = static_cast<rocprofiler_kernel_symbol_data_t*>(record.payload);
         if(record.phase == ROCPROFILER_CALLBACK_PHASE_LOAD)
         {
-            auto itr = kernel_data->wlock([sym_data](auto& _data) {
-                return _data.emplace(sym_data->kernel_id,
-                                     kernel_symbol_data{get_dereference(sym_data)});
-            });
+            auto itr = kernel_data->emplace(sym_data->kernel_id,
+                                            kernel_symbol_data{get_dereference(sym_data)});
 
             ROCP_WARNING_IF(!itr.second)
                 << "duplicate kernel symbol data for kernel_id=" << sym_data->kernel_id;
@@ -598,7 +597,7 @@ code_object_tracing_callback(rocprofiler_callback_tracing_record_t record,
             {
                 // if kernel name is provided by user then by default all kernels in the application
                 // are targeted
-                const auto& kernel_info           = itr.first->second;
+                const auto& kernel_info           = *itr.first;
                 auto        kernel_filter_include = tool::get_config().kernel_filter_include;
                 auto        kernel_filter_exclude = tool::get_config().kernel_filter_exclude;
                 auto        kernel_filter_range   = tool::get_config().kernel_filter_range;
@@ -627,9 +626,7 @@ get_kernel_name(uint64_t kernel_id, uint64_t rename_id)
         if(const auto* _name = common::get_string_entry(rename_id)) return std::string_view{*_name};
     }
 
-    return CHECK_NOTNULL(kernel_data)->rlock([kernel_id](const auto& _data) -> std::string_view {
-        return _data.at(kernel_id).formatted_kernel_name;
-    });
+    return CHECK_NOTNULL(kernel_data)->at(kernel_id).formatted_kernel_name;
 }
 
 std::string_view
@@ -1028,8 +1025,9 @@ counter_record_callback(rocprofiler_profile_counting_dispatch_data_t dispatch_da
     counter_record.dispatch_data = dispatch_data;
     counter_record.thread_id     = user_data.value;
 
-    const kernel_symbol_data* kernel_info =
-        kernel_data->rlock([kernel_id](const auto& _data) { return &_data.at(kernel_id); });
+    const kernel_symbol_data* kernel_info = CHECK_NOTNULL(kernel_data)->find(kernel_id);
+
+    ROCP_FATAL_IF(!kernel_info) << "missing kernel information for kernel_id=" << kernel_id;
 
     auto lds_block_size_v =
         (kernel_info->group_segment_size + (lds_block_size - 1)) & ~(lds_block_size - 1);
@@ -1038,8 +1036,6 @@ counter_record_callback(rocprofiler_profile_counting_dispatch_data_t dispatch_da
     counter_record.sgpr_count       = kernel_info->sgpr_count;
     counter_record.lds_block_size_v = lds_block_size_v;
 
-    ROCP_FATAL_IF(!kernel_info) << "missing kernel information for kernel_id=" << kernel_id;
-
     ROCP_ERROR_IF(record_count == 0) << "zero record count for kernel_id=" << kernel_id
                                      << " (name=" << kernel_info->kernel_name << ")";
 
@@ -1463,6 +1459,12 @@ tool_init(rocprofiler_client_finalize_t fini_func, void* tool_data)
                          "Could not configure external correlation id request service");
     }
 
+    auto cb_thread_props               = rocprofiler_callback_thread_properties_t{};
+    cb_thread_props.size               = sizeof(rocprofiler_callback_thread_properties_t);
+    cb_thread_props.cpu_affinity       = tool::get_config().callback_thread_affinity.data();
+    cb_thread_props.cpu_affinity_count = tool::get_config().callback_thread_affinity.size();
+    cb_thread_props.priority           = tool::get_config().callback_thread_priority;
+
     for(auto itr : get_buffers().as_array())
     {
         if(itr.handle > 0)
@@ -1470,8 +1472,9 @@ tool_init(rocprofiler_client_finalize_t fini_func, void* tool_data)
             auto cb_thread = rocprofiler_callback_thread_t{};
 
             ROCP_INFO << "creating dedicated callback thread for buffer " << itr.handle;
-            ROCPROFILER_CALL(rocprofiler_create_callback_thread(&cb_thread),
-                             "creating callback thread");
+            ROCPROFILER_CALL(
+                rocprofiler_create_callback_thread_with_properties(cb_thread_props, &cb_thread),
+                "creating callback thread");
 
             ROCP_INFO << "assigning buffer " << itr.handle << " to callback thread "
                       << cb_thread.handle;
@@ -1655,23 +1658,11 @@ get_callback_roctx_msg()
 std::vector<kernel_symbol_data>
 get_kernel_symbol_data()
 {
-    auto _data = kernel_data->rlock([](const auto& _data_v) {
-        auto _info = std::vector<kernel_symbol_data>{};
-        _info.reserve(_data_v.size());
-        for(const auto& itr : _data_v)
-            _info.emplace_back(itr.second);
-        return _info;
-    });
-
-    uint64_t kernel_data_size = 0;
-    for(const auto& itr : _data)
-        kernel_data_size = std::max(kernel_data_size, itr.kernel_id);
-
+    // the table is already indexed by the kernel id
     auto _symbol_data = std::vector<kernel_symbol_data>{};
-    _symbol_data.resize(kernel_data_size + 1, kernel_symbol_data{});
-    // index by the kernel id
-    for(auto& itr : _data)
-        _symbol_data.at(itr.kernel_id) = std::move(itr);
+    _symbol_data.resize(std::max<size_t>(kernel_data->size(), 1), kernel_symbol_data{});
+    kernel_data->for_each(
+        [&_symbol_data](const kernel_symbol_data& itr) { _symbol_data.at(itr.kernel_id) = itr; });
 
     return _symbol_data;
 }
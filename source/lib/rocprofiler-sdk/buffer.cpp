@@ -23,8 +23,10 @@
 #include "lib/rocprofiler-sdk/buffer.hpp"
 
 #include "lib/common/container/stable_vector.hpp"
+#include "lib/common/futex.hpp"
 #include "lib/common/static_object.hpp"
 #include "lib/common/utility.hpp"
+#include "lib/rocprofiler-sdk/agent.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
 #include "lib/rocprofiler-sdk/context/domain.hpp"
 #include "lib/rocprofiler-sdk/hsa/hsa.hpp"
@@ -35,10 +37,23 @@
 #include <rocprofiler-sdk/fwd.h>
 #include <rocprofiler-sdk/rocprofiler.h>
 
+#include <fmt/format.h>
+
+#include <pthread.h>
+
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <exception>
+#include <fstream>
+#include <limits>
 #include <mutex>
+#include <new>
 #include <random>
+#include <sstream>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace rocprofiler
@@ -49,6 +64,216 @@ namespace
 {
 using reserve_size_t = common::container::reserve_size;
 
+rocprofiler_status_t
+flush_impl(rocprofiler_buffer_id_t buffer_id, bool wait);
+
+// flushes the buffers with a flush interval once their oldest record has reached that age. The
+// thread only wakes up for the earliest deadline so buffers without records cost one wakeup per
+// interval and buffers without a flush interval cost nothing
+struct flush_timer
+{
+    flush_timer();
+    ~flush_timer() { stop(); }
+    flush_timer(const flush_timer&)     = delete;
+    flush_timer(flush_timer&&) noexcept = delete;
+    flush_timer& operator=(const flush_timer&) = delete;
+    flush_timer& operator=(flush_timer&&) noexcept = delete;
+
+    void add(rocprofiler_buffer_id_t);
+    void remove(rocprofiler_buffer_id_t);
+    void stop();
+
+    // fork handlers: the locks are held across fork() so the child inherits consistent state
+    void prepare_fork();
+    void parent_fork();
+    void child_fork();
+
+private:
+    void run();
+    void start();
+
+    std::mutex              m_flush_mutex = {};  // held while flushing, taken before m_mutex
+    std::mutex              m_mutex       = {};
+    std::condition_variable m_cv          = {};
+    std::vector<uint64_t>   m_buffers     = {};
+    bool                    m_updated     = false;  // buffers added since the deadline was computed
+    bool                    m_exit        = false;
+    std::thread             m_thread      = {};
+};
+
+flush_timer*
+get_flush_timer();
+
+flush_timer::flush_timer()
+{
+    // the timer thread does not exist in a forked child
+    ::pthread_atfork(
+        []() {
+            if(auto* _timer = get_flush_timer()) _timer->prepare_fork();
+        },
+        []() {
+            if(auto* _timer = get_flush_timer()) _timer->parent_fork();
+        },
+        []() {
+            if(auto* _timer = get_flush_timer()) _timer->child_fork();
+        });
+}
+
+void
+flush_timer::add(rocprofiler_buffer_id_t buffer_id)
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        if(m_exit) return;
+
+        m_buffers.emplace_back(buffer_id.handle);
+        m_updated = true;
+        if(!m_thread.joinable()) start();
+    }
+    // recompute the deadline
+    m_cv.notify_one();
+}
+
+// requires m_mutex
+void
+flush_timer::start()
+{
+    internal_threading::notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+    m_thread = std::thread{[this]() { run(); }};
+    internal_threading::notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+}
+
+void
+flush_timer::prepare_fork()
+{
+    m_flush_mutex.lock();
+    m_mutex.lock();
+}
+
+void
+flush_timer::parent_fork()
+{
+    m_mutex.unlock();
+    m_flush_mutex.unlock();
+}
+
+void
+flush_timer::child_fork()
+{
+    // only the forking thread exists in the child: the handle of the timer thread is abandoned
+    // (joining or destroying it would fail) and the synchronization primitives, which the timer
+    // thread may have been waiting on, are recreated in the unlocked state
+    new(&m_thread) std::thread{};
+    new(&m_cv) std::condition_variable{};
+    new(&m_mutex) std::mutex{};
+    new(&m_flush_mutex) std::mutex{};
+
+    m_updated = true;
+    if(!m_exit && !m_buffers.empty())
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        start();
+    }
+}
+
+void
+flush_timer::remove(rocprofiler_buffer_id_t buffer_id)
+{
+    // the timer holds the flush lock from reading the buffers until it is done flushing them so
+    // the buffer is not flushed after this returns
+    auto _flush_lk = std::unique_lock<std::mutex>{m_flush_mutex};
+    auto _lk       = std::unique_lock<std::mutex>{m_mutex};
+    m_buffers.erase(std::remove(m_buffers.begin(), m_buffers.end(), buffer_id.handle),
+                    m_buffers.end());
+}
+
+void
+flush_timer::stop()
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        m_exit   = true;
+    }
+    m_cv.notify_all();
+
+    if(m_thread.joinable()) m_thread.join();
+}
+
+void
+flush_timer::run()
+{
+    // a flush is not possible while the previous one is in progress so retry shortly after
+    constexpr uint64_t busy_retry_interval =
+        std::chrono::nanoseconds{std::chrono::milliseconds{1}}.count();
+
+    auto _lk = std::unique_lock<std::mutex>{m_mutex, std::defer_lock};
+    while(true)
+    {
+        auto _now  = uint64_t{0};
+        auto _next = std::numeric_limits<uint64_t>::max();
+        {
+            auto _flush_lk = std::unique_lock<std::mutex>{m_flush_mutex};
+
+            // collect the expired buffers. They are flushed without holding m_mutex so that a
+            // buffer callback can create or destroy a buffer
+            auto _expired = std::vector<instance*>{};
+            _lk.lock();
+            if(m_exit) return;
+
+            m_updated = false;
+            _now      = common::timestamp_ns();
+            for(auto itr : m_buffers)
+            {
+                auto* _buff = get_buffer(itr);
+                if(!_buff || _buff->flush_interval == 0) continue;
+
+                // when the buffer is empty, a record placed after now cannot expire before the
+                // deadline of a buffer which received a record now
+                auto _oldest   = _buff->oldest_record.load();
+                auto _deadline = ((_oldest == 0) ? _now : _oldest) + _buff->flush_interval;
+                if(_deadline <= _now)
+                    _expired.emplace_back(_buff);
+                else
+                    _next = std::min(_next, _deadline);
+            }
+            _lk.unlock();
+
+            for(auto* itr : _expired)
+            {
+                // finalization flushes the buffers itself. The flush below never waits, even if
+                // finalization starts in the meantime, since waiting may block on a buffer being
+                // destroyed
+                if(registration::get_fini_status() != 0) break;
+
+                flush_impl(rocprofiler_buffer_id_t{itr->buffer_id}, false);
+                auto _deadline = (itr->oldest_record.load() == 0)
+                                     ? _now + itr->flush_interval
+                                     : _now + std::min(itr->flush_interval, busy_retry_interval);
+                _next          = std::min(_next, _deadline);
+            }
+        }
+
+        _lk.lock();
+        if(m_exit) return;
+
+        if(!m_updated)
+        {
+            if(_next == std::numeric_limits<uint64_t>::max())
+                m_cv.wait(_lk);
+            else
+                m_cv.wait_for(_lk, std::chrono::nanoseconds{_next - _now});
+        }
+        _lk.unlock();
+    }
+}
+
+flush_timer*
+get_flush_timer()
+{
+    static auto*& _v = common::static_object<flush_timer>::construct();
+    return _v;
+}
+
 auto&
 get_buffers_mutex()
 {
@@ -67,8 +292,93 @@ get_buffer_offset()
     }();
     return _v;
 }
+
+int64_t
+get_agent_numa_node(const rocprofiler_agent_t* agent)
+{
+    // the KFD topology has one CPU node per NUMA node
+    if(agent->type == ROCPROFILER_AGENT_TYPE_CPU) return agent->logical_node_type_id;
+
+    // location_id is the PCI bus/device/function of the GPU
+    auto _path = fmt::format("/sys/bus/pci/devices/{:04x}:{:02x}:{:02x}.{:x}/numa_node",
+                             agent->domain,
+                             (agent->location_id >> 8) & 0xff,
+                             (agent->location_id >> 3) & 0x1f,
+                             agent->location_id & 0x7);
+
+    auto    _ifs  = std::ifstream{_path};
+    int64_t _node = -1;
+    if(!_ifs || !(_ifs >> _node))
+    {
+        ROCP_INFO << "unable to determine the NUMA node of agent " << agent->node_id << " from "
+                  << _path;
+        return -1;
+    }
+
+    // the kernel reports -1 when the device is not associated with a NUMA node
+    return _node;
+}
+
+// number of NUMA nodes the system may have, i.e. one more than the last node in
+// /sys/devices/system/node/possible (e.g. "0-3" or "0,2")
+int64_t
+get_possible_numa_node_count()
+{
+    static auto _v = []() -> int64_t {
+        auto _ifs  = std::ifstream{"/sys/devices/system/node/possible"};
+        auto _line = std::string{};
+        if(!_ifs || !std::getline(_ifs, _line) || _line.empty()) return 1;
+
+        auto    _pos  = _line.find_last_of("-,");
+        auto    _iss  = std::istringstream{(_pos == std::string::npos) ? _line
+                                                                       : _line.substr(_pos + 1)};
+        int64_t _last = 0;
+        if(!(_iss >> _last) || _last < 0) return 1;
+        return _last + 1;
+    }();
+    return _v;
+}
 }  // namespace
 
+rocprofiler_status_t
+get_buffer_options(const rocprofiler_buffer_properties_t& properties, instance::options_t& opts)
+{
+    constexpr uint64_t known_memory_flags = ROCPROFILER_BUFFER_MEMORY_HUGE_PAGES |
+                                            ROCPROFILER_BUFFER_MEMORY_TRANSPARENT_HUGE_PAGES |
+                                            ROCPROFILER_BUFFER_MEMORY_PREFAULT;
+
+    if(properties.size < sizeof(rocprofiler_buffer_properties_t))
+        return ROCPROFILER_STATUS_ERROR_INCOMPATIBLE_ABI;
+    if((properties.memory_flags & ~known_memory_flags) != 0)
+        return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    auto _has_flag = [&properties](rocprofiler_buffer_memory_flags_t flag) {
+        return (properties.memory_flags & flag) == flag;
+    };
+
+    opts                        = instance::options_t{};
+    opts.huge_pages             = _has_flag(ROCPROFILER_BUFFER_MEMORY_HUGE_PAGES);
+    opts.transparent_huge_pages = _has_flag(ROCPROFILER_BUFFER_MEMORY_TRANSPARENT_HUGE_PAGES);
+    opts.prefault               = _has_flag(ROCPROFILER_BUFFER_MEMORY_PREFAULT);
+    opts.numa_node              = properties.numa_node;
+
+    if(opts.numa_node >= get_possible_numa_node_count())
+    {
+        ROCP_ERROR << "buffer NUMA node " << opts.numa_node << " exceeds the "
+                   << get_possible_numa_node_count() << " possible NUMA node(s) of the system";
+        return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+
+    if(opts.numa_node < 0 && properties.numa_agent.handle != 0)
+    {
+        const auto* _agent = agent::get_agent(properties.numa_agent);
+        if(!_agent) return ROCPROFILER_STATUS_ERROR_AGENT_NOT_FOUND;
+        opts.numa_node = get_agent_numa_node(_agent);
+    }
+
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+
 bool
 is_valid_buffer_id(rocprofiler_buffer_id_t id)
 {
@@ -93,7 +403,7 @@ get_buffer(rocprofiler_buffer_id_t buffer_id)
     {
         for(auto& itr : *get_buffers())
         {
-            if(itr && itr->buffer_id == buffer_id.handle)
+            if(itr && itr->buffer_id == buffer_id.handle && !itr->destroyed.load())
             {
                 return itr.get();
             }
@@ -133,8 +443,45 @@ allocate_buffer()
     return rocprofiler_buffer_id_t{_idx};
 }
 
+std::optional<uint32_t>
+instance::try_begin_flush() const
+{
+    // completed never passes started so this only succeeds when they are equal, i.e. idle
+    auto _completed = flush_completed.load(std::memory_order_acquire);
+    auto _expected  = _completed;
+    if(!flush_started.compare_exchange_strong(_expected, _completed + 1)) return std::nullopt;
+    return _completed + 1;
+}
+
+void
+instance::end_flush(uint32_t seq) const
+{
+    flush_completed.store(seq);
+    // waiters increment the count before checking flush_completed in futex_wait so this cannot
+    // miss a waiter which is about to block
+    if(flush_waiters.load() > 0) common::futex_wake_all(flush_completed);
+}
+
+void
+instance::wait_for_flush(uint32_t seq) const
+{
+    while(true)
+    {
+        // sequence numbers wrap around
+        auto _completed = flush_completed.load();
+        if(static_cast<int32_t>(_completed - seq) >= 0) return;
+
+        ++flush_waiters;
+        common::futex_wait(flush_completed, _completed);
+        --flush_waiters;
+    }
+}
+
+namespace
+{
+// same as flush but wait is never forced, for the flushes issued by the library itself
 rocprofiler_status_t
-flush(rocprofiler_buffer_id_t buffer_id, bool wait)
+flush_impl(rocprofiler_buffer_id_t buffer_id, bool wait)
 {
     if(registration::get_fini_status() > 0)
     {
@@ -143,8 +490,6 @@ flush(rocprofiler_buffer_id_t buffer_id, bool wait)
         return ROCPROFILER_STATUS_ERROR_FINALIZED;
     }
 
-    if(registration::get_fini_status() < 0 && !wait) wait = true;
-
     auto offset = get_buffer_offset();
 
     if(!is_valid_buffer_id(buffer_id)) return ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND;
@@ -160,22 +505,37 @@ flush(rocprofiler_buffer_id_t buffer_id, bool wait)
         << "buffer (" << buffer_id.handle
         << ") flush request received after the task group for handling request was destroyed";
 
-    if(wait) task_group->wait();
-
     // buffer is currently being flushed or destroyed
-    if(buff->syncer.test_and_set())
+    auto seq = buff->try_begin_flush();
+    while(!seq)
     {
-        if(!wait) return ROCPROFILER_STATUS_ERROR_BUFFER_BUSY;
-        while(buff->syncer.test_and_set())
+        if(!wait)
         {
-            std::this_thread::yield();
-            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            // coalesce with the flush in progress: it re-flushes once after completing if the
+            // active buffer has reached the watermark in the meantime
+            buff->flush_pending.store(true);
+            return ROCPROFILER_STATUS_ERROR_BUFFER_BUSY;
         }
+
+        // wait for the flush in progress before starting another one
+        buff->wait_for_flush(buff->flush_started.load());
+        if(buff->destroyed.load()) return ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND;
+        seq = buff->try_begin_flush();
+    }
+
+    // destroyed between the lookup and claiming the flush
+    if(buff->destroyed.load())
+    {
+        buff->end_flush(*seq);
+        return ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND;
     }
 
+    // reset before switching buffers: a record placed in the flushed buffer in the meantime only
+    // makes the timer flush the next buffer early
+    buff->oldest_record.store(0);
     auto idx = buff->buffer_idx++;
 
-    auto _task = [buffer_id, idx, offset]() {
+    auto _task = [buffer_id, idx, offset, seq = *seq]() {
         ROCP_ERROR_IF(registration::get_fini_status() > 0)
             << "executing buffer (" << buffer_id.handle << ") flush task finalization!";
 
@@ -211,17 +571,54 @@ flush(rocprofiler_buffer_id_t buffer_id, bool wait)
             ROCP_INFO << "buffer at " << buffer_id.handle << " is empty...";
         }
 
-        buff_v->syncer.clear();
+        // flush requests received while flushing are coalesced into (at most) one more flush
+        auto _reflush = buff_v->flush_pending.exchange(false);
+        if(_reflush)
+        {
+            auto& _active = buff_v->get_internal_buffer();
+            _reflush      = (!_active.is_empty() && _active.count() >= buff_v->watermark);
+        }
+
+        // the buffer may be destroyed once the flush is marked as completed
+        buff_v->end_flush(seq);
+
+        // finalization flushes explicitly and waits so it is not done here
+        if(_reflush && registration::get_fini_status() == 0) flush_impl(buffer_id, false);
     };
 
     task_group->exec(std::move(_task));
-    if(wait)
-    {
-        task_group->join();
-    }
+    if(wait) buff->wait_for_flush(*seq);
 
     return ROCPROFILER_STATUS_SUCCESS;
 }
+}  // namespace
+
+rocprofiler_status_t
+flush(rocprofiler_buffer_id_t buffer_id, bool wait)
+{
+    // flushes requested during finalization complete before returning
+    if(registration::get_fini_status() < 0 && !wait) wait = true;
+
+    return flush_impl(buffer_id, wait);
+}
+
+void
+add_flush_timer(rocprofiler_buffer_id_t buffer_id)
+{
+    CHECK_NOTNULL(get_flush_timer())->add(buffer_id);
+}
+
+void
+remove_flush_timer(rocprofiler_buffer_id_t buffer_id)
+{
+    if(get_flush_timer()) get_flush_timer()->remove(buffer_id);
+}
+
+void
+finalize()
+{
+    if(get_flush_timer()) get_flush_timer()->stop();
+}
 }  // namespace buffer
 }  // namespace rocprofiler
 
@@ -234,10 +631,33 @@ rocprofiler_create_buffer(rocprofiler_context_id_t        context,
                           rocprofiler_buffer_tracing_cb_t callback,
                           void*                           callback_data,
                           rocprofiler_buffer_id_t*        buffer_id)
+{
+    auto properties      = rocprofiler_buffer_properties_t{};
+    properties.size      = sizeof(rocprofiler_buffer_properties_t);
+    properties.numa_node = -1;
+
+    return rocprofiler_create_buffer_with_properties(
+        context, size, watermark, action, callback, callback_data, properties, buffer_id);
+}
+
+rocprofiler_status_t
+rocprofiler_create_buffer_with_properties(rocprofiler_context_id_t        context,
+                                          size_t                          size,
+                                          size_t                          watermark,
+                                          rocprofiler_buffer_policy_t     action,
+                                          rocprofiler_buffer_tracing_cb_t callback,
+                                          void*                           callback_data,
+                                          rocprofiler_buffer_properties_t properties,
+                                          rocprofiler_buffer_id_t*        buffer_id)
 {
     if(rocprofiler::registration::get_init_status() > -1)
         return ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED;
 
+    auto opts = rocprofiler::buffer::instance::options_t{};
+    if(auto _status = rocprofiler::buffer::get_buffer_options(properties, opts);
+       _status != ROCPROFILER_STATUS_SUCCESS)
+        return _status;
+
     auto* existing_buff = rocprofiler::buffer::get_buffer(*buffer_id);
     if(existing_buff)
     {
@@ -255,16 +675,19 @@ rocprofiler_create_buffer(rocprofiler_context_id_t        context,
 
     // allocate the buffers. if it is lossless, we allocate a second buffer to store data while
     // other buffer is being flushed
-    buff->buffers.front().allocate(size);
-    if(action == ROCPROFILER_BUFFER_POLICY_LOSSLESS) buff->buffers.back().allocate(size);
+    buff->buffers.front().allocate(size, opts);
+    if(action == ROCPROFILER_BUFFER_POLICY_LOSSLESS) buff->buffers.back().allocate(size, opts);
+
+    buff->watermark      = watermark;
+    buff->flush_interval = properties.flush_interval_ns;
+    buff->policy         = action;
+    buff->callback       = callback;
+    buff->callback_data  = callback_data;
+    buff->context_id     = context.handle;
+    buff->buffer_id      = buffer_id->handle;
+    buff->buffer_idx     = 0;
 
-    buff->watermark     = watermark;
-    buff->policy        = action;
-    buff->callback      = callback;
-    buff->callback_data = callback_data;
-    buff->context_id    = context.handle;
-    buff->buffer_id     = buffer_id->handle;
-    buff->buffer_idx    = 0;
+    if(buff->flush_interval > 0) rocprofiler::buffer::add_flush_timer(*buffer_id);
 
     return ROCPROFILER_STATUS_SUCCESS;
 }
@@ -291,16 +714,30 @@ rocprofiler_destroy_buffer(rocprofiler_buffer_id_t buffer_id)
     auto* buffers = CHECK_NOTNULL(rocprofiler::buffer::get_buffers());
     auto& buff    = buffers->at(buffer_id.handle - offset);
 
-    if(!buff) return ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND;
+    if(!buff || buff->destroyed.load()) return ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND;
 
     // buffer is currently being flushed or destroyed
-    if(buff->syncer.test_and_set()) return ROCPROFILER_STATUS_ERROR_BUFFER_BUSY;
+    auto seq = buff->try_begin_flush();
+    if(!seq) return ROCPROFILER_STATUS_ERROR_BUFFER_BUSY;
+
+    // destroyed by another thread between the check above and claiming the flush
+    if(buff->destroyed.load())
+    {
+        buff->end_flush(*seq);
+        return ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND;
+    }
+
+    if(buff->flush_interval > 0) rocprofiler::buffer::remove_flush_timer(buffer_id);
 
     for(auto& itr : buff->buffers)
         itr.reset();
 
-    buff->syncer.clear();
-    buff.reset();
+    // the instance is not freed: threads blocked in flush() hold a pointer to it. Waking them
+    // after marking it destroyed makes them return ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND
+    buff->callback      = nullptr;
+    buff->callback_data = nullptr;
+    buff->destroyed.store(true);
+    buff->end_flush(*seq);
 
     return ROCPROFILER_STATUS_SUCCESS;
 }
@@ -28,6 +28,7 @@
 #include "lib/common/container/record_header_buffer.hpp"
 #include "lib/common/container/stable_vector.hpp"
 #include "lib/common/demangle.hpp"
+#include "lib/common/utility.hpp"
 
 #include <array>
 #include <atomic>
@@ -40,25 +41,62 @@ namespace buffer
 {
 struct instance
 {
-    using buffer_t = common::container::record_header_buffer;
-
-    mutable std::array<buffer_t, 2> buffers       = {};
-    mutable std::atomic_flag        syncer        = ATOMIC_FLAG_INIT;
-    mutable std::atomic<uint32_t>   buffer_idx    = {};  // array index
-    mutable std::atomic<uint64_t>   drop_count    = {};
-    uint64_t                        watermark     = 0;
-    uint64_t                        context_id    = 0;  // rocprofiler_context_id_t value
-    uint64_t                        buffer_id     = 0;  // rocprofiler_buffer_id_t value
-    uint64_t                        task_group_id = 0;  // thread-pool assignment
-    rocprofiler_buffer_tracing_cb_t callback      = nullptr;
-    void*                           callback_data = nullptr;
-    rocprofiler_buffer_policy_t     policy        = ROCPROFILER_BUFFER_POLICY_NONE;
+    using buffer_t  = common::container::record_header_buffer;
+    using options_t = common::container::ring_buffer_options;
+
+    mutable std::array<buffer_t, 2> buffers         = {};
+    mutable std::atomic<uint32_t>   buffer_idx      = {};  // array index
+    mutable std::atomic<uint64_t>   drop_count      = {};
+    mutable std::atomic<uint32_t>   flush_started   = {};  // sequence number of last flush started
+    mutable std::atomic<uint32_t>   flush_completed = {};  // sequence number of last flush done
+    mutable std::atomic<uint32_t>   flush_waiters   = {};  // threads blocked on flush_completed
+    mutable std::atomic<bool>       flush_pending   = {};  // flush requested during a flush
+    mutable std::atomic<bool>       destroyed       = {};  // released by rocprofiler_destroy_buffer
+    mutable std::atomic<uint64_t>   oldest_record   = {};  // timestamp of first record since flush
+    uint64_t                        watermark       = 0;
+    uint64_t                        flush_interval  = 0;  // max age (nsec) of records, 0 == none
+    uint64_t                        context_id      = 0;  // rocprofiler_context_id_t value
+    uint64_t                        buffer_id       = 0;  // rocprofiler_buffer_id_t value
+    uint64_t                        task_group_id   = 0;  // thread-pool assignment
+    rocprofiler_buffer_tracing_cb_t callback        = nullptr;
+    void*                           callback_data   = nullptr;
+    rocprofiler_buffer_policy_t     policy          = ROCPROFILER_BUFFER_POLICY_NONE;
 
     template <typename Tp>
     bool emplace(uint32_t, uint32_t, Tp&);
 
+    /// same as above but only the leading bytes of the (trivially copyable) record are placed in
+    /// the buffer, see record_header_buffer::emplace
+    template <typename Tp>
+    bool emplace(uint32_t, uint32_t, const Tp&, size_t);
+
+    /// construct N records in-place via the functor, see record_header_buffer::emplace_n.
+    /// Returns the number of records placed in the buffer (less than N if records were dropped)
+    template <typename Tp, typename FuncT>
+    size_t emplace_n(uint32_t, uint32_t, size_t, FuncT&&);
+
     buffer_t& get_internal_buffer();
     buffer_t& get_internal_buffer(size_t);
+
+    /// A buffer is being flushed (or destroyed) while flush_started != flush_completed. Returns
+    /// the sequence number of the new flush or std::nullopt if a flush is already in progress
+    std::optional<uint32_t> try_begin_flush() const;
+
+    /// marks the flush with the given sequence number as completed and wakes the waiting threads
+    void end_flush(uint32_t seq) const;
+
+    /// blocks until the flush with the given sequence number has completed
+    void wait_for_flush(uint32_t seq) const;
+
+    /// records the time of the first record placed since the last flush for the flush timer.
+    /// Only buffers with a flush interval pay for reading the clock
+    void update_oldest_record() const;
+
+private:
+    /// invokes the functor with the active internal buffer until the record of the given size is
+    /// placed or dropped according to the policy
+    template <typename Tp, typename FuncT>
+    bool emplace_record(size_t, FuncT&&);
 };
 
 using unique_buffer_vec_t = common::container::stable_vector<std::unique_ptr<instance>, 4>;
@@ -81,8 +119,26 @@ get_buffer(uint64_t buffer_idx);
 rocprofiler_status_t
 flush(rocprofiler_buffer_id_t buffer_id, bool wait);
 
+/// validate the buffer properties and convert them into the memory placement options of the
+/// internal buffers
+rocprofiler_status_t
+get_buffer_options(const rocprofiler_buffer_properties_t& properties, instance::options_t& opts);
+
 rocprofiler_status_t
 flush(uint64_t buffer_idx, bool wait);
+
+/// flush the buffer from an internal timer thread whenever its oldest record is older than the
+/// flush interval of the buffer. The timer thread is started by the first buffer added
+void
+add_flush_timer(rocprofiler_buffer_id_t buffer_id);
+
+/// stop flushing the buffer from the timer thread
+void
+remove_flush_timer(rocprofiler_buffer_id_t buffer_id);
+
+/// stops the timer thread
+void
+finalize();
 }  // namespace buffer
 }  // namespace rocprofiler
 
@@ -111,23 +167,53 @@ rocprofiler::buffer::flush(uint64_t buffer_idx, bool wait)
     return flush(rocprofiler_buffer_id_t{buffer_idx}, wait);
 }
 
+inline void
+rocprofiler::buffer::instance::update_oldest_record() const
+{
+    if(flush_interval == 0 || oldest_record.load(std::memory_order_relaxed) != 0) return;
+
+    auto _expected = uint64_t{0};
+    oldest_record.compare_exchange_strong(_expected, common::timestamp_ns());
+}
+
 template <typename Tp>
 inline bool
 rocprofiler::buffer::instance::emplace(uint32_t category, uint32_t kind, Tp& value)
+{
+    return emplace_record<Tp>(sizeof(Tp), [category, kind, &value](buffer_t& _buffer) {
+        return _buffer.emplace(category, kind, value);
+    });
+}
+
+template <typename Tp>
+inline bool
+rocprofiler::buffer::instance::emplace(uint32_t  category,
+                                       uint32_t  kind,
+                                       const Tp& value,
+                                       size_t    num_bytes)
+{
+    return emplace_record<Tp>(num_bytes, [category, kind, &value, num_bytes](buffer_t& _buffer) {
+        return _buffer.emplace(category, kind, value, num_bytes);
+    });
+}
+
+template <typename Tp, typename FuncT>
+inline bool
+rocprofiler::buffer::instance::emplace_record(size_t num_bytes, FuncT&& place)
 {
     // get the index of the current buffer
     auto get_idx = [this]() { return buffer_idx.load(std::memory_order_acquire) % buffers.size(); };
 
     auto idx     = get_idx();
-    auto success = buffers.at(idx).emplace(category, kind, value);
+    auto success = place(buffers.at(idx));
     if(!success)
     {
-        if(buffers.at(idx).capacity() < sizeof(value))
+        if(buffers.at(idx).capacity() < num_bytes)
         {
             auto msg = std::stringstream{};
             msg << "buffer " << buffer_id << " to small (size=" << buffers.at(idx).capacity()
-                << ") to hold an object of type " << common::cxx_demangle(typeid(value).name())
-                << " with size " << sizeof(value);
+                << ") to hold an object of type " << common::cxx_demangle(typeid(Tp).name())
+                << " with size " << num_bytes;
             throw std::runtime_error(msg.str());
         }
 
@@ -138,7 +224,7 @@ rocprofiler::buffer::instance::emplace(uint32_t category, uint32_t kind, Tp& val
             {
                 buffer::flush(buffer_id, true);
                 idx     = get_idx();
-                success = buffers.at(idx).emplace(category, kind, value);
+                success = place(buffers.at(idx));
             } while(!success);
         }
         else
@@ -147,6 +233,8 @@ rocprofiler::buffer::instance::emplace(uint32_t category, uint32_t kind, Tp& val
         }
     }
 
+    if(success) update_oldest_record();
+
     if(buffers.at(idx).count() >= watermark)
     {
         // flush without syncing
@@ -155,3 +243,53 @@ rocprofiler::buffer::instance::emplace(uint32_t category, uint32_t kind, Tp& val
 
     return success;
 }
+
+template <typename Tp, typename FuncT>
+inline size_t
+rocprofiler::buffer::instance::emplace_n(uint32_t category,
+                                         uint32_t kind,
+                                         size_t   num,
+                                         FuncT&&  func)
+{
+    // get the index of the current buffer
+    auto get_idx = [this]() { return buffer_idx.load(std::memory_order_acquire) % buffers.size(); };
+
+    size_t placed = 0;
+    while(placed < num)
+    {
+        auto idx = get_idx();
+        auto n   = buffers.at(idx).template emplace_n<Tp>(category, kind, num - placed, func);
+        if(n == 0)
+        {
+            if(buffers.at(idx).capacity() < sizeof(Tp))
+            {
+                auto msg = std::stringstream{};
+                msg << "buffer " << buffer_id << " to small (size=" << buffers.at(idx).capacity()
+                    << ") to hold an object of type " << common::cxx_demangle(typeid(Tp).name())
+                    << " with size " << sizeof(Tp);
+                throw std::runtime_error(msg.str());
+            }
+
+            if(policy == ROCPROFILER_BUFFER_POLICY_LOSSLESS)
+            {
+                // blocks until buffer is flushed
+                buffer::flush(buffer_id, true);
+                continue;
+            }
+
+            drop_count += (num - placed);
+            break;
+        }
+
+        placed += n;
+        update_oldest_record();
+
+        if(buffers.at(idx).count() >= watermark)
+        {
+            // flush without syncing
+            buffer::flush(buffer_id, false);
+        }
+    }
+
+    return placed;
+}
@@ -27,6 +27,8 @@
 #include <rocprofiler-sdk/rocprofiler.h>
 
 #include "lib/common/logging.hpp"
+#include "lib/common/stringize_arg.hpp"
+#include "lib/common/utility.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
 #include "lib/rocprofiler-sdk/context/domain.hpp"
 #include "lib/rocprofiler-sdk/hip/hip.hpp"
@@ -38,7 +40,10 @@
 #include "lib/rocprofiler-sdk/page_migration/page_migration.hpp"
 #include "lib/rocprofiler-sdk/registration.hpp"
 
+#include <algorithm>
 #include <atomic>
+#include <cstddef>
+#include <cstring>
 #include <limits>
 #include <stdexcept>
 #include <string_view>
@@ -92,6 +97,132 @@ get_kind_name(rocprofiler_buffer_tracing_kind_t kind, std::index_sequence<Idx, T
     if constexpr(sizeof...(Tail) > 0) return get_kind_name(kind, std::index_sequence<Tail...>{});
     return {nullptr, 0};
 }
+
+bool
+is_api_tracing_kind(rocprofiler_buffer_tracing_kind_t kind)
+{
+    switch(kind)
+    {
+        case ROCPROFILER_BUFFER_TRACING_HSA_CORE_API:
+        case ROCPROFILER_BUFFER_TRACING_HSA_AMD_EXT_API:
+        case ROCPROFILER_BUFFER_TRACING_HSA_IMAGE_EXT_API:
+        case ROCPROFILER_BUFFER_TRACING_HSA_FINALIZE_EXT_API:
+        case ROCPROFILER_BUFFER_TRACING_HIP_RUNTIME_API:
+        case ROCPROFILER_BUFFER_TRACING_HIP_COMPILER_API: return true;
+        default: break;
+    }
+    return false;
+}
+
+// forwards the arguments stringized for the callback tracing kind to the buffer tracing callback
+struct record_args_data
+{
+    rocprofiler_buffer_tracing_kind_t              kind      = ROCPROFILER_BUFFER_TRACING_NONE;
+    rocprofiler_buffer_tracing_operation_args_cb_t callback  = nullptr;
+    void*                                          user_data = nullptr;
+};
+
+int
+record_args_callback(rocprofiler_callback_tracing_kind_t /*kind*/,
+                     rocprofiler_tracing_operation_t operation,
+                     uint32_t                        arg_number,
+                     const void* const               arg_value_addr,
+                     int32_t                         arg_indirection_count,
+                     const char*                     arg_type,
+                     const char*                     arg_name,
+                     const char*                     arg_value_str,
+                     int32_t                         arg_dereference_count,
+                     void*                           data)
+{
+    auto* _data = static_cast<record_args_data*>(data);
+    return _data->callback(_data->kind,
+                           operation,
+                           arg_number,
+                           arg_value_addr,
+                           arg_indirection_count,
+                           arg_type,
+                           arg_name,
+                           arg_value_str,
+                           arg_dereference_count,
+                           _data->user_data);
+}
+
+template <typename RecordT, typename ApiDataT, typename FuncT>
+rocprofiler_status_t
+iterate_record_args(const rocprofiler_record_header_t& header,
+                    record_args_data&                  data,
+                    FuncT&&                            iterate_args)
+{
+    constexpr auto args_offset = offsetof(RecordT, args);
+
+    // the records only hold the member of the args union used by the operation
+    const auto* record = static_cast<const RecordT*>(header.payload);
+    if(!record || record->size <= args_offset) return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    auto api_data   = common::init_public_api_struct(ApiDataT{});
+    api_data.retval = record->retval;
+    std::memcpy(&api_data.args,
+                &record->args,
+                std::min<size_t>(record->size - args_offset, sizeof(api_data.args)));
+
+    // the memory of the application may no longer be valid: never read pointers or strings
+    iterate_args(
+        record->operation, api_data, record_args_callback, common::address_only_deref, &data);
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+
+template <size_t TableIdx>
+rocprofiler_status_t
+iterate_hsa_record_args(const rocprofiler_record_header_t& header, record_args_data& data)
+{
+    return iterate_record_args<rocprofiler_buffer_tracing_hsa_api_ext_record_t,
+                               rocprofiler_callback_tracing_hsa_api_data_t>(
+        header, data, hsa::iterate_args<TableIdx>);
+}
+
+template <size_t TableIdx>
+rocprofiler_status_t
+iterate_hip_record_args(const rocprofiler_record_header_t& header, record_args_data& data)
+{
+    return iterate_record_args<rocprofiler_buffer_tracing_hip_api_ext_record_t,
+                               rocprofiler_callback_tracing_hip_api_data_t>(
+        header, data, hip::iterate_args<TableIdx>);
+}
+
+rocprofiler_status_t
+iterate_record_args(const rocprofiler_record_header_t& header, record_args_data& data)
+{
+    switch(data.kind)
+    {
+        case ROCPROFILER_BUFFER_TRACING_HSA_CORE_API:
+        {
+            return iterate_hsa_record_args<ROCPROFILER_HSA_TABLE_ID_Core>(header, data);
+        }
+        case ROCPROFILER_BUFFER_TRACING_HSA_AMD_EXT_API:
+        {
+            return iterate_hsa_record_args<ROCPROFILER_HSA_TABLE_ID_AmdExt>(header, data);
+        }
+        case ROCPROFILER_BUFFER_TRACING_HSA_IMAGE_EXT_API:
+        {
+            return iterate_hsa_record_args<ROCPROFILER_HSA_TABLE_ID_ImageExt>(header, data);
+        }
+        case ROCPROFILER_BUFFER_TRACING_HSA_FINALIZE_EXT_API:
+        {
+            return iterate_hsa_record_args<ROCPROFILER_HSA_TABLE_ID_FinalizeExt>(header, data);
+        }
+        case ROCPROFILER_BUFFER_TRACING_HIP_RUNTIME_API:
+        {
+            return iterate_hip_record_args<ROCPROFILER_HIP_TABLE_ID_Runtime>(header, data);
+        }
+        case ROCPROFILER_BUFFER_TRACING_HIP_COMPILER_API:
+        {
+            return iterate_hip_record_args<ROCPROFILER_HIP_TABLE_ID_Compiler>(header, data);
+        }
+        default: break;
+    }
+
+    return ROCPROFILER_STATUS_ERROR_KIND_NOT_FOUND;
+}
 }  // namespace
 }  // namespace buffer_tracing
 }  // namespace rocprofiler
@@ -144,6 +275,53 @@ rocprofiler_configure_buffer_tracing_service(rocprofiler_context_id_t
     return ROCPROFILER_STATUS_SUCCESS;
 }
 
+rocprofiler_status_t
+rocprofiler_configure_buffer_tracing_api_args(rocprofiler_context_id_t          context_id,
+                                              rocprofiler_buffer_tracing_kind_t kind)
+{
+    if(rocprofiler::registration::get_init_status() > -1)
+        return ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED;
+
+    if(!rocprofiler::buffer_tracing::is_api_tracing_kind(kind))
+        return ROCPROFILER_STATUS_ERROR_KIND_NOT_FOUND;
+
+    auto* ctx = rocprofiler::context::get_mutable_registered_context(context_id);
+
+    if(!ctx) return ROCPROFILER_STATUS_ERROR_CONTEXT_NOT_FOUND;
+
+    if(!ctx->buffered_tracer || !ctx->buffered_tracer->domains(kind))
+        return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    ctx->buffered_tracer->api_args.at(kind) = true;
+
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+
+rocprofiler_status_t
+rocprofiler_iterate_buffer_tracing_record_args(
+    rocprofiler_record_header_t                    header,
+    rocprofiler_buffer_tracing_operation_args_cb_t callback,
+    void*                                          user_data)
+{
+    auto kind = static_cast<rocprofiler_buffer_tracing_kind_t>(header.kind);
+    if(header.category != ROCPROFILER_BUFFER_CATEGORY_TRACING ||
+       !rocprofiler::buffer_tracing::is_api_tracing_kind(kind))
+        return ROCPROFILER_STATUS_ERROR_KIND_NOT_FOUND;
+
+    auto _data = rocprofiler::buffer_tracing::record_args_data{kind, callback, user_data};
+    return rocprofiler::buffer_tracing::iterate_record_args(header, _data);
+}
+
+rocprofiler_status_t
+rocprofiler_query_buffer_tracing_marker_message(uint64_t message_id, const char** message)
+{
+    const auto* _message = rocprofiler::marker::get_message(message_id);
+    if(!_message) return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    *message = _message->c_str();
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+
 rocprofiler_status_t
 rocprofiler_query_buffer_tracing_kind_name(rocprofiler_buffer_tracing_kind_t kind,
                                            const char**                      name,
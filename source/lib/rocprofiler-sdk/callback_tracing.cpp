@@ -38,6 +38,7 @@
 #include "lib/rocprofiler-sdk/marker/marker.hpp"
 #include "lib/rocprofiler-sdk/registration.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <vector>
@@ -351,6 +352,9 @@ rocprofiler_iterate_callback_tracing_kind_operation_args(
     int32_t                                          max_deref,
     void*                                            user_data)
 {
+    // negative values are reserved for formatting the arguments without reading their memory
+    max_deref = std::max(max_deref, 0);
+
     if(max_deref > 1 && record.phase == ROCPROFILER_CALLBACK_PHASE_ENTER)
     {
         const char* name = "(unknown)";
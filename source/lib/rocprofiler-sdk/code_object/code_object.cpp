@@ -45,6 +45,7 @@
 #include <cstdlib>
 #include <regex>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -388,6 +389,136 @@ get_kernel_object_map()
     return _v;
 }
 
+// Immutable copy of the kernel object map which is read on every intercepted dispatch. A new copy
+// is published whenever executables are frozen or destroyed, so lookups never take a lock. Every
+// reading thread owns a slot where it announces the copy it is using (a hazard pointer), so a
+// lookup only stores to its own cache line. After swapping in a new copy, the publisher waits
+// until no slot holds the old copy before deleting it.
+class kernel_object_snapshot
+{
+public:
+    uint64_t lookup(uint64_t kernel_object) const;
+
+    // publishers must be serialized by the caller
+    void publish(kernel_object_map_t&& data);
+
+private:
+    // slots are never freed: a thread releases its slot when it exits and another thread may
+    // reuse it
+    struct alignas(64) reader_slot
+    {
+        std::atomic<const kernel_object_map_t*> hazard = {nullptr};
+        std::atomic<bool>                       in_use = {false};
+        reader_slot*                            next   = nullptr;
+    };
+
+    struct thread_slot
+    {
+        ~thread_slot()
+        {
+            if(slot) slot->in_use.store(false, std::memory_order_release);
+        }
+
+        const kernel_object_snapshot* owner = nullptr;
+        reader_slot*                  slot  = nullptr;
+    };
+
+    reader_slot* acquire_slot() const;
+
+    std::atomic<const kernel_object_map_t*> m_current = {nullptr};
+    mutable std::atomic<reader_slot*>       m_slots   = {nullptr};
+};
+
+kernel_object_snapshot::reader_slot*
+kernel_object_snapshot::acquire_slot() const
+{
+    for(auto* itr = m_slots.load(std::memory_order_acquire); itr; itr = itr->next)
+    {
+        auto _in_use = false;
+        if(itr->in_use.compare_exchange_strong(_in_use, true, std::memory_order_acquire))
+            return itr;
+    }
+
+    auto* _slot = new reader_slot{};
+    _slot->in_use.store(true, std::memory_order_relaxed);
+    _slot->next = m_slots.load(std::memory_order_relaxed);
+    while(!m_slots.compare_exchange_weak(
+        _slot->next, _slot, std::memory_order_release, std::memory_order_relaxed))
+    {}
+    return _slot;
+}
+
+uint64_t
+kernel_object_snapshot::lookup(uint64_t kernel_object) const
+{
+    static thread_local auto _thread_slot = thread_slot{};
+    if(_thread_slot.owner != this)
+    {
+        if(_thread_slot.slot) _thread_slot.slot->in_use.store(false, std::memory_order_release);
+        _thread_slot.owner = this;
+        _thread_slot.slot  = acquire_slot();
+    }
+
+    // announce the copy before using it and check that it was not replaced in the meantime,
+    // otherwise the publisher may have missed the announcement
+    auto&       _hazard = _thread_slot.slot->hazard;
+    const auto* _data   = m_current.load(std::memory_order_acquire);
+    while(true)
+    {
+        _hazard.store(_data, std::memory_order_seq_cst);
+        const auto* _check = m_current.load(std::memory_order_seq_cst);
+        if(_check == _data) break;
+        _data = _check;
+    }
+
+    auto _kern_id = uint64_t{0};
+    if(_data)
+    {
+        auto itr = _data->find(kernel_object);
+        if(itr != _data->end()) _kern_id = itr->second;
+    }
+
+    _hazard.store(nullptr, std::memory_order_release);
+    return _kern_id;
+}
+
+void
+kernel_object_snapshot::publish(kernel_object_map_t&& data)
+{
+    const auto* _prev = m_current.exchange(new kernel_object_map_t{std::move(data)},
+                                           std::memory_order_seq_cst);
+    if(!_prev) return;
+
+    // a lookup which announced the old copy before the swap may still be using it. Lookups
+    // announcing it after the swap see the new copy when checking and do not use the old one
+    for(auto* itr = m_slots.load(std::memory_order_seq_cst); itr; itr = itr->next)
+    {
+        while(itr->hazard.load(std::memory_order_seq_cst) == _prev)
+            std::this_thread::yield();
+    }
+
+    delete _prev;
+}
+
+auto*
+get_kernel_object_snapshot()
+{
+    static auto*& _v = common::static_object<kernel_object_snapshot>::construct();
+    return _v;
+}
+
+// copy the kernel object map into a new snapshot for the dispatch path
+void
+publish_kernel_object_map()
+{
+    if(!get_kernel_object_map() || !get_kernel_object_snapshot()) return;
+
+    // hold the write lock so that publishing is serialized
+    get_kernel_object_map()->wlock([](kernel_object_map_t& data) {
+        get_kernel_object_snapshot()->publish(kernel_object_map_t{data});
+    });
+}
+
 hsa_status_t
 executable_iterate_agent_symbols_load_callback(hsa_executable_t        executable,
                                                hsa_agent_t             agent,
@@ -741,6 +872,8 @@ executable_freeze(hsa_executable_t executable, const char* options)
             executable, code_object_load_callback, &_vec);
     });
 
+    publish_kernel_object_map();
+
     constexpr auto CODE_OBJECT_KIND = ROCPROFILER_CALLBACK_TRACING_CODE_OBJECT;
     constexpr auto CODE_OBJECT_LOAD = ROCPROFILER_CODE_OBJECT_LOAD;
     constexpr auto CODE_OBJECT_KERNEL_SYMBOL =
@@ -843,10 +976,12 @@ executable_destroy(hsa_executable_t executable)
             {
                 for(const auto& sitr : uitr.symbols)
                 {
-                    data.erase(sitr->rocp_data.kernel_id);
+                    data.erase(sitr->rocp_data.kernel_object);
                 }
             }
         });
+
+        publish_kernel_object_map();
     }
 
     if(get_code_objects())
@@ -983,13 +1118,7 @@ initialize(HsaApiTable* table)
 uint64_t
 get_kernel_id(uint64_t kernel_object)
 {
-    return CHECK_NOTNULL(get_kernel_object_map())
-        ->rlock(
-            [](const kernel_object_map_t& object_map, uint64_t _kern_obj) -> uint64_t {
-                auto itr = object_map.find(_kern_obj);
-                return (itr == object_map.end()) ? 0 : itr->second;
-            },
-            kernel_object);
+    return CHECK_NOTNULL(get_kernel_object_snapshot())->lookup(kernel_object);
 }
 
 void
@@ -33,6 +33,7 @@
 #include "lib/rocprofiler-sdk/counters/agent_profiling.hpp"
 #include "lib/rocprofiler-sdk/counters/core.hpp"
 #include "lib/rocprofiler-sdk/external_correlation.hpp"
+#include "lib/rocprofiler-sdk/kernel_dispatch/sampling_policy.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/types.hpp"
 #include "lib/rocprofiler-sdk/thread_trace/att_core.hpp"
 #include "rocprofiler-sdk/agent.h"
@@ -69,11 +70,13 @@ struct callback_tracing_service
 
 struct buffer_tracing_service
 {
-    using domain_t       = rocprofiler_buffer_tracing_kind_t;
-    using buffer_array_t = std::array<rocprofiler_buffer_id_t, domain_info<domain_t>::last>;
+    using domain_t         = rocprofiler_buffer_tracing_kind_t;
+    using buffer_array_t   = std::array<rocprofiler_buffer_id_t, domain_info<domain_t>::last>;
+    using api_args_array_t = std::array<bool, domain_info<domain_t>::last>;
 
     domain_context<domain_t> domains     = {};
     buffer_array_t           buffer_data = {};
+    api_args_array_t         api_args    = {};  // records carry the arguments of the API calls
 };
 
 struct dispatch_counter_collection_service
@@ -130,6 +133,8 @@ struct context
 
     std::unique_ptr<thread_trace::DispatchThreadTracer> dispatch_thread_trace = {};
     std::unique_ptr<thread_trace::AgentThreadTracer>    agent_thread_trace    = {};
+    // Filters the dispatches instrumented by counter collection and thread trace
+    std::unique_ptr<kernel_dispatch::sampling_policy> dispatch_sampling = {};
 };
 
 // set the client index needs to be called before allocate_context()
@@ -94,6 +94,11 @@ queue_cb(const context::context*                                         ctx,
         return no_instrumentation();
     }
 
+    if(ctx->dispatch_sampling && !ctx->dispatch_sampling->sample_dispatch(kernel_id, dispatch_id))
+    {
+        return no_instrumentation();
+    }
+
     auto _corr_id_v =
         rocprofiler_correlation_id_t{.internal = 0, .external = context::null_user_data};
     if(const auto* _corr_id = correlation_id)
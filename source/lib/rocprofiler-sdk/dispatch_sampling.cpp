@@ -0,0 +1,54 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/utility.hpp"
+#include "lib/rocprofiler-sdk/context/context.hpp"
+#include "lib/rocprofiler-sdk/kernel_dispatch/sampling_policy.hpp"
+#include "lib/rocprofiler-sdk/registration.hpp"
+
+#include <rocprofiler-sdk/rocprofiler.h>
+
+#include <memory>
+
+extern "C" {
+rocprofiler_status_t
+rocprofiler_configure_dispatch_sampling_policy(rocprofiler_context_id_t               context_id,
+                                               rocprofiler_dispatch_sampling_policy_t policy)
+{
+    using sampling_policy = rocprofiler::kernel_dispatch::sampling_policy;
+
+    if(rocprofiler::registration::get_init_status() > -1)
+        return ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED;
+
+    auto* ctx = rocprofiler::context::get_mutable_registered_context(context_id);
+    if(!ctx) return ROCPROFILER_STATUS_ERROR_CONTEXT_NOT_FOUND;
+    if(ctx->dispatch_sampling) return ROCPROFILER_STATUS_ERROR_SERVICE_ALREADY_CONFIGURED;
+
+    if(policy.size < sizeof(rocprofiler_dispatch_sampling_policy_t))
+        return ROCPROFILER_STATUS_ERROR_INCOMPATIBLE_ABI;
+    if(!sampling_policy::is_valid(policy)) return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    ctx->dispatch_sampling =
+        std::make_unique<sampling_policy>(policy, rocprofiler::common::timestamp_ns());
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+}
@@ -36,10 +36,11 @@ namespace hip
 template <>
 struct hip_domain_info<ROCPROFILER_HIP_TABLE_ID_LAST>
 {
-    using args_type          = rocprofiler_hip_api_args_t;
-    using retval_type        = rocprofiler_hip_api_retval_t;
-    using callback_data_type = rocprofiler_callback_tracing_hip_api_data_t;
-    using buffered_data_type = rocprofiler_buffer_tracing_hip_api_record_t;
+    using args_type               = rocprofiler_hip_api_args_t;
+    using retval_type             = rocprofiler_hip_api_retval_t;
+    using callback_data_type      = rocprofiler_callback_tracing_hip_api_data_t;
+    using buffered_data_type      = rocprofiler_buffer_tracing_hip_api_record_t;
+    using buffered_args_data_type = rocprofiler_buffer_tracing_hip_api_ext_record_t;
 };
 
 template <>
@@ -71,6 +71,31 @@ stringize(int32_t max_deref, Args... args)
     return array_type{common::stringize_arg(
         max_deref, args, [](const auto& _v) { return stringize_impl(_v); })...};
 }
+
+template <typename Tp>
+void
+format_impl(common::format_buffer& _buf, const Tp& _v)
+{
+    using value_type = std::decay_t<Tp>;
+
+    if constexpr(fmt::is_formattable<value_type>::value && !std::is_pointer<value_type>::value)
+    {
+        _buf.format("{}", _v);
+    }
+    else
+    {
+        _buf.stream() << _v;
+    }
+}
+
+template <typename... Args>
+auto
+format(common::format_buffer& _buf, int32_t max_deref, Args... args)
+{
+    using array_type = common::formatted_argument_array_t<sizeof...(Args)>;
+    return array_type{common::format_arg(
+        _buf, max_deref, args, [](auto& _b, const auto& _v) { format_impl(_b, _v); })...};
+}
 }  // namespace utils
 }  // namespace hip
 }  // namespace rocprofiler
@@ -21,6 +21,7 @@
 // THE SOFTWARE.
 
 #include "lib/rocprofiler-sdk/hsa/async_copy.hpp"
+#include "lib/common/environment.hpp"
 #include "lib/common/logging.hpp"
 #include "lib/common/scope_destructor.hpp"
 #include "lib/common/static_object.hpp"
@@ -28,6 +29,7 @@
 #include "lib/rocprofiler-sdk/agent.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
 #include "lib/rocprofiler-sdk/hsa/hsa.hpp"
+#include "lib/rocprofiler-sdk/internal_threading.hpp"
 #include "lib/rocprofiler-sdk/kernel_dispatch/profiling_time.hpp"
 #include "lib/rocprofiler-sdk/registration.hpp"
 #include "lib/rocprofiler-sdk/tracing/fwd.hpp"
@@ -43,9 +45,15 @@
 #include <hsa/amd_hsa_signal.h>
 #include <hsa/hsa.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <type_traits>
+#include <vector>
 
 #define ROCPROFILER_LIB_ROCPROFILER_HSA_ASYNC_COPY_CPP_IMPL 1
 
@@ -307,6 +315,124 @@ get_active_signals()
     return _v;
 }
 
+// recycles the async_copy_data instances along with their HSA signal: allocating the data and
+// creating a signal for every copy is significant for workloads issuing many small copies
+struct async_copy_pool
+{
+    static constexpr size_t max_size = 1024;
+
+    async_copy_pool()                           = default;
+    ~async_copy_pool()                          = default;
+    async_copy_pool(const async_copy_pool&)     = delete;
+    async_copy_pool(async_copy_pool&&) noexcept = delete;
+    async_copy_pool& operator=(const async_copy_pool&) = delete;
+    async_copy_pool& operator=(async_copy_pool&&) noexcept = delete;
+
+    async_copy_data* acquire(hsa_signal_value_t v);  // nullptr if the signal creation failed
+    void             release(async_copy_data* _data);
+    void             clear();  // destroy the pooled signals
+
+private:
+    std::mutex                    m_mutex = {};
+    std::vector<async_copy_data*> m_free  = {};
+};
+
+void
+destroy_async_copy_data(async_copy_data* _data)
+{
+    // function pointer may be null during unit testing
+    if(hsa::get_hsa_ref_count() > 0 && get_core_table()->hsa_signal_destroy_fn)
+    {
+        ROCP_HSA_TABLE_CALL(ERROR, get_core_table()->hsa_signal_destroy_fn(_data->rocp_signal));
+    }
+    delete _data;
+}
+
+async_copy_data*
+async_copy_pool::acquire(hsa_signal_value_t v)
+{
+    async_copy_data* _data = nullptr;
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        if(!m_free.empty())
+        {
+            _data = m_free.back();
+            m_free.pop_back();
+        }
+    }
+
+    if(_data)
+    {
+        get_core_table()->hsa_signal_store_relaxed_fn(_data->rocp_signal, v);
+        return _data;
+    }
+
+    const uint32_t     num_consumers = 0;
+    const hsa_agent_t* consumers     = nullptr;
+
+    _data        = new async_copy_data{};
+    auto _status = get_core_table()->hsa_signal_create_fn(
+        v, num_consumers, consumers, &_data->rocp_signal);
+
+    if(_status != HSA_STATUS_SUCCESS)
+    {
+        ROCP_ERROR << "hsa_signal_create returned non-zero error code " << _status;
+        delete _data;
+        return nullptr;
+    }
+
+    return _data;
+}
+
+void
+async_copy_pool::release(async_copy_data* _data)
+{
+    // reset everything but the signal
+    auto _signal       = _data->rocp_signal;
+    *_data             = async_copy_data{};
+    _data->rocp_signal = _signal;
+
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        if(m_free.size() < max_size)
+        {
+            m_free.emplace_back(_data);
+            return;
+        }
+    }
+
+    destroy_async_copy_data(_data);
+}
+
+void
+async_copy_pool::clear()
+{
+    auto _free = std::vector<async_copy_data*>{};
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        std::swap(_free, m_free);
+    }
+
+    for(auto* itr : _free)
+        destroy_async_copy_data(itr);
+}
+
+async_copy_pool*
+get_async_copy_pool()
+{
+    static auto*& _v = common::static_object<async_copy_pool>::construct();
+    return _v;
+}
+
+void
+release_async_copy_data(async_copy_data* _data)
+{
+    if(get_async_copy_pool())
+        get_async_copy_pool()->release(_data);
+    else
+        destroy_async_copy_data(_data);
+}
+
 template <typename Tp, typename Up>
 constexpr Tp*
 convert_hsa_handle(Up _hsa_object)
@@ -341,23 +467,16 @@ operator*=(hsa_amd_profiling_async_copy_time_t& lhs, uint64_t rhs)
     return lhs;
 }
 
-bool
-async_copy_handler(hsa_signal_value_t signal_value, void* arg)
+// reports the copy to the tools, signals the original completion signal of the application and
+// returns the data (and its signal) to the pool
+void
+complete_async_copy(async_copy_data* _data, hsa_signal_value_t signal_value)
 {
-    // if we have fully finalized, delete the data and return
-    if(registration::get_fini_status() > 0)
-    {
-        auto* _data = static_cast<async_copy_data*>(arg);
-        delete _data;
-        return false;
-    }
-
     static auto sysclock_period = hsa::get_hsa_timestamp_period();
 
-    auto  ts               = common::timestamp_ns();
-    auto* _data            = static_cast<async_copy_data*>(arg);
-    auto  copy_time        = hsa_amd_profiling_async_copy_time_t{};
-    auto  copy_time_status = get_amd_ext_table()->hsa_amd_profiling_get_async_copy_time_fn(
+    auto ts               = common::timestamp_ns();
+    auto copy_time        = hsa_amd_profiling_async_copy_time_t{};
+    auto copy_time_status = get_amd_ext_table()->hsa_amd_profiling_get_async_copy_time_fn(
         _data->rocp_signal, &copy_time);
 
     // normalize
@@ -432,14 +551,184 @@ async_copy_handler(hsa_signal_value_t signal_value, void* arg)
         get_core_table()->hsa_signal_store_screlease_fn(_data->orig_signal, signal_value);
     }
 
-    ROCP_HSA_TABLE_CALL(ERROR, get_core_table()->hsa_signal_destroy_fn(_data->rocp_signal));
-    delete _data;
+    release_async_copy_data(_data);
 
     if(_corr_id) _corr_id->sub_ref_count();
+}
+
+bool
+async_copy_handler(hsa_signal_value_t signal_value, void* arg)
+{
+    auto* _data = static_cast<async_copy_data*>(arg);
+
+    // if we have fully finalized, release the data and return
+    if(registration::get_fini_status() > 0)
+    {
+        release_async_copy_data(_data);
+        return false;
+    }
+
+    complete_async_copy(_data, signal_value);
 
     return false;
 }
 
+// completes the copies from one internal thread instead of registering an async handler with HSA
+// for every copy: the thread waits on the signals of every outstanding copy at once and then
+// completes every copy which has finished in a single pass. Enabled via
+// ROCPROFILER_ASYNC_COPY_BATCHED_COMPLETION
+struct completion_ring
+{
+    completion_ring();
+    ~completion_ring() { stop(); }
+    completion_ring(const completion_ring&)     = delete;
+    completion_ring(completion_ring&&) noexcept = delete;
+    completion_ring& operator=(const completion_ring&) = delete;
+    completion_ring& operator=(completion_ring&&) noexcept = delete;
+
+    void push(async_copy_data* _data);
+    void stop();  // returns once every outstanding copy has completed (or timed out)
+
+private:
+    void run();
+    void wakeup();
+
+    std::mutex                    m_mutex   = {};
+    std::vector<async_copy_data*> m_pending = {};
+    bool                          m_exit    = false;
+    hsa_signal_t                  m_wakeup  = {.handle = 0};  // dropped below 1 by push and stop
+    std::thread                   m_thread  = {};
+};
+
+completion_ring::completion_ring()
+{
+    ROCP_HSA_TABLE_CALL(FATAL, get_core_table()->hsa_signal_create_fn(1, 0, nullptr, &m_wakeup));
+
+    internal_threading::notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+    m_thread = std::thread{[this]() { run(); }};
+    internal_threading::notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+}
+
+void
+completion_ring::wakeup()
+{
+    get_core_table()->hsa_signal_store_screlease_fn(m_wakeup, 0);
+}
+
+void
+completion_ring::push(async_copy_data* _data)
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        m_pending.emplace_back(_data);
+    }
+    wakeup();
+}
+
+void
+completion_ring::stop()
+{
+    {
+        auto _lk = std::unique_lock<std::mutex>{m_mutex};
+        if(m_exit) return;
+        m_exit = true;
+    }
+
+    if(m_thread.joinable())
+    {
+        wakeup();
+        m_thread.join();
+    }
+
+    if(m_wakeup.handle != 0 && hsa::get_hsa_ref_count() > 0)
+    {
+        ROCP_HSA_TABLE_CALL(ERROR, get_core_table()->hsa_signal_destroy_fn(m_wakeup));
+        m_wakeup.handle = 0;
+    }
+}
+
+void
+completion_ring::run()
+{
+    // once stopped, wait a maximum of thirty seconds for the outstanding copies
+    constexpr auto drain_timeout = std::chrono::seconds{30};
+
+    auto _is_complete = [](async_copy_data* _data) {
+        auto _value = get_core_table()->hsa_signal_load_scacquire_fn(_data->rocp_signal);
+        if(_value >= 1) return false;
+        complete_async_copy(_data, _value);
+        return true;
+    };
+
+    auto _outstanding = std::vector<async_copy_data*>{};
+    auto _signals     = std::vector<hsa_signal_t>{};
+    auto _conds       = std::vector<hsa_signal_condition_t>{};
+    auto _values      = std::vector<hsa_signal_value_t>{};
+    auto _deadline    = std::optional<std::chrono::steady_clock::time_point>{};
+    while(true)
+    {
+        // re-arm before collecting the pending copies so that a push after this point wakes the
+        // wait below
+        get_core_table()->hsa_signal_store_relaxed_fn(m_wakeup, 1);
+        {
+            auto _lk = std::unique_lock<std::mutex>{m_mutex};
+            _outstanding.insert(_outstanding.end(), m_pending.begin(), m_pending.end());
+            m_pending.clear();
+
+            if(m_exit && !_deadline) _deadline = std::chrono::steady_clock::now() + drain_timeout;
+        }
+
+        // complete everything which has finished, preserving the submission order of the rest
+        _outstanding.erase(
+            std::remove_if(_outstanding.begin(), _outstanding.end(), _is_complete),
+            _outstanding.end());
+
+        auto _timeout = std::numeric_limits<uint64_t>::max();
+        if(_deadline)
+        {
+            auto _now = std::chrono::steady_clock::now();
+            if(_outstanding.empty() || _now >= *_deadline) break;
+            _timeout =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(*_deadline - _now).count();
+        }
+
+        // wait for the wakeup signal or any outstanding copy, whichever finishes first
+        _signals.assign(1, m_wakeup);
+        for(const auto* itr : _outstanding)
+            _signals.emplace_back(itr->rocp_signal);
+        _conds.assign(_signals.size(), HSA_SIGNAL_CONDITION_LT);
+        _values.assign(_signals.size(), 1);
+
+        auto _satisfying_value = hsa_signal_value_t{0};
+        get_amd_ext_table()->hsa_amd_signal_wait_any_fn(static_cast<uint32_t>(_signals.size()),
+                                                        _signals.data(),
+                                                        _conds.data(),
+                                                        _values.data(),
+                                                        _timeout,
+                                                        HSA_WAIT_STATE_BLOCKED,
+                                                        &_satisfying_value);
+    }
+
+    ROCP_CI_LOG_IF(WARNING, !_outstanding.empty())
+        << "rocprofiler-sdk timed out after " << drain_timeout.count()
+        << " seconds waiting for " << _outstanding.size()
+        << " async memory copies to complete. Their completion will not be reported";
+}
+
+bool
+use_batched_completion()
+{
+    static auto _v = common::get_env("ROCPROFILER_ASYNC_COPY_BATCHED_COMPLETION", false);
+    return _v;
+}
+
+completion_ring*
+get_completion_ring()
+{
+    static auto*& _v = common::static_object<completion_ring>::construct();
+    return _v;
+}
+
 enum async_copy_id
 {
     async_copy_id           = ROCPROFILER_HSA_AMD_EXT_API_ID_hsa_amd_memory_async_copy,
@@ -573,7 +862,8 @@ async_copy_impl(Args... args)
         }
     }
 
-    async_copy_data* _data = nullptr;
+    const hsa_signal_value_t _completion_signal_val = 1;
+    async_copy_data*         _data                  = nullptr;
 
     {
         auto tracing_data = tracing::tracing_data{};
@@ -590,7 +880,14 @@ async_copy_impl(Args... args)
                           std::make_index_sequence<N>{});
         }
 
-        _data               = new async_copy_data{};
+        _data = get_async_copy_pool()->acquire(_completion_signal_val);
+        if(!_data)
+        {
+            return invoke(get_next_dispatch<TableIdx, OpIdx>(),
+                          std::move(_tied_args),
+                          std::make_index_sequence<N>{});
+        }
+
         _data->tracing_data = std::move(tracing_data);
     }
 
@@ -603,29 +900,12 @@ async_copy_impl(Args... args)
     _data->direction    = _direction;
     _data->bytes_copied = compute_copy_bytes(std::get<copy_size_idx>(_tied_args));
 
-    constexpr auto           completion_signal_idx  = arg_indices<OpIdx>::completion_signal_idx;
-    auto&                    _completion_signal     = std::get<completion_signal_idx>(_tied_args);
-    const hsa_signal_value_t _completion_signal_val = 1;
+    constexpr auto completion_signal_idx = arg_indices<OpIdx>::completion_signal_idx;
+    auto&          _completion_signal    = std::get<completion_signal_idx>(_tied_args);
 
     auto original_value = get_core_table()->hsa_signal_load_scacquire_fn(_completion_signal);
 
-    {
-        const uint32_t     num_consumers = 0;
-        const hsa_agent_t* consumers     = nullptr;
-        auto               _status       = get_core_table()->hsa_signal_create_fn(
-            _completion_signal_val, num_consumers, consumers, &_data->rocp_signal);
-
-        if(_status != HSA_STATUS_SUCCESS)
-        {
-            ROCP_ERROR << "hsa_signal_create returned non-zero error code " << _status;
-
-            delete _data;
-            return invoke(get_next_dispatch<TableIdx, OpIdx>(),
-                          std::move(_tied_args),
-                          std::make_index_sequence<N>{});
-        }
-    }
-
+    if(!use_batched_completion())
     {
         auto _status = get_amd_ext_table()->hsa_amd_signal_async_handler_fn(_data->rocp_signal,
                                                                             HSA_SIGNAL_CONDITION_LT,
@@ -637,10 +917,7 @@ async_copy_impl(Args... args)
         {
             ROCP_ERROR << "hsa_amd_signal_async_handler returned non-zero error code " << _status;
 
-            ROCP_HSA_TABLE_CALL(ERROR, get_core_table()->hsa_signal_destroy_fn(_data->rocp_signal))
-                << ":: failed to destroy signal after async handler failed";
-
-            delete _data;
+            release_async_copy_data(_data);
             return invoke(get_next_dispatch<TableIdx, OpIdx>(),
                           std::move(_tied_args),
                           std::make_index_sequence<N>{});
@@ -662,13 +939,12 @@ async_copy_impl(Args... args)
 
     // if we constructed a correlation id, this decrements the reference count after the underlying
     // function returns
-    auto _corr_id_dtor = common::scope_destructor{[_corr_id_pop, _data]() {
+    auto _corr_id_dtor = common::scope_destructor{[_corr_id_pop]() {
         if(_corr_id_pop)
         {
             context::pop_latest_correlation_id(_corr_id_pop);
             _corr_id_pop->sub_ref_count();
         }
-        _data->start_ts = common::timestamp_ns();
     }};
 
     auto thr_id = _data->correlation_id->thread_idx;
@@ -700,8 +976,47 @@ async_copy_impl(Args... args)
 
     CHECK_NOTNULL(get_active_signals())->fetch_add(1);
 
-    return invoke(
+    // set before the copy is submitted: the async handler or the completion ring may complete
+    // (and recycle) the data before the underlying function returns so the data is not touched
+    // after the copy is submitted
+    _data->start_ts = common::timestamp_ns();
+
+    if(!use_batched_completion())
+    {
+        return invoke(get_next_dispatch<TableIdx, OpIdx>(),
+                      std::move(_tied_args),
+                      std::make_index_sequence<N>{});
+    }
+
+    auto _status = invoke(
         get_next_dispatch<TableIdx, OpIdx>(), std::move(_tied_args), std::make_index_sequence<N>{});
+
+    if(_status == HSA_STATUS_SUCCESS)
+    {
+        CHECK_NOTNULL(get_completion_ring())->push(_data);
+        return _status;
+    }
+
+    // a copy which failed to submit never completes: report the exit phase without timestamps
+    // and release everything which would have been released on completion
+    if(!tracing_data.callback_contexts.empty())
+    {
+        auto _tracer_data = _data->get_callback_data();
+
+        tracing::execute_phase_exit_callbacks(tracing_data.callback_contexts,
+                                              tracing_data.external_correlation_ids,
+                                              ROCPROFILER_CALLBACK_TRACING_MEMORY_COPY,
+                                              _direction,
+                                              _tracer_data);
+    }
+
+    if(get_active_signals()) get_active_signals()->fetch_sub(1);
+
+    auto* _corr_id = _data->correlation_id;
+    release_async_copy_data(_data);
+    if(_corr_id) _corr_id->sub_ref_count();
+
+    return _status;
 }
 
 template <size_t TableIdx, size_t OpIdx, typename RetT, typename... Args>
@@ -850,6 +1165,12 @@ async_copy_fini()
     if(!async_copy::get_active_signals()) return;
 
     async_copy_sync();
+
+    if(async_copy::use_batched_completion() && async_copy::get_completion_ring())
+        async_copy::get_completion_ring()->stop();
+
+    if(async_copy::get_async_copy_pool()) async_copy::get_async_copy_pool()->clear();
+
     async_copy::get_active_signals()->destroy();
 }
 }  // namespace hsa
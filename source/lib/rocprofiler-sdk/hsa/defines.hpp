@@ -175,9 +175,9 @@
             return &base_type::functor<RetT, Args...>;                                             \
         }                                                                                          \
                                                                                                    \
-        static std::vector<void*> as_arg_addr(rocprofiler_callback_tracing_hsa_api_data_t)         \
+        static auto as_arg_addr(rocprofiler_callback_tracing_hsa_api_data_t)                       \
         {                                                                                          \
-            return std::vector<void*>{};                                                           \
+            return std::array<void*, 0>{};                                                         \
         }                                                                                          \
                                                                                                    \
         static std::vector<common::stringified_argument> as_arg_list(                              \
@@ -185,6 +185,13 @@
             int32_t)                                                                               \
         {                                                                                          \
             return {};                                                                             \
+        }                                                                                          \
+                                                                                                   \
+        static auto as_formatted_arg_list(common::format_buffer&,                                  \
+                                          rocprofiler_callback_tracing_hsa_api_data_t,             \
+                                          int32_t)                                                 \
+        {                                                                                          \
+            return common::formatted_argument_array_t<0>{};                                        \
         }                                                                                          \
     };                                                                                             \
     }                                                                                              \
@@ -253,10 +260,9 @@
             return &base_type::functor<RetT, Args...>;                                             \
         }                                                                                          \
                                                                                                    \
-        static std::vector<void*> as_arg_addr(                                                     \
-            rocprofiler_callback_tracing_hsa_api_data_t trace_data)                                \
+        static auto as_arg_addr(rocprofiler_callback_tracing_hsa_api_data_t trace_data)            \
         {                                                                                          \
-            return std::vector<void*>{                                                             \
+            return std::array{                                                                     \
                 GET_ADDR_MEMBER_FIELDS(get_api_data_args(trace_data.args), __VA_ARGS__)};          \
         }                                                                                          \
                                                                                                    \
@@ -266,6 +272,16 @@
             return utils::stringize(                                                               \
                 max_deref,                                                                         \
                 GET_NAMED_MEMBER_FIELDS(get_api_data_args(trace_data.args), __VA_ARGS__));         \
+        }                                                                                          \
+                                                                                                   \
+        static auto as_formatted_arg_list(common::format_buffer&                      _buf,        \
+                                          rocprofiler_callback_tracing_hsa_api_data_t trace_data,  \
+                                          int32_t                                     max_deref)   \
+        {                                                                                          \
+            return utils::format(                                                                  \
+                _buf,                                                                              \
+                max_deref,                                                                         \
+                GET_NAMED_MEMBER_FIELDS(get_api_data_args(trace_data.args), __VA_ARGS__));         \
         }                                                                                          \
     };                                                                                             \
     }                                                                                              \
@@ -298,9 +298,10 @@ template <typename RetT, typename... Args>
 RetT
 hsa_api_impl<TableIdx, OpIdx>::functor(Args... args)
 {
-    using buffer_hsa_api_record_t = rocprofiler_buffer_tracing_hsa_api_record_t;
-    using callback_hsa_api_data_t = rocprofiler_callback_tracing_hsa_api_data_t;
-    using info_type               = hsa_api_info<TableIdx, OpIdx>;
+    using buffer_hsa_api_record_t      = rocprofiler_buffer_tracing_hsa_api_record_t;
+    using buffer_hsa_api_args_record_t = rocprofiler_buffer_tracing_hsa_api_ext_record_t;
+    using callback_hsa_api_data_t      = rocprofiler_callback_tracing_hsa_api_data_t;
+    using info_type                    = hsa_api_info<TableIdx, OpIdx>;
 
     constexpr auto external_corr_id_domain_idx =
         hsa_domain_info<TableIdx>::external_correlation_id_domain_idx;
@@ -347,11 +348,16 @@ hsa_api_impl<TableIdx, OpIdx>::functor(Args... args)
                                                info_type::operation_idx,
                                                internal_corr_id);
 
+    // buffered contexts may request a copy of the arguments in the records
+    const auto capture_args =
+        tracing::has_buffered_api_args(buffered_contexts, info_type::buffered_domain_idx);
+
+    if(!callback_contexts.empty() || capture_args)
+        set_data_args(info_type::get_api_data_args(tracer_data.args), std::forward<Args>(args)...);
+
     // invoke the callbacks
     if(!callback_contexts.empty())
     {
-        set_data_args(info_type::get_api_data_args(tracer_data.args), std::forward<Args>(args)...);
-
         tracing::execute_phase_enter_callbacks(callback_contexts,
                                                thr_id,
                                                internal_corr_id,
@@ -382,10 +388,10 @@ hsa_api_impl<TableIdx, OpIdx>::functor(Args... args)
         buffer_record.end_timestamp = common::timestamp_ns();
     }
 
+    if(!callback_contexts.empty() || capture_args) set_data_retval(tracer_data.retval, _ret);
+
     if(!callback_contexts.empty())
     {
-        set_data_retval(tracer_data.retval, _ret);
-
         tracing::execute_phase_exit_callbacks(callback_contexts,
                                               external_corr_ids,
                                               info_type::callback_domain_idx,
@@ -393,7 +399,27 @@ hsa_api_impl<TableIdx, OpIdx>::functor(Args... args)
                                               tracer_data);
     }
 
-    if(!buffered_contexts.empty())
+    if(capture_args)
+    {
+        // only the arguments of this operation are copied and placed in the buffer
+        auto args_record   = common::init_public_api_struct(buffer_hsa_api_args_record_t{});
+        args_record.retval = tracer_data.retval;
+        info_type::get_api_data_args(args_record.args) =
+            info_type::get_api_data_args(tracer_data.args);
+        args_record.size = offsetof(buffer_hsa_api_args_record_t, args) +
+                           sizeof(info_type::get_api_data_args(args_record.args));
+
+        tracing::execute_buffer_record_emplace(buffered_contexts,
+                                               thr_id,
+                                               internal_corr_id,
+                                               external_corr_ids,
+                                               info_type::buffered_domain_idx,
+                                               info_type::operation_idx,
+                                               buffer_record,
+                                               args_record,
+                                               args_record.size);
+    }
+    else if(!buffered_contexts.empty())
     {
         tracing::execute_buffer_record_emplace(buffered_contexts,
                                                thr_id,
@@ -484,19 +510,20 @@ iterate_args(const uint32_t                                     id,
     if(OpIdx == id)
     {
         using info_type = hsa_api_info<TableIdx, OpIdx>;
-        auto&& arg_list = info_type::as_arg_list(data, max_deref);
+        auto   _buffer  = common::scoped_format_buffer{};
+        auto&& arg_list = info_type::as_formatted_arg_list(_buffer.get(), data, max_deref);
         auto&& arg_addr = info_type::as_arg_addr(data);
         for(size_t i = 0; i < std::min(arg_list.size(), arg_addr.size()); ++i)
         {
-            auto ret = func(info_type::callback_domain_idx,    // kind
-                            id,                                // operation
-                            i,                                 // arg_number
-                            arg_addr.at(i),                    // arg_value_addr
-                            arg_list.at(i).indirection_level,  // indirection
-                            arg_list.at(i).type,               // arg_type
-                            arg_list.at(i).name,               // arg_name
-                            arg_list.at(i).value.c_str(),      // arg_value_str
-                            arg_list.at(i).dereference_count,  // num deref in str
+            auto ret = func(info_type::callback_domain_idx,     // kind
+                            id,                                 // operation
+                            i,                                  // arg_number
+                            arg_addr.at(i),                     // arg_value_addr
+                            arg_list.at(i).indirection_level,   // indirection
+                            arg_list.at(i).type,                // arg_type
+                            arg_list.at(i).name,                // arg_name
+                            _buffer.at(arg_list.at(i).offset),  // arg_value_str
+                            arg_list.at(i).dereference_count,   // num deref in str
                             user_data);
             if(ret != 0) break;
         }
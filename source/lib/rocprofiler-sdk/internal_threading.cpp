@@ -25,6 +25,7 @@
 #include <rocprofiler-sdk/rocprofiler.h>
 
 #include "lib/common/container/stable_vector.hpp"
+#include "lib/common/logging.hpp"
 #include "lib/common/static_object.hpp"
 #include "lib/common/utility.hpp"
 #include "lib/rocprofiler-sdk/buffer.hpp"
@@ -33,8 +34,14 @@
 #include "lib/rocprofiler-sdk/registration.hpp"
 
 #include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
 #include <mutex>
 #include <stdexcept>
 #include <string>
@@ -57,8 +64,37 @@ auto affinity_functor(intmax_t)
     return _assign % std::thread::hardware_concurrency();
 }
 
+// invoked on each thread of the pool when it starts
+void
+apply_thread_properties(const thread_properties& _props)
+{
+    if(!_props.cpu_affinity.empty())
+    {
+        auto _ncpu = static_cast<size_t>(
+            *std::max_element(_props.cpu_affinity.begin(), _props.cpu_affinity.end()) + 1);
+        auto* _cpuset = CPU_ALLOC(_ncpu);
+        auto  _size   = CPU_ALLOC_SIZE(_ncpu);
+        CPU_ZERO_S(_size, _cpuset);
+        for(auto itr : _props.cpu_affinity)
+            CPU_SET_S(itr, _size, _cpuset);
+
+        if(auto _err = ::pthread_setaffinity_np(::pthread_self(), _size, _cpuset); _err != 0)
+            ROCP_WARNING << "failed to set the CPU affinity of callback thread "
+                         << common::get_tid() << ": " << strerror(_err);
+        CPU_FREE(_cpuset);
+    }
+
+    if(_props.priority != 0)
+    {
+        // on Linux, the nice value is a per-thread attribute when given a thread id
+        if(::setpriority(PRIO_PROCESS, common::get_tid(), _props.priority) != 0)
+            ROCP_WARNING << "failed to set the priority of callback thread " << common::get_tid()
+                         << " to " << _props.priority << ": " << strerror(errno);
+    }
+}
+
 auto
-get_thread_pool_config()
+get_thread_pool_config(const thread_properties& _props)
 {
     return thread_pool_config_t{.init         = true,
                                 .use_tbb      = false,
@@ -68,13 +104,14 @@ get_thread_pool_config()
                                 .pool_size    = 1,
                                 .task_queue   = nullptr,
                                 .set_affinity = affinity_functor,
-                                .initializer  = []() {},
+                                .initializer  = [_props]() { apply_thread_properties(_props); },
                                 .finalizer    = []() {}};
 }
 }  // namespace
 
-TaskGroup::TaskGroup()
-: parent_type{new thread_pool_t{get_thread_pool_config()}, false}
+TaskGroup::TaskGroup(thread_properties _props)
+: parent_type{new thread_pool_t{get_thread_pool_config(_props)}, false}
+, m_properties{std::move(_props)}
 , m_pool{parent_type::thread_pool()}
 {}
 
@@ -226,7 +263,7 @@ create_forked_callback_threads()
         for(auto& itr : *get_task_groups())
         {
             notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
-            itr = new task_group_t{};
+            itr = new task_group_t{itr->properties()};
             notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
         }
     }
@@ -279,7 +316,7 @@ notify_post_internal_thread_create(rocprofiler_runtime_library_t libs)
 }
 
 rocprofiler_callback_thread_t
-create_callback_thread()
+create_callback_thread(thread_properties _props)
 {
     // notify that rocprofiler library is about to create an inernal thread
     notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
@@ -288,7 +325,7 @@ create_callback_thread()
     auto idx = CHECK_NOTNULL(get_task_groups())->size();
 
     // construct the task group to use the newly created thread pool
-    get_task_groups()->emplace_back(new task_group_t{});
+    get_task_groups()->emplace_back(new task_group_t{std::move(_props)});
 
     // notify that rocprofiler library finished creating an internal thread
     notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
@@ -324,13 +361,48 @@ rocprofiler_at_internal_thread_create(rocprofiler_internal_thread_library_cb_t p
 
 rocprofiler_status_t
 rocprofiler_create_callback_thread(rocprofiler_callback_thread_t* cb_thread_id)
+{
+    auto properties = rocprofiler_callback_thread_properties_t{};
+    properties.size = sizeof(rocprofiler_callback_thread_properties_t);
+
+    return rocprofiler_create_callback_thread_with_properties(properties, cb_thread_id);
+}
+
+rocprofiler_status_t
+rocprofiler_create_callback_thread_with_properties(
+    rocprofiler_callback_thread_properties_t properties,
+    rocprofiler_callback_thread_t*           cb_thread_id)
 {
     if(rocprofiler::registration::get_init_status() > 0)
         return ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED;
 
+    if(properties.size < sizeof(rocprofiler_callback_thread_properties_t))
+        return ROCPROFILER_STATUS_ERROR_INCOMPATIBLE_ABI;
+
+    if(properties.cpu_affinity_count > 0 && properties.cpu_affinity == nullptr)
+        return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    if(properties.priority < -20 || properties.priority > 19)
+        return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    auto _props = rocprofiler::internal_threading::thread_properties{};
+    auto _ncpu  = ::sysconf(_SC_NPROCESSORS_CONF);
+    for(uint64_t i = 0; i < properties.cpu_affinity_count; ++i)
+    {
+        auto _cpu = properties.cpu_affinity[i];
+        if(_ncpu > 0 && _cpu >= static_cast<uint64_t>(_ncpu))
+        {
+            ROCP_ERROR << "callback thread CPU affinity contains CPU " << _cpu
+                       << " but the system only has " << _ncpu << " CPUs";
+            return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+        }
+        _props.cpu_affinity.emplace_back(_cpu);
+    }
+    _props.priority = properties.priority;
+
     rocprofiler::internal_threading::initialize();
 
-    auto cb_tid = rocprofiler::internal_threading::create_callback_thread();
+    auto cb_tid = rocprofiler::internal_threading::create_callback_thread(std::move(_props));
     if(cb_tid.handle > 0)
     {
         *cb_thread_id = cb_tid;
@@ -42,6 +42,13 @@ namespace rocprofiler
 {
 namespace internal_threading
 {
+// scheduling properties applied to each thread of a task group when it starts
+struct thread_properties
+{
+    std::vector<uint32_t> cpu_affinity = {};  // empty == inherit the affinity of the creator
+    int32_t               priority     = 0;   // nice value, zero == inherit
+};
+
 class TaskGroup : private PTL::TaskManager
 {
 public:
@@ -49,7 +56,7 @@ public:
     using parent_type   = PTL::TaskManager;
     using task_type     = PTL::PackagedTask<void>;
 
-    TaskGroup();
+    explicit TaskGroup(thread_properties _props = {});
     ~TaskGroup() override;
 
     TaskGroup(const TaskGroup&)     = delete;
@@ -61,7 +68,10 @@ public:
     void wait();
     void join();
 
+    const thread_properties& properties() const { return m_properties; }
+
 private:
+    thread_properties                      m_properties      = {};
     std::mutex                             m_mutex           = {};
     thread_pool_t*                         m_pool            = nullptr;
     std::deque<std::shared_ptr<task_type>> m_tasks           = {};
@@ -83,7 +93,7 @@ finalize();
 
 // creates a new thread
 rocprofiler_callback_thread_t
-create_callback_thread();
+create_callback_thread(thread_properties _props = {});
 
 // returns the task group for the given callback thread identifier
 task_group_t* get_task_group(rocprofiler_callback_thread_t);
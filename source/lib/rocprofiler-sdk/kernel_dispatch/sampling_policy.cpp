@@ -0,0 +1,141 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/rocprofiler-sdk/kernel_dispatch/sampling_policy.hpp"
+#include "lib/common/utility.hpp"
+
+#include <cstdint>
+#include <memory>
+
+namespace rocprofiler
+{
+namespace kernel_dispatch
+{
+namespace
+{
+// splitmix64: maps consecutive integers to well distributed 64-bit values
+uint64_t
+mix(uint64_t val)
+{
+    val += 0x9e3779b97f4a7c15ULL;
+    val = (val ^ (val >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    val = (val ^ (val >> 27)) * 0x94d049bb133111ebULL;
+    return val ^ (val >> 31);
+}
+}  // namespace
+
+sampling_policy::sampling_policy(policy_t policy, uint64_t start_ns)
+: m_policy{policy}
+, m_start_ns{start_ns}
+{
+    for(auto& itr : m_decisions)
+        itr.store(invalid_decision, std::memory_order_relaxed);
+}
+
+bool
+sampling_policy::is_valid(const policy_t& policy)
+{
+    switch(policy.type)
+    {
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_NONE: return true;
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_EVERY_NTH: return policy.count > 0;
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_FIRST_N: return true;
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_DUTY_CYCLE:
+            return policy.period_ns > 0 && policy.active_ns <= policy.period_ns;
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_RANDOM:
+            return policy.probability >= 0.0 && policy.probability <= 1.0;
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_LAST: break;
+    }
+    return false;
+}
+
+uint64_t
+sampling_policy::increment(rocprofiler_kernel_id_t kernel_id)
+{
+    // kernels already seen only need the shared lock
+    counter_t* counter = m_counters.rlock([kernel_id](const counter_map_t& data) -> counter_t* {
+        auto itr = data.find(kernel_id);
+        return (itr != data.end()) ? itr->second.get() : nullptr;
+    });
+
+    if(!counter)
+    {
+        counter = m_counters.wlock([kernel_id](counter_map_t& data) {
+            auto& val = data[kernel_id];
+            if(!val) val = std::make_unique<counter_t>(0);
+            return val.get();
+        });
+    }
+
+    return counter->fetch_add(1, std::memory_order_relaxed);
+}
+
+bool
+sampling_policy::sample(rocprofiler_kernel_id_t kernel_id, uint64_t now_ns)
+{
+    switch(m_policy.type)
+    {
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_NONE: return true;
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_EVERY_NTH:
+            return (increment(kernel_id) % m_policy.count) == 0;
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_FIRST_N:
+            return increment(kernel_id) < m_policy.count;
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_DUTY_CYCLE:
+        {
+            if(now_ns < m_start_ns) return m_policy.active_ns > 0;
+            return ((now_ns - m_start_ns) % m_policy.period_ns) < m_policy.active_ns;
+        }
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_RANDOM:
+        {
+            auto idx = m_random.fetch_add(1, std::memory_order_relaxed);
+            // top 53 bits as a uniformly distributed double in [0, 1)
+            auto val = static_cast<double>(mix(m_policy.seed ^ mix(idx)) >> 11) * 0x1.0p-53;
+            return val < m_policy.probability;
+        }
+        case ROCPROFILER_DISPATCH_SAMPLING_POLICY_LAST: break;
+    }
+    return true;
+}
+
+bool
+sampling_policy::sample(rocprofiler_kernel_id_t kernel_id)
+{
+    if(m_policy.type != ROCPROFILER_DISPATCH_SAMPLING_POLICY_DUTY_CYCLE)
+        return sample(kernel_id, 0);
+    return sample(kernel_id, common::timestamp_ns());
+}
+
+bool
+sampling_policy::sample_dispatch(rocprofiler_kernel_id_t   kernel_id,
+                                 rocprofiler_dispatch_id_t dispatch_id)
+{
+    auto& entry = m_decisions.at(dispatch_id % num_decisions);
+
+    auto cached = entry.load(std::memory_order_acquire);
+    if(cached != invalid_decision && (cached >> 1) == dispatch_id) return (cached & 1) != 0;
+
+    auto decision = sample(kernel_id);
+    entry.store((dispatch_id << 1) | (decision ? 1 : 0), std::memory_order_release);
+    return decision;
+}
+}  // namespace kernel_dispatch
+}  // namespace rocprofiler
@@ -0,0 +1,87 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <rocprofiler-sdk/dispatch_sampling.h>
+#include <rocprofiler-sdk/fwd.h>
+
+#include "lib/common/synchronized.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace rocprofiler
+{
+namespace kernel_dispatch
+{
+/**
+ * Decides which kernel dispatches are instrumented by the dispatch counting and dispatch thread
+ * trace services, without calling into the tool. Safe to call concurrently from any thread
+ * enqueuing kernels. Both services consult the policy for the same dispatch: sample_dispatch
+ * evaluates the policy once per dispatch id and returns the same decision to every service.
+ */
+class sampling_policy
+{
+public:
+    using policy_t = rocprofiler_dispatch_sampling_policy_t;
+
+    explicit sampling_policy(policy_t policy, uint64_t start_ns);
+
+    static bool is_valid(const policy_t& policy);
+
+    /// Returns true if the dispatch of kernel_id enqueued at now_ns should be instrumented
+    bool sample(rocprofiler_kernel_id_t kernel_id, uint64_t now_ns);
+    bool sample(rocprofiler_kernel_id_t kernel_id);
+
+    /// Same as above but the policy is evaluated (and its state advanced) only for the first call
+    /// with dispatch_id, the following calls with the same dispatch_id return the same decision
+    bool sample_dispatch(rocprofiler_kernel_id_t kernel_id, rocprofiler_dispatch_id_t dispatch_id);
+
+    const policy_t& get_policy() const { return m_policy; }
+
+private:
+    using counter_t     = std::atomic<uint64_t>;
+    using counter_map_t = std::unordered_map<rocprofiler_kernel_id_t, std::unique_ptr<counter_t>>;
+
+    // the services are invoked one after another when a dispatch is enqueued, hence only the
+    // decisions of the most recent dispatches are kept: each entry holds (dispatch_id << 1) |
+    // decision, indexed by dispatch_id
+    static constexpr size_t   num_decisions    = 256;
+    static constexpr uint64_t invalid_decision = ~uint64_t{0};
+    using decision_array_t = std::array<std::atomic<uint64_t>, num_decisions>;
+
+    // returns the number of dispatches of kernel_id seen before this one
+    uint64_t increment(rocprofiler_kernel_id_t kernel_id);
+
+    policy_t                            m_policy   = {};
+    uint64_t                            m_start_ns = 0;
+    std::atomic<uint64_t>               m_random   = {0};
+    common::Synchronized<counter_map_t> m_counters = {};
+    decision_array_t                    m_decisions;
+};
+}  // namespace kernel_dispatch
+}  // namespace rocprofiler
@@ -92,11 +92,16 @@
             return &base_type::functor<RetT, Args...>;                                             \
         }                                                                                          \
                                                                                                    \
-        static std::vector<void*> as_arg_addr(callback_data_type) { return std::vector<void*>{}; } \
+        static auto as_arg_addr(callback_data_type) { return std::array<void*, 0>{}; }             \
                                                                                                    \
         static std::vector<common::stringified_argument> as_arg_list(callback_data_type, int32_t)  \
         {                                                                                          \
             return {};                                                                             \
+        }                                                                                          \
+                                                                                                   \
+        static auto as_formatted_arg_list(common::format_buffer&, callback_data_type, int32_t)     \
+        {                                                                                          \
+            return common::formatted_argument_array_t<0>{};                                        \
         }                                                                                          \
     };                                                                                             \
     }                                                                                              \
@@ -172,9 +177,9 @@
             return &base_type::functor<RetT, Args...>;                                             \
         }                                                                                          \
                                                                                                    \
-        static std::vector<void*> as_arg_addr(callback_data_type trace_data)                       \
+        static auto as_arg_addr(callback_data_type trace_data)                                     \
         {                                                                                          \
-            return std::vector<void*>{                                                             \
+            return std::array{                                                                     \
                 GET_ADDR_MEMBER_FIELDS(get_api_data_args(trace_data.args), __VA_ARGS__)};          \
         }                                                                                          \
                                                                                                    \
@@ -183,6 +188,16 @@
             return utils::stringize(                                                               \
                 max_deref,                                                                         \
                 GET_NAMED_MEMBER_FIELDS(get_api_data_args(trace_data.args), __VA_ARGS__));         \
+        }                                                                                          \
+                                                                                                   \
+        static auto as_formatted_arg_list(common::format_buffer& _buf,                             \
+                                          callback_data_type     trace_data,                       \
+                                          int32_t                max_deref)                        \
+        {                                                                                          \
+            return utils::format(                                                                  \
+                _buf,                                                                              \
+                max_deref,                                                                         \
+                GET_NAMED_MEMBER_FIELDS(get_api_data_args(trace_data.args), __VA_ARGS__));         \
         }                                                                                          \
     };                                                                                             \
     }                                                                                              \
@@ -23,6 +23,7 @@
 #include "lib/rocprofiler-sdk/marker/marker.hpp"
 #include "lib/common/defines.hpp"
 #include "lib/common/static_object.hpp"
+#include "lib/common/string_entry.hpp"
 #include "lib/common/utility.hpp"
 #include "lib/rocprofiler-sdk/buffer.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
@@ -52,6 +53,17 @@ namespace
 struct null_type
 {};
 
+// the operations whose only argument is a message
+template <size_t TableIdx, size_t OpIdx>
+constexpr bool
+has_message()
+{
+    return TableIdx == ROCPROFILER_MARKER_TABLE_ID_RoctxCore &&
+           (OpIdx == ROCPROFILER_MARKER_CORE_API_ID_roctxMarkA ||
+            OpIdx == ROCPROFILER_MARKER_CORE_API_ID_roctxRangePushA ||
+            OpIdx == ROCPROFILER_MARKER_CORE_API_ID_roctxRangeStartA);
+}
+
 template <typename Tp>
 auto
 get_default_retval()
@@ -225,6 +237,9 @@ roctx_api_impl<TableIdx, OpIdx>::functor(Args... args)
 
     if(!buffered_contexts.empty())
     {
+        if constexpr(has_message<TableIdx, OpIdx>())
+            buffer_record.message_id = get_message_id(args...);
+
         tracing::execute_buffer_record_emplace(buffered_contexts,
                                                thr_id,
                                                internal_corr_id,
@@ -314,19 +329,20 @@ iterate_args(const uint32_t                                        id,
     if(OpIdx == id)
     {
         using info_type = roctx_api_info<TableIdx, OpIdx>;
-        auto&& arg_list = info_type::as_arg_list(data, max_deref);
+        auto   _buffer  = common::scoped_format_buffer{};
+        auto&& arg_list = info_type::as_formatted_arg_list(_buffer.get(), data, max_deref);
         auto&& arg_addr = info_type::as_arg_addr(data);
         for(size_t i = 0; i < std::min(arg_list.size(), arg_addr.size()); ++i)
         {
-            auto ret = func(info_type::callback_domain_idx,    // kind
-                            id,                                // operation
-                            i,                                 // arg_number
-                            arg_addr.at(i),                    // arg_value_addr
-                            arg_list.at(i).indirection_level,  // indirection
-                            arg_list.at(i).type,               // arg_type
-                            arg_list.at(i).name,               // arg_name
-                            arg_list.at(i).value.c_str(),      // arg_value_str
-                            arg_list.at(i).dereference_count,  // num deref in str
+            auto ret = func(info_type::callback_domain_idx,     // kind
+                            id,                                 // operation
+                            i,                                  // arg_number
+                            arg_addr.at(i),                     // arg_value_addr
+                            arg_list.at(i).indirection_level,   // indirection
+                            arg_list.at(i).type,                // arg_type
+                            arg_list.at(i).name,                // arg_name
+                            _buffer.at(arg_list.at(i).offset),  // arg_value_str
+                            arg_list.at(i).dereference_count,   // num deref in str
                             user_data);
             if(ret != 0) break;
         }
@@ -505,6 +521,18 @@ iterate_args(uint32_t                                              id,
                                std::make_index_sequence<roctx_domain_info<TableIdx>::last>{});
 }
 
+uint64_t
+get_message_id(const char* message)
+{
+    return (message) ? common::add_string_entry(message) : 0;
+}
+
+const std::string*
+get_message(uint64_t id)
+{
+    return common::get_string_entry(static_cast<size_t>(id));
+}
+
 template <typename TableT>
 void
 copy_table(TableT* _orig, uint64_t _tbl_instance)
@@ -27,6 +27,7 @@
 #include <rocprofiler-sdk-roctx/api_trace.h>
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 namespace rocprofiler
@@ -90,6 +91,14 @@ iterate_args(uint32_t                                              id,
              int32_t                                               max_deref,
              void*                                                 user_data);
 
+// interns the message and returns its id (zero for a null message)
+uint64_t
+get_message_id(const char* message);
+
+// returns nullptr if the id does not refer to an interned message
+const std::string*
+get_message(uint64_t id);
+
 template <typename TableT>
 void
 copy_table(TableT* _orig, uint64_t _tbl_instance);
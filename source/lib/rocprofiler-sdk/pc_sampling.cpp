@@ -99,6 +99,36 @@ rocprofiler_configure_pc_sampling_service(rocprofiler_context_id_t         conte
 #endif
 }
 
+rocprofiler_status_t
+rocprofiler_configure_pc_sampling_output_mode(rocprofiler_context_id_t              context_id,
+                                              rocprofiler_agent_id_t                agent_id,
+                                              rocprofiler_pc_sampling_output_mode_t mode)
+{
+    if(!is_pc_sampling_explicitly_enabled()) return ROCPROFILER_STATUS_ERROR_NOT_IMPLEMENTED;
+
+#if ROCPROFILER_SDK_HSA_PC_SAMPLING > 0
+    if(rocprofiler::registration::get_init_status() > -1)
+        return ROCPROFILER_STATUS_ERROR_CONFIGURATION_LOCKED;
+
+    if(mode >= ROCPROFILER_PC_SAMPLING_OUTPUT_MODE_LAST)
+        return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    auto* ctx = rocprofiler::context::get_mutable_registered_context(context_id);
+    if(!ctx) return ROCPROFILER_STATUS_ERROR_CONTEXT_NOT_FOUND;
+
+    return rocprofiler::pc_sampling::configure_pc_sampling_output_mode(ctx, agent_id, mode);
+#else
+    (void) context_id;
+    (void) agent_id;
+    (void) mode;
+
+    ROCP_ERROR << "PC sampling unavailable\n";
+
+    // ROCr runtime is missing PC sampling.
+    return ROCPROFILER_STATUS_ERROR_NOT_AVAILABLE;
+#endif
+}
+
 rocprofiler_status_t
 rocprofiler_query_pc_sampling_agent_configurations(
     rocprofiler_agent_id_t                                agent_id,
@@ -23,18 +23,43 @@
 #include "lib/rocprofiler-sdk/pc_sampling/cid_manager.hpp"
 
 #include <algorithm>
+#include <utility>
 
 namespace rocprofiler
 {
 namespace pc_sampling
 {
+PCSCIDManager::~PCSCIDManager()
+{
+    auto* node = q1.exchange(nullptr);
+    while(node)
+    {
+        delete std::exchange(node, node->next);
+    }
+}
+
 void
 PCSCIDManager::cid_async_activity_completed(context::correlation_id* cid)
 {
-    // Hold the lock while updating the state of PCSCIDManager
-    std::unique_lock<std::mutex> lock(m);
-    // The kernel of the `cid` completed, so add cid to `q1`.
-    q1.emplace_back(cid);
+    // The kernel of the `cid` completed, so push cid to `q1`.
+    // Lock-free push, this must not wait for the buffer flushes parsing samples.
+    auto* node = new completed_node{cid, q1.load(std::memory_order_relaxed)};
+    while(!q1.compare_exchange_weak(
+        node->next, node, std::memory_order_release, std::memory_order_relaxed))
+    {}
+}
+
+std::vector<context::correlation_id*>
+PCSCIDManager::take_q1()
+{
+    auto  _cids = std::vector<context::correlation_id*>{};
+    auto* node  = q1.exchange(nullptr, std::memory_order_acquire);
+    while(node)
+    {
+        _cids.emplace_back(node->cid);
+        delete std::exchange(node, node->next);
+    }
+    return _cids;
 }
 
 void
@@ -43,24 +68,22 @@ PCSCIDManager::manage_cids_implicit(const pc_samples_copy_fn_t& pc_samples_copy_
     std::vector<context::correlation_id*> q3;
     {
         // To manipulate the contents of q1 and q2 and change the state of PCSCIDManager,
-        // acquire the lock.
+        // acquire the lock. Only the buffer flushes contend on this lock.
         std::unique_lock<std::mutex> lock(m);
         // Move all CIDs from q2 to the q3 local for this function.
         // Note: two buffer flushes happened since kernels of q3's CIDs completed.
         q3 = std::move(q2);
-        // Move all CIDs from q1 to q2.
+        // Move all CIDs from q1 to q2. Detaching q1 leaves it empty, indicating that there are
+        // no CIDs with the following property: no buffer flush occured since the kernel of CID
+        // is marked completed.
         // Note: exactly one buffer flush occured since kernels of q2's CIDs completed.
-        q2 = std::move(q1);
+        q2 = take_q1();
 
         // We move CIDs from one queue to another to reflect that an implicit ROCr's buffer flush
         // occured. move from q1 to q2 reflects the first buffer flush since kernels of q1's CIDs
         // completed move from q2 to local q3 reflects the second buffer flush since kernels of q2's
         // CIDs completed.
 
-        // Empty the q1 to indicate that there are no CIDs with the following property:
-        // no buffer flush occured since the kernel of CID is marked completed.
-        q1.clear();
-
         // The code that follows does not change the state of the PCSCIDManager, so release the lock
         // implicitly.
     }
@@ -88,13 +111,11 @@ PCSCIDManager::manage_cids_explicit(const pc_samples_copy_fn_t& pc_samples_expli
         // acquire the lock.
         std::unique_lock<std::mutex> lock(m);
 
-        // Move all CIDs from q1 and q2 to local q1_copy and q2_copy, respectively
-        q1_copy = std::move(q1);
-        q2_copy = std::move(q2);
-
-        // Drop CIDs from q1 and q2, because the following explicit flush
+        // Move all CIDs from q1 and q2 to local q1_copy and q2_copy, respectively.
+        // This drops CIDs from q1 and q2, because the following explicit flush
         // will deliver corresponding samples.
-        q1.clear();
+        q1_copy = take_q1();
+        q2_copy = std::move(q2);
         q2.clear();
 
         // The code that follows does not change the state of the PCSCIDManager, so release the lock
@@ -129,13 +150,18 @@ PCSCIDManager::retire_cids_of(std::vector<context::correlation_id*>& q)
 {
     // This function does not change the local state of the manager,
     // so it does not need synchronization.
+    if(q.empty()) return;
+
+    // Notify the parser that the kernels have completed, taking the parser's lock only once.
+    auto ids = std::vector<uint64_t>{};
+    ids.reserve(q.size());
+    for(auto* cid : q)
+        ids.emplace_back(cid->internal);
+    pcs_parser->completeDispatches(ids);
+
+    // Decrement the ref_counters. Eventually, the CIDs are retired.
     for(auto* cid : q)
-    {
-        // Notify the parser that the kernel has completed.
-        pcs_parser->completeDispatch(cid->internal);
-        // Decrement the ref_counter. Eventually, the CID is retired.
         cid->sub_ref_count();
-    }
 }
 
 }  // namespace pc_sampling
@@ -25,6 +25,7 @@
 #include "lib/rocprofiler-sdk/context/correlation_id.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/pc_record_interface.hpp"
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <vector>
@@ -75,17 +76,29 @@ namespace pc_sampling
  */
 class PCSCIDManager
 {
-    /// A lock that must be hold while updating the state of PCSCIDManager.
-    std::mutex m;
+    /// Node of the lock-free list of correlation IDs whose kernels completed.
+    struct completed_node
+    {
+        context::correlation_id* cid  = nullptr;
+        completed_node*          next = nullptr;
+    };
+
     /// Correlation IDs with the following property: no ROCr's buffer flush happened
-    /// since a corresponding kernel completed
-    std::vector<context::correlation_id*> q1;
+    /// since a corresponding kernel completed. Kernel completion callbacks (producers) push
+    /// to this list without taking any lock, so they never wait for samples being parsed.
+    /// Buffer flushes (consumers) detach the whole list at once.
+    std::atomic<completed_node*> q1 = {nullptr};
+    /// A lock that must be hold by the consumers while updating q2.
+    std::mutex m;
     /// Correlation IDs with the following property: exactly one ROCr's buffer flush occured
     /// since a corresponding kernel completed
     std::vector<context::correlation_id*> q2;
     /// A pointer to the PC sampling parser to be notified when the CID is retired.
     PCSamplingParserContext* pcs_parser = nullptr;
 
+    /// Detaches all CIDs from q1. Must be called while holding the lock m.
+    std::vector<context::correlation_id*> take_q1();
+
     /// Prepare the CIDs of q to be retired. Refer to the implementation for more information.
     void retire_cids_of(std::vector<context::correlation_id*>& q);
 
@@ -94,6 +107,11 @@ public:
     : pcs_parser(parser)
     {}
 
+    ~PCSCIDManager();
+
+    PCSCIDManager(const PCSCIDManager&) = delete;
+    PCSCIDManager& operator=(const PCSCIDManager&) = delete;
+
     /// Called by the `kernel_completion_callback` to mark the kernel matching @p cid completed.
     void cid_async_activity_completed(context::correlation_id* cid);
 
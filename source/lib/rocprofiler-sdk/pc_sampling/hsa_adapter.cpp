@@ -27,6 +27,9 @@
 #if ROCPROFILER_SDK_HSA_PC_SAMPLING > 0
 
 #    include "lib/common/logging.hpp"
+#    include "lib/common/utility.hpp"
+#    include "lib/rocprofiler-sdk/buffer.hpp"
+#    include "lib/rocprofiler-sdk/code_object/code_object.hpp"
 #    include "lib/rocprofiler-sdk/context/context.hpp"
 #    include "lib/rocprofiler-sdk/hsa/hsa.hpp"
 #    include "lib/rocprofiler-sdk/hsa/queue_controller.hpp"
@@ -39,6 +42,8 @@
 #    include <hsa/hsa_ext_amd.h>
 #    include <hsa/hsa_ven_amd_pc_sampling.h>
 
+#    include <algorithm>
+#    include <iterator>
 #    include <mutex>
 #    include <optional>
 #    include <shared_mutex>
@@ -154,12 +159,13 @@ data_ready_callback(void*                                client_callback_data,
     // process of retiring correlation IDs.
     agent_session->cid_manager->manage_cids_implicit([&]() {
         size_t samples_num = data_size / sizeof(packet_union_t);
-        // allocate a temporary buffer for copying PC samples
-        // TODO: think about how to optimize this (e.g., introduce a buffer pool)
-        auto buff = std::make_unique<packet_union_t[]>(samples_num);
+        // staging buffer reused across callbacks delivered on this thread. Copying out releases
+        // the ROCr buffer right away, while the parser workers translate the samples.
+        static thread_local auto buff = std::vector<packet_union_t>{};
+        if(buff.size() < samples_num) buff.resize(samples_num);
 
         // copy all the data
-        data_copy_callback(hsa_callback_data, data_size, buff.get());
+        data_copy_callback(hsa_callback_data, data_size, buff.data());
 
         upcoming_samples_t upc;
         // rocp_agent handle uniquely identifies the device
@@ -174,7 +180,7 @@ data_ready_callback(void*                                client_callback_data,
 
         auto gfx_major         = ((agent_session->agent->gfx_target_version / 10000) % 100);
         auto pcs_parser_status = agent_session->parser->parse(
-            upc, reinterpret_cast<const generic_sample_t*>(buff.get()), gfx_major, cv, false);
+            upc, reinterpret_cast<const generic_sample_t*>(buff.data()), gfx_major, cv, false);
 
         if(pcs_parser_status != PCSAMPLE_STATUS_SUCCESS)
         {
@@ -182,6 +188,65 @@ data_ready_callback(void*                                client_callback_data,
         }
     });
 }
+
+/**
+ * @brief Places the samples aggregated by the parser into the SDK buffer as histogram records.
+ * Sampled PCs are resolved against the code objects loaded on the agent at the moment of the
+ * flush, which is why the histogram is flushed before code object unload markers.
+ */
+void
+flush_histogram(const PCSAgentSession* agent_session)
+{
+    auto bins = agent_session->parser->drainHistogram();
+    if(bins.empty()) return;
+
+    auto* buff = rocprofiler::buffer::get_buffer(agent_session->buffer_id);
+    if(!buff) return;
+
+    struct code_object_range
+    {
+        uint64_t begin = 0;
+        uint64_t end   = 0;
+        uint64_t id    = 0;
+        int64_t  delta = 0;
+    };
+
+    auto ranges = std::vector<code_object_range>{};
+    rocprofiler::code_object::iterate_loaded_code_objects(
+        [&](const rocprofiler::code_object::hsa::code_object& code_object) {
+            const auto& data = code_object.rocp_data;
+            if(data.rocp_agent != agent_session->agent->id) return;
+            ranges.emplace_back(code_object_range{data.load_base,
+                                                  data.load_base + data.load_size,
+                                                  data.code_object_id,
+                                                  data.load_delta});
+        });
+    std::sort(ranges.begin(), ranges.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.begin < rhs.begin;
+    });
+
+    for(const auto& bin : bins)
+    {
+        auto record = common::init_public_api_struct(rocprofiler_pc_sampling_histogram_record_t{});
+        record.code_object_offset = bin.pc;
+        record.correlation_id     = bin.correlation_id;
+        record.count              = bin.count;
+
+        auto itr = std::upper_bound(
+            ranges.begin(), ranges.end(), bin.pc, [](uint64_t pc, const auto& range) {
+                return pc < range.begin;
+            });
+        if(itr != ranges.begin() && bin.pc < std::prev(itr)->end)
+        {
+            record.code_object_id     = std::prev(itr)->id;
+            record.code_object_offset = bin.pc - std::prev(itr)->delta;
+        }
+
+        buff->emplace(ROCPROFILER_BUFFER_CATEGORY_PC_SAMPLING,
+                      ROCPROFILER_PC_SAMPLING_RECORD_HISTOGRAM,
+                      record);
+    }
+}
 }  // namespace
 
 rocprofiler::hsa::rocprofiler_packet
@@ -375,6 +440,8 @@ flush_internal_agent_buffers(const PCSAgentSession* agent_session)
             std::runtime_error("Fail to flush ROCr's buffer explicitly");
         }
     });
+    // All samples delivered by ROCr have been parsed, place the aggregated ones (if any)
+    flush_histogram(agent_session);
     return ROCPROFILER_STATUS_SUCCESS;
 }
 }  // namespace hsa
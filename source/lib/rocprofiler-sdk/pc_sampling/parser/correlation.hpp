@@ -24,9 +24,13 @@
 
 #include "lib/common/logging.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/translation.hpp"
+#include "lib/rocprofiler-sdk/pc_sampling/parser/worker_pool.hpp"
 
 #include <rocprofiler-sdk/fwd.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <iostream>
 #include <memory>
@@ -61,39 +65,18 @@ union trap_correlation_id_t
     } wrapped;
 };
 
-struct DispatchPkt
-{
-    trap_correlation_id_t correlation_id_in;  //! Correlation ID seen by the trap handler
-    device_handle         dev;                //! Which device this is run
-};
-
 inline bool
 operator==(const trap_correlation_id_t& a, const trap_correlation_id_t& b)
 {
     return a.raw == b.raw;
 }
 
-inline bool
-operator==(const DispatchPkt& a, const DispatchPkt& b)
-{
-    return a.correlation_id_in == b.correlation_id_in && a.dev == b.dev;
-}
-}  // namespace Parser
-
-template <>
-struct std::hash<Parser::DispatchPkt>
-{
-    size_t operator()(const Parser::DispatchPkt& d) const
-    {
-        return (d.correlation_id_in.raw << 8) ^ d.dev.handle;
-    }
-};
-
-namespace Parser
-{
 /**
  * Coordinates DispatchMap and DoorBellMap to reconstruct the original correlation_id
  * from the correlation_id seen by the trap handler.
+ * The mapping is a per-device, two-level direct-indexed table: the first level is indexed by the
+ * (10-bit) doorbell id and the second level is a ring of dispatch slots indexed by the
+ * (25-bit) wrapped dispatch index. Lookups never allocate nor throw.
  */
 class CorrelationMap
 {
@@ -106,18 +89,26 @@ public:
      */
     bool checkDispatch(const dispatch_pkt_id_t& pkt) const
     {
-        auto trap = trap_correlation_id(pkt.doorbell_id, pkt.write_index, pkt.queue_size);
-        return dispatch_to_correlation.find({trap, pkt.device}) != dispatch_to_correlation.end();
+        auto        trap  = trap_correlation_id(pkt.doorbell_id, pkt.write_index, pkt.queue_size);
+        const auto* table = find_device(pkt.device);
+        if(!table) return false;
+
+        const auto* slot = find_slot(*table, trap);
+        return slot != nullptr && slot->valid.load(std::memory_order_acquire);
     }
 
     /**
-     * @brief Updates the mapping of dispatch_id to correlation_id
+     * @brief Updates the mapping of dispatch_id to correlation_id.
+     * Writers (newDispatch and forget) must be serialized by the caller. Readers may run
+     * concurrently: slots are never moved nor freed while the map exists.
      */
     void newDispatch(const dispatch_pkt_id_t& pkt)
     {
-        cache_dev_id = ~0ul;
-        auto trap_id = trap_correlation_id(pkt.doorbell_id, pkt.write_index, pkt.queue_size);
-        dispatch_to_correlation[{trap_id, pkt.device}] = pkt.correlation_id;
+        auto  trap_id = trap_correlation_id(pkt.doorbell_id, pkt.write_index, pkt.queue_size);
+        auto& queue   = get_device(pkt.device)[trap_id.wrapped.doorbell_id];
+        auto& slot    = queue.get_or_create(trap_id.wrapped.dispatch_index);
+
+        slot.store(pkt.correlation_id);
     }
 
     /**
@@ -125,25 +116,195 @@ public:
      */
     void forget(const dispatch_pkt_id_t& pkt)
     {
-        cache_dev_id = ~0ul;
-        auto trap_id = trap_correlation_id(pkt.doorbell_id, pkt.write_index, pkt.queue_size);
-        dispatch_to_correlation.erase({trap_id, pkt.device});
+        auto  trap_id = trap_correlation_id(pkt.doorbell_id, pkt.write_index, pkt.queue_size);
+        auto* table   = find_device(pkt.device);
+        if(!table) return;
+
+        if(auto* slot = find_slot(*table, trap_id)) slot->invalidate();
     }
 
+private:
+    static constexpr size_t num_doorbells   = 1 << 10;
+    static constexpr size_t slots_per_chunk = 1 << 12;
+    static constexpr size_t max_queue_slots = 1 << 25;
+    static constexpr size_t num_chunks      = max_queue_slots / slots_per_chunk;
+    static constexpr size_t max_devices     = 256;
+
+    /**
+     * A slot is rewritten when the dispatch index wraps around while parser threads may read it,
+     * hence the correlation id is guarded by a sequence lock: the sequence is odd while the
+     * (single) writer updates the slot and readers retry until they read the fields between two
+     * identical even sequence values. The fields are atomics accessed with relaxed ordering so
+     * that the racy reads of a retried attempt are well-defined.
+     */
+    struct dispatch_slot
+    {
+        std::atomic<uint64_t> sequence = {0};
+        std::atomic<bool>     valid    = {false};
+        std::atomic<uint64_t> internal = {0};
+        std::atomic<uint64_t> external = {0};
+
+        void store(const rocprofiler_correlation_id_t& corr_id)
+        {
+            auto _seq = begin_write();
+            internal.store(corr_id.internal, std::memory_order_relaxed);
+            external.store(corr_id.external.value, std::memory_order_relaxed);
+            valid.store(true, std::memory_order_relaxed);
+            end_write(_seq);
+        }
+
+        void invalidate()
+        {
+            auto _seq = begin_write();
+            valid.store(false, std::memory_order_relaxed);
+            end_write(_seq);
+        }
+
+        bool load(rocprofiler_correlation_id_t& corr_id) const
+        {
+            while(true)
+            {
+                auto _seq = sequence.load(std::memory_order_acquire);
+                if((_seq & 1) != 0) continue;
+
+                auto _valid    = valid.load(std::memory_order_relaxed);
+                auto _internal = internal.load(std::memory_order_relaxed);
+                auto _external = external.load(std::memory_order_relaxed);
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if(sequence.load(std::memory_order_relaxed) != _seq) continue;
+
+                if(!_valid) return false;
+                corr_id.internal       = _internal;
+                corr_id.external.value = _external;
+                return true;
+            }
+        }
+
+    private:
+        uint64_t begin_write()
+        {
+            auto _seq = sequence.load(std::memory_order_relaxed);
+            sequence.store(_seq + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            return _seq;
+        }
+
+        void end_write(uint64_t _seq) { sequence.store(_seq + 2, std::memory_order_release); }
+    };
+
+    /**
+     * Dispatch slots of a single doorbell. Slots are allocated in fixed-size chunks when a
+     * dispatch index is first seen, so the memory is proportional to the queue usage and not to
+     * the (potentially huge) queue size. Chunks are only published, never moved, hence the
+     * pointers handed to readers remain valid while newDispatch adds chunks.
+     */
+    class queue_slots_t
+    {
+    public:
+        queue_slots_t() = default;
+        ~queue_slots_t()
+        {
+            auto* _chunks = chunks.load();
+            if(!_chunks) return;
+            for(auto& itr : *_chunks)
+                delete itr.load();
+            delete _chunks;
+        }
+
+        queue_slots_t(const queue_slots_t&) = delete;
+        queue_slots_t& operator=(const queue_slots_t&) = delete;
+
+        dispatch_slot* find(size_t index) const
+        {
+            if(index >= max_queue_slots) return nullptr;
+
+            auto* _chunks = chunks.load(std::memory_order_acquire);
+            if(!_chunks) return nullptr;
+
+            auto* _chunk = (*_chunks)[index / slots_per_chunk].load(std::memory_order_acquire);
+            if(!_chunk) return nullptr;
+
+            return &(*_chunk)[index % slots_per_chunk];
+        }
+
+        dispatch_slot& get_or_create(size_t index)
+        {
+            auto* _chunks = chunks.load(std::memory_order_acquire);
+            if(!_chunks)
+            {
+                _chunks = new chunk_table_t{};
+                chunks.store(_chunks, std::memory_order_release);
+            }
+
+            auto& _chunk = (*_chunks)[(index / slots_per_chunk) % num_chunks];
+            auto* _slots = _chunk.load(std::memory_order_acquire);
+            if(!_slots)
+            {
+                _slots = new slot_chunk_t{};
+                _chunk.store(_slots, std::memory_order_release);
+            }
+
+            return (*_slots)[index % slots_per_chunk];
+        }
+
+    private:
+        using slot_chunk_t  = std::array<dispatch_slot, slots_per_chunk>;
+        using chunk_table_t = std::array<std::atomic<slot_chunk_t*>, num_chunks>;
+
+        std::atomic<chunk_table_t*> chunks = {nullptr};
+    };
+
+    using device_table_t = std::array<queue_slots_t, num_doorbells>;
+
+    struct device_entry_t
+    {
+        device_handle                   device = {};
+        std::unique_ptr<device_table_t> table  = {};
+    };
+
+public:
+    /**
+     * Read-only view of the dispatches of a single device. The device lookup is done once when
+     * the view is created. Lookups are const, hence several parser threads may use the same view.
+     */
+    class device_view
+    {
+    public:
+        explicit device_view(const device_table_t* _table)
+        : table(_table)
+        {}
+
+        /**
+         * Given a doorbell and wrapped dispatch_id, writes the correlation_id set by
+         * dispatch_pkt_id_t to correlation_out.
+         * @returns false if no dispatch matches correlation_in.
+         */
+        bool get(trap_correlation_id_t         correlation_in,
+                 rocprofiler_correlation_id_t& correlation_out) const
+        {
+            if(!table) return false;
+
+            const auto* slot = find_slot(*table, correlation_in);
+            return slot != nullptr && slot->load(correlation_out);
+        }
+
+    private:
+        const device_table_t* table = nullptr;
+    };
+
+    device_view view(device_handle dev) const { return device_view{find_device(dev)}; }
+
     /**
      * Given a device dev, doorbell and and wrapped dispatch_id,
-     * @returns the correlation_id set by dispatch_pkt_id_t
+     * writes the correlation_id set by dispatch_pkt_id_t to correlation_out.
+     * @returns false if no dispatch matches correlation_in.
      */
-    rocprofiler_correlation_id_t get(device_handle dev, trap_correlation_id_t correlation_in)
+    bool get(device_handle                 dev,
+             trap_correlation_id_t         correlation_in,
+             rocprofiler_correlation_id_t& correlation_out) const
     {
-#ifndef _PARSER_CORRELATION_DISABLE_CACHE
-        if(dev.handle == cache_dev_id && correlation_in == cache_correlation_id_in)
-            return cache_correlation_id_out;
-#endif
-        cache_correlation_id_out = dispatch_to_correlation.at({correlation_in, dev});
-        cache_dev_id             = dev.handle;
-        cache_correlation_id_in  = correlation_in;
-        return cache_correlation_id_out;
+        return view(dev).get(correlation_in, correlation_out);
     }
 
     /**
@@ -167,14 +328,37 @@ public:
     }
 
 private:
-    std::unordered_map<DispatchPkt, rocprofiler_correlation_id_t> dispatch_to_correlation{};
-
-    // Making get() const and these cache variables mutable causes performance to be unstable
-    trap_correlation_id_t        cache_correlation_id_in{.raw = ~0ul};  // Invalid value in cache
-    rocprofiler_correlation_id_t cache_correlation_id_out{
-        .internal = ~0ul,
-        .external = rocprofiler_user_data_t{.value = ~0ul}};
-    uint64_t cache_dev_id = ~0ul;  // Invalid device Id in cache
+    device_table_t* find_device(device_handle dev) const
+    {
+        auto _num_devices = num_devices.load(std::memory_order_acquire);
+        for(size_t i = 0; i < _num_devices; ++i)
+            if(devices[i].device == dev) return devices[i].table.get();
+        return nullptr;
+    }
+
+    device_table_t& get_device(device_handle dev)
+    {
+        if(auto* table = find_device(dev)) return *table;
+
+        // Entries are never moved so readers may search the devices while one is added
+        auto _idx = num_devices.load(std::memory_order_relaxed);
+        ROCP_FATAL_IF(_idx >= max_devices)
+            << "PC sampling parser supports at most " << max_devices << " devices";
+
+        devices[_idx].device = dev;
+        devices[_idx].table  = std::make_unique<device_table_t>();
+        num_devices.store(_idx + 1, std::memory_order_release);
+        return *devices[_idx].table;
+    }
+
+    static dispatch_slot* find_slot(const device_table_t& table, trap_correlation_id_t trap)
+    {
+        return table[trap.wrapped.doorbell_id].find(trap.wrapped.dispatch_index);
+    }
+
+    //! Usually a handful of devices, hence a linear search.
+    std::array<device_entry_t, max_devices> devices     = {};
+    std::atomic<size_t>                     num_devices = {0};
 };
 }  // namespace Parser
 
@@ -183,20 +367,19 @@ inline pcsample_status_t
 add_upcoming_samples(const device_handle               device,
                      const generic_sample_t*           buffer,
                      const size_t                      available_samples,
-                     Parser::CorrelationMap*           corr_map,
+                     const Parser::CorrelationMap*     corr_map,
                      rocprofiler_pc_sampling_record_t* samples)
 {
-    pcsample_status_t status = PCSAMPLE_STATUS_SUCCESS;
+    pcsample_status_t status      = PCSAMPLE_STATUS_SUCCESS;
+    const auto        dispatches = corr_map->view(device);
     for(uint64_t p = 0; p < available_samples; p++)
     {
         const auto* snap = reinterpret_cast<const perf_sample_snapshot_v1*>(buffer + p);
         samples[p]       = copySample<bHostTrap, GFXIP>((const void*) (buffer + p));
         samples[p].size  = sizeof(rocprofiler_pc_sampling_record_t);
-        try
-        {
-            Parser::trap_correlation_id_t trap{.raw = snap->correlation_id};
-            samples[p].correlation_id = corr_map->get(device, trap);
-        } catch(std::exception& e)
+
+        Parser::trap_correlation_id_t trap{.raw = snap->correlation_id};
+        if(!dispatches.get(trap, samples[p].correlation_id))
         {
             samples[p].correlation_id = {.internal = ROCPROFILER_CORRELATION_ID_INTERNAL_NONE,
                                          .external = rocprofiler_user_data_t{
@@ -207,13 +390,42 @@ add_upcoming_samples(const device_handle               device,
     return status;
 }
 
+/**
+ * @brief Same as add_upcoming_samples() above, but large chunks are split into contiguous ranges
+ * translated concurrently by the worker pool. Every range writes to the same offsets it reads
+ * from, hence the output is identical to the serial version.
+ */
+template <bool bHostTrap, typename GFXIP>
+inline pcsample_status_t
+add_upcoming_samples(const device_handle               device,
+                     const generic_sample_t*           buffer,
+                     const size_t                      available_samples,
+                     const Parser::CorrelationMap*     corr_map,
+                     rocprofiler_pc_sampling_record_t* samples,
+                     Parser::WorkerPool*               pool)
+{
+    if(!pool || available_samples < 2 * Parser::WorkerPool::min_grain_size)
+        return add_upcoming_samples<bHostTrap, GFXIP>(
+            device, buffer, available_samples, corr_map, samples);
+
+    std::atomic<pcsample_status_t> status{PCSAMPLE_STATUS_SUCCESS};
+    pool->parallel_for(
+        available_samples, Parser::WorkerPool::min_grain_size, [&](size_t begin, size_t end) {
+            auto _status = add_upcoming_samples<bHostTrap, GFXIP>(
+                device, buffer + begin, end - begin, corr_map, samples + begin);
+            if(_status != PCSAMPLE_STATUS_SUCCESS) status.fetch_or(_status);
+        });
+    return status.load();
+}
+
 template <typename GFXIP>
 inline pcsample_status_t
 _parse_buffer(generic_sample_t*       buffer,
               uint64_t                buffer_size,
               user_callback_t         callback,
               void*                   userdata,
-              Parser::CorrelationMap* corr_map)
+              Parser::CorrelationMap* corr_map,
+              Parser::WorkerPool*     pool)
 {
     // Maximum size
     uint64_t index = 0;
@@ -253,12 +465,12 @@ _parse_buffer(generic_sample_t*       buffer,
                     if(bIsHostTrap)
                     {
                         status |= add_upcoming_samples<true, GFXIP>(
-                            pkt.device, buffer + index, available_samples, corr_map, samples);
+                            pkt.device, buffer + index, available_samples, corr_map, samples, pool);
                     }
                     else
                     {
                         status |= add_upcoming_samples<false, GFXIP>(
-                            pkt.device, buffer + index, available_samples, corr_map, samples);
+                            pkt.device, buffer + index, available_samples, corr_map, samples, pool);
                     }
 
                     index += available_samples;
@@ -288,12 +500,14 @@ _parse_buffer(generic_sample_t*       buffer,
  * parse_buffer() will return PCSAMPLE_STATUS_CALLBACK_ERROR. If the callback returns
  * a size smaller than requested, then it may be called again requesting more memory.
  * @param[in] userdata parameter forwarded to the user callback.
+ * @param[in] pool [optional] Worker pool used to translate large chunks of samples concurrently.
  */
-pcsample_status_t inline parse_buffer(generic_sample_t* buffer,
-                                      uint64_t          buffer_size,
-                                      int               gfxip_major,
-                                      user_callback_t   callback,
-                                      void*             userdata)
+pcsample_status_t inline parse_buffer(generic_sample_t*   buffer,
+                                      uint64_t            buffer_size,
+                                      int                 gfxip_major,
+                                      user_callback_t     callback,
+                                      void*               userdata,
+                                      Parser::WorkerPool* pool = nullptr)
 {
     static auto corr_map = std::make_unique<Parser::CorrelationMap>();
 
@@ -305,5 +519,5 @@ pcsample_status_t inline parse_buffer(generic_sample_t* buffer,
     else
         return PCSAMPLE_STATUS_INVALID_GFXIP;
 
-    return parseSample_func(buffer, buffer_size, callback, userdata, corr_map.get());
+    return parseSample_func(buffer, buffer_size, callback, userdata, corr_map.get(), pool);
 };
@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <rocprofiler-sdk/fwd.h>
+#include <rocprofiler-sdk/pc_sampling.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Parser
+{
+/**
+ * @brief Concurrent histogram of PC samples, used when samples are aggregated instead of being
+ * delivered one record per sample. Bins are keyed by PC and, optionally, by the internal
+ * correlation id of the dispatch. The table is split in shards, each protected by its own mutex,
+ * and every call to add() pre-aggregates its samples so a shard is locked at most once per call.
+ */
+class PCSampleHistogram
+{
+public:
+    struct bin_t
+    {
+        uint64_t                     pc             = 0;
+        rocprofiler_correlation_id_t correlation_id = {};
+        uint64_t                     count          = 0;
+    };
+
+    explicit PCSampleHistogram(bool _per_dispatch)
+    : per_dispatch(_per_dispatch)
+    {}
+
+    bool is_per_dispatch() const { return per_dispatch; }
+
+    //! Adds the given samples to the histogram. Can be called concurrently.
+    void add(const rocprofiler_pc_sampling_record_t* samples, size_t num_samples)
+    {
+        thread_local auto local  = std::unordered_map<bin_key, bin_t, key_hash>{};
+        thread_local auto sorted = std::array<std::vector<const bin_t*>, num_shards>{};
+
+        local.clear();
+        for(size_t i = 0; i < num_samples; i++)
+        {
+            auto  key = make_key(samples[i]);
+            auto& bin = local[key];
+            if(bin.count++ == 0)
+            {
+                bin.pc             = samples[i].pc;
+                bin.correlation_id = per_dispatch ? samples[i].correlation_id : none_id();
+            }
+        }
+
+        for(auto& itr : sorted)
+            itr.clear();
+        for(const auto& itr : local)
+            sorted[key_hash{}(itr.first) % num_shards].emplace_back(&itr.second);
+
+        for(size_t s = 0; s < num_shards; s++)
+        {
+            if(sorted[s].empty()) continue;
+
+            auto& _shard = shards[s];
+            auto  lk     = std::unique_lock<std::mutex>{_shard.mut};
+            for(const auto* itr : sorted[s])
+            {
+                auto& bin = _shard.bins[bin_key{itr->pc, itr->correlation_id.internal}];
+                if(bin.count == 0)
+                {
+                    bin.pc             = itr->pc;
+                    bin.correlation_id = itr->correlation_id;
+                }
+                bin.count += itr->count;
+            }
+        }
+    }
+
+    /**
+     * @brief Moves the bins out of the histogram, leaving it empty.
+     * Samples added concurrently end up either in the returned bins or in the next drain().
+     */
+    std::vector<bin_t> drain()
+    {
+        auto _bins = std::vector<bin_t>{};
+        for(auto& _shard : shards)
+        {
+            auto lk = std::unique_lock<std::mutex>{_shard.mut};
+            _bins.reserve(_bins.size() + _shard.bins.size());
+            for(const auto& itr : _shard.bins)
+                _bins.emplace_back(itr.second);
+            _shard.bins.clear();
+        }
+        return _bins;
+    }
+
+private:
+    static constexpr size_t num_shards = 32;
+
+    struct bin_key
+    {
+        uint64_t pc             = 0;
+        uint64_t correlation_id = 0;
+
+        bool operator==(const bin_key& rhs) const
+        {
+            return pc == rhs.pc && correlation_id == rhs.correlation_id;
+        }
+    };
+
+    struct key_hash
+    {
+        size_t operator()(const bin_key& k) const
+        {
+            // Instructions are at least 4B aligned
+            return (k.pc >> 2) ^ (k.correlation_id * 0x9E3779B97F4A7C15ul);
+        }
+    };
+
+    struct alignas(64) shard
+    {
+        std::mutex                                   mut  = {};
+        std::unordered_map<bin_key, bin_t, key_hash> bins = {};
+    };
+
+    static rocprofiler_correlation_id_t none_id()
+    {
+        return {.internal = ROCPROFILER_CORRELATION_ID_INTERNAL_NONE,
+                .external = rocprofiler_user_data_t{.value = 0}};
+    }
+
+    bin_key make_key(const rocprofiler_pc_sampling_record_t& sample) const
+    {
+        return bin_key{sample.pc,
+                     per_dispatch ? sample.correlation_id.internal
+                                  : ROCPROFILER_CORRELATION_ID_INTERNAL_NONE};
+    }
+
+    const bool                    per_dispatch;
+    std::array<shard, num_shards> shards = {};
+};
+}  // namespace Parser
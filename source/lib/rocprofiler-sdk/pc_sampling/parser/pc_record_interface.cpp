@@ -21,16 +21,8 @@
 // SOFTWARE.
 
 #include "lib/rocprofiler-sdk/pc_sampling/parser/pc_record_interface.hpp"
-
-uint64_t
-PCSamplingParserContext::alloc(rocprofiler_pc_sampling_record_t** buffer, uint64_t size)
-{
-    std::unique_lock<std::shared_mutex> lock(mut);
-    assert(buffer != nullptr);
-    data.emplace_back(std::make_unique<PCSamplingData>(size));
-    *buffer = data.back()->samples.data();
-    return size;
-}
+#include "lib/common/environment.hpp"
+#include "lib/rocprofiler-sdk/internal_threading.hpp"
 
 pcsample_status_t
 PCSamplingParserContext::parse(const upcoming_samples_t& upcoming,
@@ -69,6 +61,13 @@ PCSamplingParserContext::completeDispatch(uint64_t correlation_id)
     forget_list.emplace(correlation_id);
 }
 
+void
+PCSamplingParserContext::completeDispatches(const std::vector<uint64_t>& correlation_ids)
+{
+    std::unique_lock<std::shared_mutex> lock(mut);
+    forget_list.insert(correlation_ids.begin(), correlation_ids.end());
+}
+
 pcsample_status_t
 PCSamplingParserContext::flushForgetList()
 {
@@ -98,20 +97,35 @@ PCSamplingParserContext::shouldFlipRocrBuffer(const dispatch_pkt_id_t& pkt) cons
     return corr_map->checkDispatch(pkt);
 }
 
-void
-PCSamplingParserContext::generate_upcoming_pc_record(
-    uint64_t                                agent_id_handle,
-    const rocprofiler_pc_sampling_record_t* samples,
-    size_t                                  num_samples)
+rocprofiler::buffer::instance*
+PCSamplingParserContext::get_agent_buffer(uint64_t agent_id_handle) const
 {
-    auto buff_id = _agent_buffers.at(rocprofiler_agent_id_t{agent_id_handle});
+    rocprofiler_buffer_id_t buff_id = {};
+    {
+        std::shared_lock<std::shared_mutex> lock(mut);
+        auto itr = _agent_buffers.find(rocprofiler_agent_id_t{agent_id_handle});
+        if(itr == _agent_buffers.end()) return nullptr;
+        buff_id = itr->second;
+    }
+
     rocprofiler::buffer::instance* buff = rocprofiler::buffer::get_buffer(buff_id);
 
     if(!buff)
         throw std::runtime_error(fmt::format("Buffer with id: {} does not exists", buff_id.handle));
 
-    for(size_t i = 0; i < num_samples; i++)
-        buff->emplace(ROCPROFILER_BUFFER_CATEGORY_PC_SAMPLING,
-                      ROCPROFILER_PC_SAMPLING_RECORD_SAMPLE,
-                      samples[i]);
+    return buff;
+}
+
+std::unique_ptr<Parser::WorkerPool>
+PCSamplingParserContext::make_worker_pool()
+{
+    // zero workers parses the samples serially on the thread delivering them
+    auto num_threads = rocprofiler::common::get_env("ROCPROFILER_PC_SAMPLING_PARSER_THREADS", 0);
+
+    if(num_threads <= 0) return nullptr;
+
+    rocprofiler::internal_threading::notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+    auto _pool = std::make_unique<Parser::WorkerPool>(num_threads);
+    rocprofiler::internal_threading::notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+    return _pool;
 }
@@ -24,6 +24,7 @@
 
 #include "lib/rocprofiler-sdk/buffer.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/correlation.hpp"
+#include "lib/rocprofiler-sdk/pc_sampling/parser/histogram.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/parser_types.h"
 
 #include <rocprofiler-sdk/fwd.h>
@@ -40,32 +41,22 @@
 #include <shared_mutex>
 #include <thread>
 #include <unordered_set>
-
-struct PCSamplingData
-{
-    PCSamplingData(size_t size)
-    : samples(size){};
-    PCSamplingData& operator=(PCSamplingData&) = delete;
-
-    std::vector<rocprofiler_pc_sampling_record_t> samples;
-};
+#include <vector>
 
 class PCSamplingParserContext
 {
 public:
     PCSamplingParserContext()
-    : corr_map(std::make_unique<Parser::CorrelationMap>()){};
-    /**
-     * @brief Allocates some memory. TODO: Translate to Jonathan's buffer implementation.
-     * @param[out] buffer Pointer where samples are to be written to.
-     * @param[in] size Number of samples requested.
-     * @returns Number of samples actually allocated on *buffer.
-     */
-    uint64_t alloc(rocprofiler_pc_sampling_record_t** buffer, uint64_t size);
+    : corr_map(std::make_unique<Parser::CorrelationMap>())
+    , pool(make_worker_pool()){};
 
     /**
      * @brief Parses a chunk of samples.
      * Call only finishes when all pc sampling records have been generated on the user buffer.
+     * Records are translated into a scratch buffer and then copied into the SDK buffer
+     * registered for the agent, so the SDK buffer is not held while samples are translated.
+     * Large chunks are split across the parser worker pool (if enabled), keeping the order of
+     * the samples in the SDK buffer.
      * As an intermediate step, "midway_signal" signals when it's safe to reuse/delete "data".
      * @param[in] upcoming Metadata of upcoming samples
      * @param[in] data Pointer containing the raw hardware samples. Must match upcoming.num_samples.
@@ -76,7 +67,8 @@ public:
      * @returns PCSAMPLE_STATUS_PARSER_ERROR (non-fatal) if one or more samples has invalid
      * correlation ID(s).
      * @returns PCSAMPLE_STATUS_INVALID_GFXIP (fatal) on GFXIP != 9,11,12.
-     * @returns PCSAMPLE_STATUS_CALLBACK_ERROR (fatal) if memory allocation fails.
+     * @returns PCSAMPLE_STATUS_CALLBACK_ERROR (fatal) if no SDK buffer is registered for the
+     * device.
      */
     pcsample_status_t parse(const upcoming_samples_t& upcoming,
                             const generic_sample_t*   data,
@@ -89,6 +81,11 @@ public:
      * @param[in] correlation_id Correlation ID of the completed dispatch.
      */
     void completeDispatch(uint64_t correlation_id);
+    /**
+     * @brief Signals the completion of several dispatches, taking the lock once.
+     * @param[in] correlation_ids Correlation IDs of the completed dispatches.
+     */
+    void completeDispatches(const std::vector<uint64_t>& correlation_ids);
     /**
      * @brief Signals a new dispatch was started.
      * Please use shouldFlipRocrBuffer() to check if the buffer must be flipped before forwarding
@@ -104,6 +101,28 @@ public:
      */
     bool shouldFlipRocrBuffer(const dispatch_pkt_id_t& pkt) const;
 
+    /**
+     * @brief Selects whether samples are delivered as records or aggregated into a histogram.
+     * Must be called before any sample is parsed.
+     */
+    void set_output_mode(rocprofiler_pc_sampling_output_mode_t mode)
+    {
+        histogram.reset();
+        if(mode != ROCPROFILER_PC_SAMPLING_OUTPUT_MODE_RECORDS)
+            histogram = std::make_unique<Parser::PCSampleHistogram>(
+                mode == ROCPROFILER_PC_SAMPLING_OUTPUT_MODE_HISTOGRAM_PER_DISPATCH);
+    }
+
+    /**
+     * @brief Moves out the bins aggregated so far.
+     * @returns empty if samples are delivered as records.
+     */
+    std::vector<Parser::PCSampleHistogram::bin_t> drainHistogram() const
+    {
+        if(!histogram) return {};
+        return histogram->drain();
+    }
+
     bool register_buffer_for_agent(rocprofiler_buffer_id_t buffer_id,
                                    rocprofiler_agent_id_t  agent_id)
     {
@@ -133,28 +152,46 @@ protected:
         // std::shared_lock<std::shared_mutex> lock(mut);
 
         pcsample_status_t status      = PCSAMPLE_STATUS_SUCCESS;
-        uint64_t          pkt_counter = upcoming.num_samples;
         auto              dev         = upcoming.device;
         bool              bIsHostTrap = upcoming.which_sample_type == AMD_HOST_TRAP_V1;
-
-        while(pkt_counter > 0)
+        auto*             map         = corr_map.get();
+        auto*             buff        = get_agent_buffer(dev.handle);
+
+        if(!buff) return PCSAMPLE_STATUS_CALLBACK_ERROR;
+
+        // Samples are translated into a scratch buffer reused across calls, outside of the SDK
+        // buffer: a flush of the SDK buffer only waits for the copy of the records, not for their
+        // translation. The scratch is only grown here, before the pool workers are handed a
+        // pointer into it, and parallel_for() returns once all of them are done
+        std::unique_lock<std::mutex> lk(scratch_mut);
+        if(scratch.size() < upcoming.num_samples) scratch.resize(upcoming.num_samples);
+
+        auto* samples = scratch.data();
+        if(bIsHostTrap)
+            status |= add_upcoming_samples<true, GFX>(
+                dev, data_, upcoming.num_samples, map, samples, pool.get());
+        else
+            status |= add_upcoming_samples<false, GFX>(
+                dev, data_, upcoming.num_samples, map, samples, pool.get());
+
+        if(histogram)
         {
-            rocprofiler_pc_sampling_record_t* samples = nullptr;
-            uint64_t                          memsize = alloc(&samples, pkt_counter);
-
-            if(memsize == 0 || memsize > pkt_counter) return PCSAMPLE_STATUS_CALLBACK_ERROR;
-
-            auto* map = corr_map.get();
-            if(bIsHostTrap)
-                status |= add_upcoming_samples<true, GFX>(dev, data_, memsize, map, samples);
-            else
-                status |= add_upcoming_samples<false, GFX>(dev, data_, memsize, map, samples);
-
-            data_ += memsize;
-            pkt_counter -= memsize;
-            generate_upcoming_pc_record(dev.handle, samples, memsize);
+            histogram->add(samples, upcoming.num_samples);
+            return status;
         }
 
+        // Invoked with uninitialized space reserved inside the SDK buffer. May be called
+        // multiple times if the buffer had to be flushed while placing the samples. Samples which
+        // do not fit are counted in the drop count of the SDK buffer
+        buff->emplace_n<rocprofiler_pc_sampling_record_t>(
+            ROCPROFILER_BUFFER_CATEGORY_PC_SAMPLING,
+            ROCPROFILER_PC_SAMPLING_RECORD_SAMPLE,
+            upcoming.num_samples,
+            [&samples](rocprofiler_pc_sampling_record_t* records, size_t num) {
+                std::uninitialized_copy_n(samples, num, records);
+                samples += num;
+            });
+
         return status;
     }
 
@@ -164,20 +201,36 @@ protected:
      */
     pcsample_status_t flushForgetList();
     static void       generate_id_completion_record(const dispatch_pkt_id_t& pkt) { (void) pkt; };
-    void              generate_upcoming_pc_record(uint64_t                                agent_id_handle,
-                                                  const rocprofiler_pc_sampling_record_t* samples,
-                                                  size_t                                  num_samples);
+
+    /**
+     * @brief Returns the SDK buffer where the samples of the agent are placed.
+     * @returns nullptr if no buffer is registered for the agent.
+     */
+    rocprofiler::buffer::instance* get_agent_buffer(uint64_t agent_id_handle) const;
+
+    /**
+     * @brief Creates the worker pool of a parser.
+     * The number of workers is set by ROCPROFILER_PC_SAMPLING_PARSER_THREADS and defaults to
+     * zero, i.e. the pool is opt-in.
+     * @returns nullptr if samples are to be parsed serially.
+     */
+    static std::unique_ptr<Parser::WorkerPool> make_worker_pool();
 
     //! Maps doorbells and dispatch_index to correlation_id
     std::unique_ptr<Parser::CorrelationMap> corr_map;
-    //! Data allocated to store samples. Temporary.
-    std::vector<std::unique_ptr<PCSamplingData>> data;
     //! Dispatches not yet completed.
     // Uses only the internal correlation_id.
     std::unordered_map<uint64_t, dispatch_pkt_id_t> active_dispatches;
     //! List of correlation ids whose dispatches have been completed and can be forgotten after the
     //! buffer flip.
     std::unordered_set<uint64_t> forget_list;
+    //! Translates large chunks of samples concurrently. Workers are joined with the parser
+    std::unique_ptr<Parser::WorkerPool> pool;
+    //! Aggregates the samples when using one of the histogram output modes
+    std::unique_ptr<Parser::PCSampleHistogram> histogram;
+    //! Samples translated before being placed in the SDK buffer or binned. Only ever grows
+    std::vector<rocprofiler_pc_sampling_record_t> scratch;
+    std::mutex                                    scratch_mut;
 
     mutable std::shared_mutex mut;
 
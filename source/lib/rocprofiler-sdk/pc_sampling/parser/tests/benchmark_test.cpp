@@ -30,16 +30,19 @@
 /**
  * Benchmarks how fast the parser can process samples on a single threaded case
  * Current: 5600X with -Ofast, up to >140 million samples/s or ~9GB/s R/W (18GB/s bidirectional)
+ * When bInterleaved is set, consecutive samples belong to different dispatches of many queues,
+ * which represents samples collected from many concurrent queues.
+ * When a pool is given, the samples are translated by the pool workers and the calling thread.
  */
 static bool
-Benchmark(bool bWarmup)
+Benchmark(bool bWarmup, bool bInterleaved = false, Parser::WorkerPool* pool = nullptr)
 {
-    constexpr size_t SAMPLE_PER_DISPATCH = 8192;
     constexpr size_t DISP_PER_QUEUE      = 12;
-    constexpr size_t NUM_QUEUES          = MockDoorBell::num_unique_bells;
+    const size_t     SAMPLE_PER_DISPATCH = bInterleaved ? 512 : 8192;
+    const size_t     NUM_QUEUES          = bInterleaved ? MockDoorBell::num_unique_bells : 4;
 
-    std::shared_ptr<MockRuntimeBuffer> buffer = std::make_shared<MockRuntimeBuffer>();
-    std::array<std::vector<std::shared_ptr<MockDispatch>>, NUM_QUEUES> active_dispatches;
+    auto buffer            = std::make_shared<MockRuntimeBuffer>();
+    auto active_dispatches = std::vector<std::vector<std::shared_ptr<MockDispatch>>>(NUM_QUEUES);
 
     for(size_t q = 0; q < NUM_QUEUES; q++)
     {
@@ -48,13 +51,23 @@ Benchmark(bool bWarmup)
             active_dispatches[q].push_back(std::make_shared<MockDispatch>(queue));
     }
 
-    constexpr size_t TOTAL_NUM_SAMPLES = NUM_QUEUES * DISP_PER_QUEUE * SAMPLE_PER_DISPATCH;
+    const size_t TOTAL_NUM_SAMPLES = NUM_QUEUES * DISP_PER_QUEUE * SAMPLE_PER_DISPATCH;
     buffer->genUpcomingSamples(TOTAL_NUM_SAMPLES);
 
-    for(auto& queue : active_dispatches)
-        for(auto& dispatch : queue)
-            for(size_t i = 0; i < SAMPLE_PER_DISPATCH; i++)
-                MockWave(dispatch).genPCSample();
+    if(bInterleaved)
+    {
+        for(size_t i = 0; i < SAMPLE_PER_DISPATCH; i++)
+            for(size_t d = 0; d < DISP_PER_QUEUE; d++)
+                for(auto& queue : active_dispatches)
+                    MockWave(queue[d]).genPCSample();
+    }
+    else
+    {
+        for(auto& queue : active_dispatches)
+            for(auto& dispatch : queue)
+                for(size_t i = 0; i < SAMPLE_PER_DISPATCH; i++)
+                    MockWave(dispatch).genPCSample();
+    }
 
     std::pair<rocprofiler_pc_sampling_record_t*, size_t> userdata;
     userdata.first  = new rocprofiler_pc_sampling_record_t[TOTAL_NUM_SAMPLES];
@@ -68,18 +81,21 @@ Benchmark(bool bWarmup)
         [](rocprofiler_pc_sampling_record_t** sample, uint64_t size, void* userdata_) {
             auto* pair =
                 reinterpret_cast<std::pair<rocprofiler_pc_sampling_record_t*, size_t>*>(userdata_);
-            assert(TOTAL_NUM_SAMPLES == pair->second);
+            assert(size == pair->second);
             *sample = pair->first;
             return size;
         },
-        &userdata));
+        &userdata,
+        pool));
     auto  t1             = std::chrono::system_clock::now();
     float samples_per_us = float(TOTAL_NUM_SAMPLES) / (t1 - t0).count() * 1E3f;
 
     if(!bWarmup)
     {
-        std::cout << "Benchmark: Parsed " << int(samples_per_us * 1E3f + 0.5f) * 1E-3f
-                  << " Msample/s (";
+        std::cout << "Benchmark";
+        if(bInterleaved) std::cout << " (interleaved queues)";
+        if(pool) std::cout << " (" << pool->size() + 1 << " threads)";
+        std::cout << ": Parsed " << int(samples_per_us * 1E3f + 0.5f) * 1E-3f << " Msample/s (";
         std::cout << int(sizeof(rocprofiler_pc_sampling_record_t) * samples_per_us) << " MB/s)"
                   << std::endl;
     }
@@ -94,3 +110,19 @@ TEST(pcs_parser, benchmark_test)
     EXPECT_EQ(Benchmark(false), true);
     EXPECT_EQ(Benchmark(false), true);
 }
+
+TEST(pcs_parser, benchmark_interleaved_test)
+{
+    EXPECT_EQ(Benchmark(true, true), true);
+    EXPECT_EQ(Benchmark(false, true), true);
+    EXPECT_EQ(Benchmark(false, true), true);
+}
+
+TEST(pcs_parser, benchmark_parallel_test)
+{
+    Parser::WorkerPool pool{3};
+
+    EXPECT_EQ(Benchmark(true, false, &pool), true);
+    EXPECT_EQ(Benchmark(false, false, &pool), true);
+    EXPECT_EQ(Benchmark(false, true, &pool), true);
+}
@@ -23,9 +23,15 @@
 #include <gtest/gtest.h>
 #include <cstddef>
 
+#include "lib/rocprofiler-sdk/pc_sampling/parser/histogram.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/pc_record_interface.hpp"
 #include "lib/rocprofiler-sdk/pc_sampling/parser/tests/mocks.hpp"
 
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 #define GFXIP_MAJOR 9
 
 std::mt19937 rdgen(1);
@@ -215,6 +221,101 @@ TEST(pcs_parser, random_samples)
     }
 }
 
+/**
+ * Same as random_samples, but with enough samples for the chunk to be split across a worker pool.
+ */
+TEST(pcs_parser, parallel_random_samples)
+{
+    const int                          num_samples = 16 * Parser::WorkerPool::min_grain_size;
+    std::shared_ptr<MockRuntimeBuffer> buffer      = std::make_shared<MockRuntimeBuffer>();
+    std::shared_ptr<MockQueue>         queue1      = std::make_shared<MockQueue>(16, buffer);
+    std::shared_ptr<MockQueue>         queue2      = std::make_shared<MockQueue>(16, buffer);
+
+    std::vector<std::shared_ptr<MockDispatch>> dispatches;
+    dispatches.push_back(std::make_shared<MockDispatch>(queue1));
+    dispatches.push_back(std::make_shared<MockDispatch>(queue2));
+    dispatches.push_back(std::make_shared<MockDispatch>(queue1));
+    dispatches.push_back(std::make_shared<MockDispatch>(queue2));
+
+    buffer->genUpcomingSamples(num_samples);
+    for(int i = 0; i < num_samples; i++)
+        MockWave(dispatches[rdgen() % dispatches.size()]).genPCSample();
+
+    std::vector<std::pair<rocprofiler_pc_sampling_record_t*, uint64_t>> all_allocations;
+
+    Parser::WorkerPool pool{3};
+    CHECK_PARSER(parse_buffer((generic_sample_t*) buffer->packets.data(),
+                              buffer->packets.size(),
+                              GFXIP_MAJOR,
+                              alloc_callback,
+                              (void*) &all_allocations,
+                              &pool));
+
+    EXPECT_EQ(all_allocations.size(), 1);
+    for(auto& sample : all_allocations)
+    {
+        EXPECT_EQ(sample.second, num_samples);
+        EXPECT_EQ(check_samples(sample.first, sample.second), true);
+        delete[] sample.first;
+    }
+}
+
+/**
+ * Bins parsed samples from two threads and checks every sample is counted in the bin of its
+ * dispatch. The mocks store the dispatch unique_id in the pc field.
+ */
+TEST(pcs_parser, histogram)
+{
+    const int                          num_samples = 4096;
+    std::shared_ptr<MockRuntimeBuffer> buffer      = std::make_shared<MockRuntimeBuffer>();
+    std::shared_ptr<MockQueue>         queue1      = std::make_shared<MockQueue>(16, buffer);
+    std::shared_ptr<MockQueue>         queue2      = std::make_shared<MockQueue>(16, buffer);
+
+    std::vector<std::shared_ptr<MockDispatch>> dispatches;
+    dispatches.push_back(std::make_shared<MockDispatch>(queue1));
+    dispatches.push_back(std::make_shared<MockDispatch>(queue2));
+    dispatches.push_back(std::make_shared<MockDispatch>(queue1));
+
+    buffer->genUpcomingSamples(num_samples);
+    for(int i = 0; i < num_samples; i++)
+        MockWave(dispatches[rdgen() % dispatches.size()]).genPCSample();
+
+    std::vector<std::pair<rocprofiler_pc_sampling_record_t*, uint64_t>> all_allocations;
+
+    CHECK_PARSER(parse_buffer((generic_sample_t*) buffer->packets.data(),
+                              buffer->packets.size(),
+                              GFXIP_MAJOR,
+                              alloc_callback,
+                              (void*) &all_allocations));
+    ASSERT_EQ(all_allocations.size(), 1);
+
+    const auto* samples  = all_allocations.front().first;
+    auto        expected = std::unordered_map<uint64_t, uint64_t>{};
+    for(int i = 0; i < num_samples; i++)
+        expected[samples[i].pc]++;
+
+    for(bool per_dispatch : {false, true})
+    {
+        Parser::PCSampleHistogram histogram{per_dispatch};
+
+        std::thread worker([&]() { histogram.add(samples, num_samples / 2); });
+        histogram.add(samples + num_samples / 2, num_samples - num_samples / 2);
+        worker.join();
+
+        auto bins = histogram.drain();
+        EXPECT_EQ(bins.size(), expected.size());
+        for(const auto& bin : bins)
+        {
+            EXPECT_EQ(bin.count, expected.at(bin.pc));
+            EXPECT_EQ(bin.correlation_id.internal,
+                      per_dispatch ? bin.pc : ROCPROFILER_CORRELATION_ID_INTERNAL_NONE);
+        }
+        EXPECT_EQ(histogram.drain().size(), 0);
+    }
+
+    delete[] all_allocations.front().first;
+}
+
 /**
  * Hammers the parser by creating and destrying queues at random, adding dispatches at random
  * and generating PC samples at random. By default we use all 4 unique doorbells,
@@ -224,7 +325,7 @@ TEST(pcs_parser, queue_hammer)
 {
     constexpr int NUM_ACTIONS = 10000;
     constexpr int QSIZE       = 16;
-    constexpr int NUM_QUEUES  = MockDoorBell::num_unique_bells;
+    constexpr int NUM_QUEUES  = 4;
     constexpr int ACTION_MAX  = QSIZE * NUM_QUEUES / 2;
 
     std::shared_ptr<MockRuntimeBuffer> buffer = std::make_shared<MockRuntimeBuffer>();
@@ -351,3 +452,112 @@ TEST(pcs_parser, multi_buffer)
     delete[] all_allocations[0].first;
     delete[] all_allocations[1].first;
 };
+
+/**
+ * Looks up correlation ids while new dispatches keep adding slots to the same queue.
+ * Slots handed to the readers must stay valid while the queue grows.
+ */
+TEST(pcs_parser, concurrent_lookup)
+{
+    constexpr uint64_t num_dispatches = 1 << 16;
+    constexpr uint64_t queue_size     = 1 << 20;
+    constexpr uint64_t doorbell       = 3 << 3;
+    const auto         device         = device_handle{1};
+
+    Parser::CorrelationMap map;
+    std::atomic<bool>      done{false};
+    std::atomic<uint64_t>  mismatches{0};
+
+    auto reader = std::thread{[&]() {
+        while(!done.load())
+        {
+            for(uint64_t i = 0; i < num_dispatches; i += 61)
+            {
+                auto trap = Parser::CorrelationMap::trap_correlation_id(doorbell, i, queue_size);
+                auto corr = rocprofiler_correlation_id_t{};
+                if(map.get(device, trap, corr) && corr.internal != i + 1) ++mismatches;
+            }
+        }
+    }};
+
+    for(uint64_t i = 0; i < num_dispatches; i++)
+    {
+        dispatch_pkt_id_t pkt{};
+        pkt.device                  = device;
+        pkt.doorbell_id             = doorbell;
+        pkt.write_index             = i;
+        pkt.queue_size              = queue_size;
+        pkt.correlation_id.internal = i + 1;
+        map.newDispatch(pkt);
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_EQ(mismatches.load(), 0);
+    for(uint64_t i = 0; i < num_dispatches; i++)
+    {
+        auto trap = Parser::CorrelationMap::trap_correlation_id(doorbell, i, queue_size);
+        auto corr = rocprofiler_correlation_id_t{};
+        ASSERT_TRUE(map.get(device, trap, corr));
+        EXPECT_EQ(corr.internal, i + 1);
+    }
+}
+
+/**
+ * Rewrites the same slots (small queue, the dispatch index wraps) while readers look them up.
+ * The internal and external ids of a slot are written together, a reader must never observe the
+ * internal id of one dispatch with the external id of another.
+ */
+TEST(pcs_parser, concurrent_slot_rewrite)
+{
+    constexpr uint64_t num_dispatches = 1 << 18;
+    constexpr uint64_t queue_size     = 16;
+    constexpr uint64_t doorbell       = 5 << 3;
+    constexpr size_t   num_readers    = 2;
+    const auto         device         = device_handle{1};
+
+    Parser::CorrelationMap map;
+    std::atomic<bool>      done{false};
+    std::atomic<uint64_t>  torn{0};
+    std::atomic<uint64_t>  found{0};
+
+    auto readers = std::vector<std::thread>{};
+    for(size_t n = 0; n < num_readers; ++n)
+    {
+        readers.emplace_back([&]() {
+            while(!done.load())
+            {
+                for(uint64_t i = 0; i < queue_size; ++i)
+                {
+                    auto trap =
+                        Parser::CorrelationMap::trap_correlation_id(doorbell, i, queue_size);
+                    auto corr = rocprofiler_correlation_id_t{};
+                    if(!map.get(device, trap, corr)) continue;
+                    ++found;
+                    if(corr.external.value != ~corr.internal ||
+                       (corr.internal - 1) % queue_size != i)
+                        ++torn;
+                }
+            }
+        });
+    }
+
+    for(uint64_t i = 0; i < num_dispatches; i++)
+    {
+        dispatch_pkt_id_t pkt{};
+        pkt.device                        = device;
+        pkt.doorbell_id                   = doorbell;
+        pkt.write_index                   = i;
+        pkt.queue_size                    = queue_size;
+        pkt.correlation_id.internal       = i + 1;
+        pkt.correlation_id.external.value = ~(i + 1);
+        map.newDispatch(pkt);
+        if(i % 7 == 0) map.forget(pkt);
+    }
+    done.store(true);
+    for(auto& itr : readers)
+        itr.join();
+
+    EXPECT_GT(found.load(), 0);
+    EXPECT_EQ(torn.load(), 0);
+}
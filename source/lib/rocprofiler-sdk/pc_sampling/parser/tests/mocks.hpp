@@ -107,7 +107,7 @@ public:
     ~MockDoorBell() { available_ids.insert(handler); }
 
     const size_t            handler;
-    static constexpr size_t num_unique_bells = 4;
+    static constexpr size_t num_unique_bells = 64;
 
 private:
     static size_t getUniqueId()
@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Parser
+{
+/**
+ * @brief Fixed-size pool of threads used to translate large chunks of samples concurrently.
+ * The thread calling parallel_for() also processes work, hence a pool without workers is serial.
+ * Only one parallel_for() runs at a time: concurrent callers fall back to serial processing
+ * instead of waiting on each other.
+ */
+class WorkerPool
+{
+public:
+    //! Chunks smaller than this are not worth the synchronization cost
+    static constexpr size_t min_grain_size = 4096;
+
+    explicit WorkerPool(size_t num_workers)
+    {
+        threads.reserve(num_workers);
+        for(size_t i = 0; i < num_workers; ++i)
+            threads.emplace_back(&WorkerPool::run, this);
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::unique_lock<std::mutex> lk(mut);
+            stop = true;
+        }
+        start_cv.notify_all();
+        for(auto& itr : threads)
+            itr.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&)      = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    size_t size() const { return threads.size(); }
+
+    /**
+     * @brief Splits [0, num) into contiguous ranges of at least grain elements and invokes
+     * func(begin, end) once per range. Returns when all ranges have been processed.
+     * Ranges never overlap, so writing the output of [begin, end) to the same offsets as the
+     * input keeps the ordering of the serial version.
+     */
+    template <typename FuncT>
+    void parallel_for(size_t num, size_t grain, FuncT&& func)
+    {
+        grain             = std::max<size_t>(grain, 1);
+        size_t num_ranges = std::min(threads.size() + 1, (num + grain - 1) / grain);
+
+        std::unique_lock<std::mutex> busy(dispatch_mut, std::try_to_lock);
+        if(num_ranges < 2 || !busy.owns_lock())
+        {
+            if(num > 0) func(size_t{0}, num);
+            return;
+        }
+
+        size_t range_size = (num + num_ranges - 1) / num_ranges;
+        auto   task       = [&](size_t idx) {
+            size_t begin = idx * range_size;
+            size_t end   = std::min(num, begin + range_size);
+            if(begin < end) func(begin, end);
+        };
+
+        {
+            std::unique_lock<std::mutex> lk(mut);
+            job       = task;
+            num_tasks = num_ranges;
+            next_task.store(0, std::memory_order_relaxed);
+            ++generation;
+        }
+        start_cv.notify_all();
+
+        execute(task, num_ranges);
+
+        // Workers which joined this job may still be running a range which captures locals
+        std::unique_lock<std::mutex> lk(mut);
+        done_cv.wait(lk, [this]() { return active == 0; });
+        job = nullptr;
+    }
+
+private:
+    //! Claims and runs ranges of the current job until none are left
+    template <typename JobT>
+    void execute(const JobT& _job, size_t _num_tasks)
+    {
+        for(size_t idx = next_task.fetch_add(1); idx < _num_tasks; idx = next_task.fetch_add(1))
+            _job(idx);
+    }
+
+    void run()
+    {
+        uint64_t seen = 0;
+        while(true)
+        {
+            std::function<void(size_t)> _job       = {};
+            size_t                      _num_tasks = 0;
+            {
+                std::unique_lock<std::mutex> lk(mut);
+                start_cv.wait(lk, [&]() { return stop || generation != seen; });
+                if(stop) return;
+                seen = generation;
+                // A job which already finished is reset by its caller
+                if(!job) continue;
+                _job       = job;
+                _num_tasks = num_tasks;
+                ++active;
+            }
+
+            execute(_job, _num_tasks);
+
+            std::unique_lock<std::mutex> lk(mut);
+            if(--active == 0) done_cv.notify_all();
+        }
+    }
+
+    std::vector<std::thread>    threads = {};
+    std::mutex                  dispatch_mut;  // Held for the duration of a parallel_for
+    std::mutex                  mut;
+    std::condition_variable     start_cv;
+    std::condition_variable     done_cv;
+    std::function<void(size_t)> job        = {};
+    size_t                      num_tasks  = 0;
+    std::atomic<size_t>         next_task  = {0};
+    size_t                      active     = 0;  // Workers running ranges of the current job
+    uint64_t                    generation = 0;
+    bool                        stop       = false;
+};
+}  // namespace Parser
@@ -234,6 +234,24 @@ configure_pc_sampling_service(context::context*                ctx,
     return ROCPROFILER_STATUS_SUCCESS;
 }
 
+rocprofiler_status_t
+configure_pc_sampling_output_mode(context::context*                     ctx,
+                                  rocprofiler_agent_id_t                agent_id,
+                                  rocprofiler_pc_sampling_output_mode_t mode)
+{
+    if(!ctx->pc_sampler) return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    auto itr = ctx->pc_sampler->agent_sessions.find(agent_id);
+    if(itr == ctx->pc_sampler->agent_sessions.end())
+    {
+        // The service must be configured on the agent first.
+        return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+    }
+
+    itr->second->parser->set_output_mode(mode);
+    return ROCPROFILER_STATUS_SUCCESS;
+}
+
 bool
 is_pc_sample_service_configured(rocprofiler_agent_id_t agent_id)
 {
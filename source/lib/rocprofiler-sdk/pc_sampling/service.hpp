@@ -62,6 +62,11 @@ configure_pc_sampling_service(context::context*                ctx,
                               uint64_t                         interval,
                               rocprofiler_buffer_id_t          buffer_id);
 
+rocprofiler_status_t
+configure_pc_sampling_output_mode(context::context*                     ctx,
+                                  rocprofiler_agent_id_t                agent_id,
+                                  rocprofiler_pc_sampling_output_mode_t mode);
+
 bool
 is_pc_sample_service_configured(rocprofiler_agent_id_t agent_id);
 
@@ -25,7 +25,11 @@
 #include "lib/rocprofiler-sdk/pc_sampling/parser/pc_record_interface.hpp"
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
 
 TEST(pc_sampling, cid_manager)
 {
@@ -95,3 +99,60 @@ TEST(pc_sampling, cid_manager)
     EXPECT_EQ(c1.get_ref_count(), 4);
     EXPECT_EQ(c2.get_ref_count(), 3);
 }
+
+TEST(pc_sampling, cid_manager_concurrent_completions)
+{
+    using correlation_id_t = rocprofiler::context::correlation_id;
+    using cid_manager_t    = rocprofiler::pc_sampling::PCSCIDManager;
+    using pcs_parser_t     = PCSamplingParserContext;
+
+    constexpr size_t num_producers  = 8;
+    constexpr size_t num_per_thread = 20000;
+
+    auto pcs_copy_fn = []() {};
+    auto pcs_parser  = pcs_parser_t();
+    auto cid_manager = cid_manager_t(&pcs_parser);
+
+    // a ref count of 2 is never retired here, hence a CID retired twice is caught by the checks
+    auto cids = std::vector<std::unique_ptr<correlation_id_t>>{};
+    cids.reserve(num_producers * num_per_thread);
+    for(size_t i = 0; i < num_producers * num_per_thread; ++i)
+        cids.emplace_back(std::make_unique<correlation_id_t>(2, i % num_producers, i));
+
+    // kernel completion callbacks of several threads push while the buffer flushes consume
+    auto producers_done = std::atomic<size_t>{0};
+    auto producers      = std::vector<std::thread>{};
+    for(size_t t = 0; t < num_producers; ++t)
+    {
+        producers.emplace_back([&, t]() {
+            for(size_t i = 0; i < num_per_thread; ++i)
+                cid_manager.cid_async_activity_completed(cids.at(i * num_producers + t).get());
+            ++producers_done;
+        });
+    }
+
+    auto consumer = std::thread{[&]() {
+        size_t nflush = 0;
+        while(producers_done.load() < num_producers)
+        {
+            if(++nflush % 16 == 0)
+                cid_manager.manage_cids_explicit(pcs_copy_fn);
+            else
+                cid_manager.manage_cids_implicit(pcs_copy_fn);
+        }
+    }};
+
+    for(auto& itr : producers)
+        itr.join();
+    consumer.join();
+
+    // the completions pushed after the last flush of the consumer
+    cid_manager.manage_cids_implicit(pcs_copy_fn);
+    cid_manager.manage_cids_implicit(pcs_copy_fn);
+
+    // every CID is retired exactly once: none is lost or duplicated by the lock-free queue
+    size_t num_wrong = 0;
+    for(const auto& itr : cids)
+        if(itr->get_ref_count() != 1) ++num_wrong;
+    EXPECT_EQ(num_wrong, 0);
+}
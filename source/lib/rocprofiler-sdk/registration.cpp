@@ -29,6 +29,7 @@
 #include "lib/common/logging.hpp"
 #include "lib/common/static_object.hpp"
 #include "lib/rocprofiler-sdk/agent.hpp"
+#include "lib/rocprofiler-sdk/buffer.hpp"
 #include "lib/rocprofiler-sdk/code_object/code_object.hpp"
 #include "lib/rocprofiler-sdk/context/context.hpp"
 #include "lib/rocprofiler-sdk/hip/hip.hpp"
@@ -629,6 +630,7 @@ finalize()
     static auto _once = std::once_flag{};
     std::call_once(_once, []() {
         set_fini_status(-1);
+        buffer::finalize();
         hsa::async_copy_fini();
         hsa::queue_controller_fini();
         thread_trace::finalize();
@@ -30,10 +30,17 @@
 #include <gtest/gtest.h>
 
 #include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <random>
+#include <thread>
 #include <typeinfo>
+#include <vector>
 
 TEST(rocprofiler_lib, buffer)
 {
@@ -76,3 +83,260 @@ TEST(rocprofiler_lib, buffer)
     auto destroy_status = rocprofiler_destroy_buffer(*buffer_id);
     EXPECT_EQ(destroy_status, ROCPROFILER_STATUS_SUCCESS);
 }
+
+namespace
+{
+auto flushed_records = std::atomic<uint64_t>{0};
+
+void
+count_flushed_records(rocprofiler_context_id_t,
+                      rocprofiler_buffer_id_t,
+                      rocprofiler_record_header_t**,
+                      size_t num_headers,
+                      void*,
+                      uint64_t)
+{
+    flushed_records += num_headers;
+}
+}  // namespace
+
+TEST(rocprofiler_lib, buffer_flush_interval)
+{
+    namespace buffer = ::rocprofiler::buffer;
+    namespace common = ::rocprofiler::common;
+
+    auto buffer_id = buffer::allocate_buffer();
+    ASSERT_TRUE(buffer_id) << "failed to allocate buffer";
+
+    auto* buffer_v = buffer::get_buffer(*buffer_id);
+    ASSERT_NE(buffer_v, nullptr) << "get_buffer returned a nullptr. id=" << buffer_id->handle;
+
+    // the watermark is never reached so only the flush timer delivers the record
+    buffer_v->watermark      = std::numeric_limits<uint64_t>::max();
+    buffer_v->flush_interval = std::chrono::nanoseconds{std::chrono::milliseconds{10}}.count();
+    buffer_v->callback       = count_flushed_records;
+    EXPECT_TRUE(buffer_v->get_internal_buffer().allocate(common::units::get_page_size()));
+
+    buffer::add_flush_timer(*buffer_id);
+
+    auto data = *buffer_id;
+    buffer_v->emplace(1, 1, data);
+    EXPECT_NE(buffer_v->oldest_record.load(), 0);
+
+    for(size_t i = 0; i < 500 && flushed_records.load() == 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+    EXPECT_EQ(flushed_records.load(), 1);
+    EXPECT_EQ(buffer_v->oldest_record.load(), 0);
+
+    // the callback is invoked before the flush is marked as completed
+    buffer_v->wait_for_flush(buffer_v->flush_started.load());
+
+    auto destroy_status = rocprofiler_destroy_buffer(*buffer_id);
+    EXPECT_EQ(destroy_status, ROCPROFILER_STATUS_SUCCESS);
+}
+
+TEST(rocprofiler_lib, buffer_flush_interval_fork)
+{
+    namespace buffer = ::rocprofiler::buffer;
+    namespace common = ::rocprofiler::common;
+
+    auto buffer_id = buffer::allocate_buffer();
+    ASSERT_TRUE(buffer_id) << "failed to allocate buffer";
+
+    auto* buffer_v = buffer::get_buffer(*buffer_id);
+    ASSERT_NE(buffer_v, nullptr) << "get_buffer returned a nullptr. id=" << buffer_id->handle;
+
+    buffer_v->watermark      = std::numeric_limits<uint64_t>::max();
+    buffer_v->flush_interval = std::chrono::nanoseconds{std::chrono::milliseconds{10}}.count();
+    buffer_v->callback       = count_flushed_records;
+    EXPECT_TRUE(buffer_v->get_internal_buffer(0).allocate(common::units::get_page_size()));
+    EXPECT_TRUE(buffer_v->get_internal_buffer(1).allocate(common::units::get_page_size()));
+
+    // the timer thread of the parent does not exist in the child: the child must restart it
+    buffer::add_flush_timer(*buffer_id);
+    flushed_records.store(0);
+
+    auto pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if(pid == 0)
+    {
+        auto data = *buffer_id;
+        buffer_v->emplace(1, 1, data);
+
+        for(size_t i = 0; i < 500 && flushed_records.load() == 0; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+
+        ::_exit((flushed_records.load() == 1) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    auto status = 0;
+    ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), EXIT_SUCCESS) << "the child did not flush the buffer";
+
+    auto destroy_status = rocprofiler_destroy_buffer(*buffer_id);
+    EXPECT_EQ(destroy_status, ROCPROFILER_STATUS_SUCCESS);
+}
+
+namespace
+{
+auto flush_callbacks = std::atomic<uint64_t>{0};
+auto flush_gate      = std::atomic<bool>{false};
+
+void
+blocking_flush_callback(rocprofiler_context_id_t,
+                        rocprofiler_buffer_id_t,
+                        rocprofiler_record_header_t**,
+                        size_t num_headers,
+                        void*,
+                        uint64_t)
+{
+    ++flush_callbacks;
+    flushed_records += num_headers;
+    while(!flush_gate.load())
+        std::this_thread::sleep_for(std::chrono::microseconds{100});
+}
+}  // namespace
+
+TEST(rocprofiler_lib, buffer_flush_coalesce)
+{
+    namespace buffer = ::rocprofiler::buffer;
+    namespace common = ::rocprofiler::common;
+
+    flush_callbacks = 0;
+    flushed_records = 0;
+    flush_gate      = false;
+
+    auto buffer_id = buffer::allocate_buffer();
+    ASSERT_TRUE(buffer_id) << "failed to allocate buffer";
+
+    auto* buffer_v = buffer::get_buffer(*buffer_id);
+    ASSERT_NE(buffer_v, nullptr) << "get_buffer returned a nullptr. id=" << buffer_id->handle;
+
+    // every record reaches the watermark and requests a flush without waiting
+    buffer_v->watermark = 1;
+    buffer_v->callback  = blocking_flush_callback;
+    for(size_t i = 0; i < buffer_v->buffers.size(); ++i)
+    {
+        EXPECT_TRUE(buffer_v->get_internal_buffer(i).allocate(common::units::get_page_size()));
+    }
+
+    auto data = *buffer_id;
+    buffer_v->emplace(1, 1, data);
+
+    for(size_t i = 0; i < 500 && flush_callbacks.load() == 0; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    ASSERT_EQ(flush_callbacks.load(), 1) << "first flush was not started";
+
+    // the requests received while the first flush is blocked in the callback are merged
+    buffer_v->emplace(1, 1, data);
+    for(size_t i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(buffer::flush(*buffer_id, false), ROCPROFILER_STATUS_ERROR_BUFFER_BUSY);
+    }
+
+    flush_gate = true;
+
+    // waits for the flush in progress (and the merged flush if it started first), then flushes
+    // the empty buffer without invoking the callback
+    EXPECT_EQ(buffer::flush(*buffer_id, true), ROCPROFILER_STATUS_SUCCESS);
+    buffer_v->wait_for_flush(buffer_v->flush_started.load());
+
+    EXPECT_EQ(flush_callbacks.load(), 2);
+    EXPECT_EQ(flushed_records.load(), 2);
+    EXPECT_FALSE(buffer_v->flush_pending.load());
+
+    auto destroy_status = rocprofiler_destroy_buffer(*buffer_id);
+    EXPECT_EQ(destroy_status, ROCPROFILER_STATUS_SUCCESS);
+}
+
+TEST(rocprofiler_lib, buffer_flush_wait_destroy)
+{
+    namespace buffer = ::rocprofiler::buffer;
+    namespace common = ::rocprofiler::common;
+
+    constexpr size_t num_threads    = 16;
+    constexpr size_t max_iterations = 100000;
+
+    flush_callbacks = 0;
+    flush_gate      = false;
+
+    auto buffer_id = buffer::allocate_buffer();
+    ASSERT_TRUE(buffer_id) << "failed to allocate buffer";
+
+    auto* buffer_v = buffer::get_buffer(*buffer_id);
+    ASSERT_NE(buffer_v, nullptr) << "get_buffer returned a nullptr. id=" << buffer_id->handle;
+
+    buffer_v->watermark = std::numeric_limits<uint64_t>::max();
+    buffer_v->callback  = blocking_flush_callback;
+    for(size_t i = 0; i < buffer_v->buffers.size(); ++i)
+    {
+        EXPECT_TRUE(buffer_v->get_internal_buffer(i).allocate(common::units::get_page_size()));
+    }
+
+    auto data = *buffer_id;
+    buffer_v->emplace(1, 1, data);
+
+    // the callback blocks this flush until every waiter is blocked on it
+    EXPECT_EQ(buffer::flush(*buffer_id, false), ROCPROFILER_STATUS_SUCCESS);
+
+    auto returned   = std::atomic<uint64_t>{0};
+    auto flushed    = std::atomic<uint64_t>{0};
+    auto not_found  = std::atomic<uint64_t>{0};
+    auto unexpected = std::atomic<uint64_t>{0};
+
+    // every waiter keeps flushing until it observes the destroy
+    auto flush_waits = [&]() {
+        for(size_t i = 0; i < max_iterations; ++i)
+        {
+            auto _status = buffer::flush(*buffer_id, true);
+            if(_status == ROCPROFILER_STATUS_SUCCESS)
+            {
+                ++flushed;
+                // leave the buffer idle for the destroy once in a while
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                continue;
+            }
+
+            if(_status == ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND)
+                ++not_found;
+            else
+                ++unexpected;
+            break;
+        }
+        ++returned;
+    };
+
+    auto threads = std::vector<std::thread>{};
+    for(size_t i = 0; i < num_threads; ++i)
+        threads.emplace_back(flush_waits);
+
+    for(size_t i = 0; i < 5000 && buffer_v->flush_waiters.load() < num_threads; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    EXPECT_EQ(buffer_v->flush_waiters.load(), num_threads) << "flush waiters did not block";
+
+    // a flush in progress makes the destroy busy
+    auto destroy_status = ROCPROFILER_STATUS_ERROR_BUFFER_BUSY;
+    auto destroy_thread = std::thread{[&]() {
+        while((destroy_status = rocprofiler_destroy_buffer(*buffer_id)) ==
+              ROCPROFILER_STATUS_ERROR_BUFFER_BUSY)
+            std::this_thread::yield();
+    }};
+
+    flush_gate = true;
+    for(auto& itr : threads)
+        itr.join();
+    destroy_thread.join();
+
+    EXPECT_EQ(destroy_status, ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_EQ(returned.load(), num_threads) << "a flush waiter did not return";
+    EXPECT_EQ(not_found.load(), num_threads) << "a flush waiter did not observe the destroy";
+    EXPECT_EQ(unexpected.load(), 0) << "flush with wait returned neither success nor not found";
+    EXPECT_EQ(buffer_v->flush_waiters.load(), 0);
+    EXPECT_EQ(flush_callbacks.load(), 1);
+
+    EXPECT_EQ(buffer::get_buffer(*buffer_id), nullptr);
+    EXPECT_EQ(buffer::flush(*buffer_id, true), ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND);
+    EXPECT_EQ(rocprofiler_destroy_buffer(*buffer_id), ROCPROFILER_STATUS_ERROR_BUFFER_NOT_FOUND);
+}
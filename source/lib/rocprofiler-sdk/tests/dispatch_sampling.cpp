@@ -0,0 +1,171 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <rocprofiler-sdk/fwd.h>
+#include <rocprofiler-sdk/rocprofiler.h>
+
+#include "lib/rocprofiler-sdk/kernel_dispatch/sampling_policy.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace
+{
+using sampling_policy = rocprofiler::kernel_dispatch::sampling_policy;
+
+auto
+make_policy(rocprofiler_dispatch_sampling_policy_type_t type)
+{
+    auto policy = rocprofiler_dispatch_sampling_policy_t{};
+    policy.size = sizeof(rocprofiler_dispatch_sampling_policy_t);
+    policy.type = type;
+    return policy;
+}
+}  // namespace
+
+TEST(rocprofiler_lib, dispatch_sampling_validation)
+{
+    auto policy = make_policy(ROCPROFILER_DISPATCH_SAMPLING_POLICY_EVERY_NTH);
+    EXPECT_FALSE(sampling_policy::is_valid(policy));
+    policy.count = 3;
+    EXPECT_TRUE(sampling_policy::is_valid(policy));
+
+    policy           = make_policy(ROCPROFILER_DISPATCH_SAMPLING_POLICY_DUTY_CYCLE);
+    policy.period_ns = 100;
+    policy.active_ns = 200;
+    EXPECT_FALSE(sampling_policy::is_valid(policy));
+    policy.active_ns = 50;
+    EXPECT_TRUE(sampling_policy::is_valid(policy));
+
+    policy             = make_policy(ROCPROFILER_DISPATCH_SAMPLING_POLICY_RANDOM);
+    policy.probability = 1.5;
+    EXPECT_FALSE(sampling_policy::is_valid(policy));
+
+    EXPECT_FALSE(sampling_policy::is_valid(make_policy(ROCPROFILER_DISPATCH_SAMPLING_POLICY_LAST)));
+}
+
+TEST(rocprofiler_lib, dispatch_sampling_per_kernel)
+{
+    auto every_nth  = make_policy(ROCPROFILER_DISPATCH_SAMPLING_POLICY_EVERY_NTH);
+    every_nth.count = 3;
+    auto first_n    = make_policy(ROCPROFILER_DISPATCH_SAMPLING_POLICY_FIRST_N);
+    first_n.count   = 2;
+
+    auto nth   = sampling_policy{every_nth, 0};
+    auto first = sampling_policy{first_n, 0};
+
+    size_t nth_sampled[2]   = {0, 0};
+    size_t first_sampled[2] = {0, 0};
+    for(size_t i = 0; i < 30; ++i)
+    {
+        // interleave two kernels, each has its own count
+        for(rocprofiler_kernel_id_t kernel_id = 0; kernel_id < 2; ++kernel_id)
+        {
+            if(nth.sample(kernel_id)) ++nth_sampled[kernel_id];
+            if(first.sample(kernel_id)) ++first_sampled[kernel_id];
+        }
+    }
+
+    EXPECT_EQ(nth_sampled[0], 10);
+    EXPECT_EQ(nth_sampled[1], 10);
+    EXPECT_EQ(first_sampled[0], 2);
+    EXPECT_EQ(first_sampled[1], 2);
+}
+
+TEST(rocprofiler_lib, dispatch_sampling_duty_cycle)
+{
+    auto policy      = make_policy(ROCPROFILER_DISPATCH_SAMPLING_POLICY_DUTY_CYCLE);
+    policy.period_ns = 1000;
+    policy.active_ns = 250;
+
+    auto duty = sampling_policy{policy, 5000};
+
+    EXPECT_TRUE(duty.sample(0, 5000));
+    EXPECT_TRUE(duty.sample(0, 5249));
+    EXPECT_FALSE(duty.sample(0, 5250));
+    EXPECT_FALSE(duty.sample(0, 5999));
+    EXPECT_TRUE(duty.sample(0, 6000));
+    EXPECT_TRUE(duty.sample(0, 9100));
+}
+
+TEST(rocprofiler_lib, dispatch_sampling_random)
+{
+    auto policy        = make_policy(ROCPROFILER_DISPATCH_SAMPLING_POLICY_RANDOM);
+    policy.probability = 0.25;
+    policy.seed        = 1234;
+
+    auto lhs = sampling_policy{policy, 0};
+    auto rhs = sampling_policy{policy, 0};
+
+    constexpr size_t num_dispatches = 20000;
+
+    size_t sampled = 0;
+    for(size_t i = 0; i < num_dispatches; ++i)
+    {
+        auto val = lhs.sample(i % 7);
+        // same seed, same decisions
+        EXPECT_EQ(val, rhs.sample(i % 7));
+        if(val) ++sampled;
+    }
+
+    EXPECT_GT(sampled, num_dispatches / 5);
+    EXPECT_LT(sampled, num_dispatches / 3);
+
+    policy.probability = 0.0;
+    auto never         = sampling_policy{policy, 0};
+    policy.probability = 1.0;
+    auto always        = sampling_policy{policy, 0};
+    for(size_t i = 0; i < 100; ++i)
+    {
+        EXPECT_FALSE(never.sample(0));
+        EXPECT_TRUE(always.sample(0));
+    }
+}
+
+TEST(rocprofiler_lib, dispatch_sampling_shared_decision)
+{
+    auto every_nth     = make_policy(ROCPROFILER_DISPATCH_SAMPLING_POLICY_EVERY_NTH);
+    every_nth.count    = 2;
+    auto random        = make_policy(ROCPROFILER_DISPATCH_SAMPLING_POLICY_RANDOM);
+    random.probability = 0.5;
+    random.seed        = 42;
+
+    auto nth  = sampling_policy{every_nth, 0};
+    auto rand = sampling_policy{random, 0};
+
+    size_t nth_sampled = 0;
+    for(rocprofiler_dispatch_id_t dispatch_id = 1; dispatch_id <= 100; ++dispatch_id)
+    {
+        // the counting and thread trace services both consult the policy for each dispatch: the
+        // second call must neither advance the state nor make a different decision
+        auto nth_val = nth.sample_dispatch(0, dispatch_id);
+        EXPECT_EQ(nth_val, nth.sample_dispatch(0, dispatch_id));
+        if(nth_val) ++nth_sampled;
+
+        auto rand_val = rand.sample_dispatch(0, dispatch_id);
+        EXPECT_EQ(rand_val, rand.sample_dispatch(0, dispatch_id));
+    }
+
+    EXPECT_EQ(nth_sampled, 50);
+}
@@ -0,0 +1,152 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/stringize_arg.hpp"
+#include "lib/rocprofiler-sdk/hip/utils.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <utility>
+
+namespace
+{
+namespace utils = ::rocprofiler::hip::utils;
+
+constexpr size_t  num_iterations = 100000;
+constexpr int32_t max_deref      = 2;
+
+template <typename Tp>
+auto
+named(const char* name, Tp value)
+{
+    return std::pair<const char*, Tp>{name, value};
+}
+
+// arguments of a few of the most frequently traced HIP API calls
+struct hip_args
+{
+    int         data[4]         = {1, 2, 3, 4};
+    void*       device_ptr      = &data[0];
+    void*       kernel_args[2]  = {&data[1], &data[2]};
+    dim3        num_blocks      = dim3{128, 2, 1};
+    dim3        block_dim       = dim3{256, 1, 1};
+    hipStream_t stream          = nullptr;
+    const char* kernel_name     = "vector_add";
+    size_t      num_bytes       = 4096;
+    size_t      shared_mem_size = 0;
+
+    template <typename FuncT>
+    void operator()(FuncT&& func)
+    {
+        // hipMalloc
+        func(named("ptr", &device_ptr), named("size", num_bytes));
+        // hipMemcpy
+        func(named("dst", device_ptr),
+             named("src", static_cast<const void*>(&data[0])),
+             named("sizeBytes", num_bytes),
+             named("kind", hipMemcpyHostToDevice));
+        // hipLaunchKernel
+        func(named("function_address", static_cast<const void*>(kernel_name)),
+             named("numBlocks", num_blocks),
+             named("dimBlocks", block_dim),
+             named("args", &kernel_args[0]),
+             named("sharedMemBytes", shared_mem_size),
+             named("stream", stream));
+        // hipModuleGetFunction
+        func(named("hfunc", static_cast<void*>(nullptr)),
+             named("module", static_cast<void*>(nullptr)),
+             named("kname", kernel_name));
+    }
+};
+
+template <typename FuncT>
+double
+time_per_call(FuncT&& func)
+{
+    auto _args = hip_args{};
+    auto _beg  = std::chrono::steady_clock::now();
+    for(size_t i = 0; i < num_iterations; ++i)
+        _args(func);
+    auto _end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(_end - _beg).count() / (4 * num_iterations);
+}
+}  // namespace
+
+TEST(format_args, matches_stringize)
+{
+    auto _args = hip_args{};
+    _args([](auto... args) {
+        auto _expected = utils::stringize(max_deref, args...);
+
+        auto _buffer = rocprofiler::common::scoped_format_buffer{};
+        auto _result = utils::format(_buffer.get(), max_deref, args...);
+
+        ASSERT_EQ(_expected.size(), _result.size());
+        for(size_t i = 0; i < _result.size(); ++i)
+        {
+            EXPECT_EQ(_expected[i].value, std::string_view{_buffer.at(_result[i].offset)})
+                << "argument " << _expected[i].name;
+            EXPECT_EQ(_expected[i].dereference_count, _result[i].dereference_count);
+            EXPECT_EQ(_expected[i].indirection_level, _result[i].indirection_level);
+            EXPECT_EQ(std::string_view{_expected[i].name}, std::string_view{_result[i].name});
+        }
+    });
+}
+
+// timing only, run with --gtest_also_run_disabled_tests --gtest_filter=format_args.*
+TEST(format_args, DISABLED_benchmark)
+{
+    size_t _stringize_chars = 0;
+    size_t _format_chars    = 0;
+
+    auto _stringize = [&_stringize_chars](auto... args) {
+        auto _v = utils::stringize(max_deref, args...);
+        for(const auto& itr : _v)
+            _stringize_chars += itr.value.length();
+    };
+
+    auto _format = [&_format_chars](auto... args) {
+        auto _buffer = rocprofiler::common::scoped_format_buffer{};
+        auto _v      = utils::format(_buffer.get(), max_deref, args...);
+        // exclude the null terminators
+        _format_chars += _buffer.get().size() - _v.size();
+    };
+
+    // warm-up
+    time_per_call(_stringize);
+    time_per_call(_format);
+
+    _stringize_chars   = 0;
+    _format_chars      = 0;
+    auto _stringize_ns = time_per_call(_stringize);
+    auto _format_ns    = time_per_call(_format);
+
+    EXPECT_EQ(_stringize_chars, _format_chars);
+
+    std::cout << "Benchmark: stringize " << _stringize_ns << " ns/call, format " << _format_ns
+              << " ns/call (" << (_stringize_ns / _format_ns) << "x)" << std::endl;
+}
@@ -27,6 +27,11 @@
 
 #include <gtest/gtest.h>
 
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
 TEST(hsa, tables)
 {
     namespace hsa = ::rocprofiler::hsa;
@@ -104,3 +109,114 @@ TEST(hsa, tables)
     EXPECT_EQ(table.finalizer_ext_, fini_ext);
     EXPECT_EQ(table.image_ext_, img_ext);
 }
+
+TEST(hsa, buffer_record_args)
+{
+    using arg_names_t = std::vector<std::string>;
+
+    using record_t = rocprofiler_buffer_tracing_hsa_api_ext_record_t;
+
+    // the records only hold the member of the args union used by the operation
+    auto record      = record_t{};
+    record.size      = offsetof(record_t, args) + sizeof(record.args.hsa_agent_get_info);
+    record.kind      = ROCPROFILER_BUFFER_TRACING_HSA_CORE_API;
+    record.operation = ROCPROFILER_HSA_CORE_API_ID_hsa_agent_get_info;
+
+    record.args.hsa_agent_get_info.agent     = hsa_agent_t{.handle = 1234};
+    record.args.hsa_agent_get_info.attribute = HSA_AGENT_INFO_NAME;
+    record.args.hsa_agent_get_info.value     = nullptr;
+
+    auto header     = rocprofiler_record_header_t{};
+    header.category = ROCPROFILER_BUFFER_CATEGORY_TRACING;
+    header.kind     = ROCPROFILER_BUFFER_TRACING_HSA_CORE_API;
+    header.payload  = &record;
+
+    auto arg_callback = [](rocprofiler_buffer_tracing_kind_t kind,
+                           rocprofiler_tracing_operation_t   operation,
+                           uint32_t /*arg_number*/,
+                           const void* const /*arg_value_addr*/,
+                           int32_t /*arg_indirection_count*/,
+                           const char* /*arg_type*/,
+                           const char* arg_name,
+                           const char* /*arg_value_str*/,
+                           int32_t /*arg_dereference_count*/,
+                           void* data) -> int {
+        EXPECT_EQ(kind, ROCPROFILER_BUFFER_TRACING_HSA_CORE_API);
+        EXPECT_EQ(operation, ROCPROFILER_HSA_CORE_API_ID_hsa_agent_get_info);
+        static_cast<arg_names_t*>(data)->emplace_back(arg_name);
+        return 0;
+    };
+
+    auto arg_names = arg_names_t{};
+    EXPECT_EQ(rocprofiler_iterate_buffer_tracing_record_args(header, arg_callback, &arg_names),
+              ROCPROFILER_STATUS_SUCCESS);
+    EXPECT_EQ(arg_names, (arg_names_t{"agent", "attribute", "value"}));
+
+    // string arguments are not read since the memory may no longer be valid by the time the
+    // buffer is flushed: the address is provided instead
+    {
+        auto* invalid_name = reinterpret_cast<const char*>(0xdeadbeef);
+
+        auto str_record      = record_t{};
+        auto args_size       = sizeof(str_record.args.hsa_executable_get_symbol_by_name);
+        str_record.size      = offsetof(record_t, args) + args_size;
+        str_record.kind      = ROCPROFILER_BUFFER_TRACING_HSA_CORE_API;
+        str_record.operation = ROCPROFILER_HSA_CORE_API_ID_hsa_executable_get_symbol_by_name;
+        str_record.args.hsa_executable_get_symbol_by_name.symbol_name = invalid_name;
+
+        auto str_header    = header;
+        str_header.payload = &str_record;
+
+        auto str_callback = [](rocprofiler_buffer_tracing_kind_t /*kind*/,
+                               rocprofiler_tracing_operation_t /*operation*/,
+                               uint32_t /*arg_number*/,
+                               const void* const /*arg_value_addr*/,
+                               int32_t /*arg_indirection_count*/,
+                               const char* /*arg_type*/,
+                               const char* arg_name,
+                               const char* arg_value_str,
+                               int32_t     arg_dereference_count,
+                               void*       data) -> int {
+            EXPECT_EQ(arg_dereference_count, 0);
+            if(std::string_view{arg_name} == "symbol_name")
+                *static_cast<std::string*>(data) = arg_value_str;
+            return 0;
+        };
+
+        auto symbol_name = std::string{};
+        EXPECT_EQ(
+            rocprofiler_iterate_buffer_tracing_record_args(str_header, str_callback, &symbol_name),
+            ROCPROFILER_STATUS_SUCCESS);
+        EXPECT_EQ(symbol_name, "0xdeadbeef");
+    }
+
+    // record truncated after the return value: the arguments past the end of the record are zero
+    {
+        auto truncated = record;
+        truncated.size = offsetof(record_t, args) + sizeof(hsa_agent_t);
+        header.payload = &truncated;
+
+        arg_names.clear();
+        EXPECT_EQ(rocprofiler_iterate_buffer_tracing_record_args(header, arg_callback, &arg_names),
+                  ROCPROFILER_STATUS_SUCCESS);
+        EXPECT_EQ(arg_names, (arg_names_t{"agent", "attribute", "value"}));
+
+        truncated.size = offsetof(record_t, args);
+        EXPECT_EQ(rocprofiler_iterate_buffer_tracing_record_args(header, arg_callback, &arg_names),
+                  ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT);
+        header.payload = &record;
+    }
+
+    // record without the arguments
+    auto base_record = rocprofiler_buffer_tracing_hsa_api_record_t{};
+    base_record.size = sizeof(base_record);
+    base_record.kind = ROCPROFILER_BUFFER_TRACING_HSA_CORE_API;
+    header.payload   = &base_record;
+    EXPECT_EQ(rocprofiler_iterate_buffer_tracing_record_args(header, arg_callback, &arg_names),
+              ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT);
+
+    // not an API tracing record
+    header.kind = ROCPROFILER_BUFFER_TRACING_KERNEL_DISPATCH;
+    EXPECT_EQ(rocprofiler_iterate_buffer_tracing_record_args(header, arg_callback, &arg_names),
+              ROCPROFILER_STATUS_ERROR_KIND_NOT_FOUND);
+}
@@ -0,0 +1,78 @@
+// MIT License
+//
+// Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "lib/common/utility.hpp"
+#include "lib/rocprofiler-sdk/internal_threading.hpp"
+
+#include <gtest/gtest.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <vector>
+
+TEST(rocprofiler_lib, internal_threading_properties)
+{
+    namespace internal_threading = ::rocprofiler::internal_threading;
+    namespace common             = ::rocprofiler::common;
+
+    auto allowed = cpu_set_t{};
+    CPU_ZERO(&allowed);
+    ASSERT_EQ(::pthread_getaffinity_np(::pthread_self(), sizeof(allowed), &allowed), 0);
+
+    auto cpu = int{-1};
+    for(int i = 0; i < CPU_SETSIZE && cpu < 0; ++i)
+        if(CPU_ISSET(i, &allowed)) cpu = i;
+    ASSERT_GE(cpu, 0);
+
+    errno                = 0;
+    auto parent_priority = ::getpriority(PRIO_PROCESS, common::get_tid());
+    ASSERT_EQ(errno, 0);
+
+    // raising the nice value does not require any privileges
+    auto props         = internal_threading::thread_properties{};
+    props.cpu_affinity = {static_cast<uint32_t>(cpu)};
+    props.priority     = (parent_priority < 19) ? parent_priority + 1 : 19;
+
+    auto thread_cpus     = std::vector<int>{};
+    auto thread_priority = int{0};
+    {
+        auto task_group = internal_threading::TaskGroup{props};
+        task_group.exec([&thread_cpus, &thread_priority]() {
+            auto _cpuset = cpu_set_t{};
+            CPU_ZERO(&_cpuset);
+            ::pthread_getaffinity_np(::pthread_self(), sizeof(_cpuset), &_cpuset);
+            for(int i = 0; i < CPU_SETSIZE; ++i)
+                if(CPU_ISSET(i, &_cpuset)) thread_cpus.emplace_back(i);
+            thread_priority = ::getpriority(PRIO_PROCESS, common::get_tid());
+        });
+        task_group.join();
+    }
+
+    ASSERT_EQ(thread_cpus.size(), 1);
+    EXPECT_EQ(thread_cpus.front(), cpu);
+    EXPECT_EQ(thread_priority, props.priority);
+}
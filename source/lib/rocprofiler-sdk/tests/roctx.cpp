@@ -273,6 +273,28 @@ tool_tracing_buffered(rocprofiler_context_id_t      context,
         EXPECT_GT(record->end_timestamp, 0) << info.str();
         EXPECT_LE(record->start_timestamp, record->end_timestamp) << info.str();
 
+        if(record->kind == ROCPROFILER_BUFFER_TRACING_MARKER_CORE_API &&
+           (record->operation == ROCPROFILER_MARKER_CORE_API_ID_roctxMarkA ||
+            record->operation == ROCPROFILER_MARKER_CORE_API_ID_roctxRangePushA ||
+            record->operation == ROCPROFILER_MARKER_CORE_API_ID_roctxRangeStartA))
+        {
+            // all the messages are the name of the function generating the markers
+            static uint64_t message_id = record->message_id;
+            const char*     message    = nullptr;
+
+            EXPECT_GT(record->message_id, 0) << info.str();
+            EXPECT_EQ(record->message_id, message_id) << info.str();
+            EXPECT_EQ(rocprofiler_query_buffer_tracing_marker_message(record->message_id, &message),
+                      ROCPROFILER_STATUS_SUCCESS)
+                << info.str();
+            EXPECT_EQ(std::string_view{message}, std::string_view{"run_roctx_functions"})
+                << info.str();
+        }
+        else
+        {
+            EXPECT_EQ(record->message_id, 0) << info.str();
+        }
+
         cb_data->client_callback_count++;
         last_corr_id = corr_id;
     }
@@ -194,10 +194,16 @@ ThreadTracerQueue::ThreadTracerQueue(thread_trace_parameter_pack _params,
         [this](uint64_t codeobj_id) { this->unload_codeobj(codeobj_id); });
 
     codeobj_reg->IterateLoaded();
+
+    internal_threading::notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+    drain_group = std::make_unique<internal_threading::TaskGroup>();
+    internal_threading::notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
 }
 
 ThreadTracerQueue::~ThreadTracerQueue()
 {
+    wait_drained();
+
     std::unique_lock<std::mutex> lk(trace_resources_mut);
     if(active_traces.load() < 1)
     {
@@ -256,6 +262,77 @@ ThreadTracerQueue::iterate_data(aqlprofile_handle_t handle, rocprofiler_user_dat
     active_traces.fetch_sub(1);
 }
 
+/**
+ * Called from the kernel completion handler. The trace data is copied out of the trace buffer into
+ * one of the staging buffers, so the trace buffer can be reused by the next dispatch as soon as
+ * this returns, and the client callback runs on the drain thread. The staging buffers keep their
+ * capacity between dispatches. If both are still being delivered, this waits for one to be freed.
+ */
+void
+ThreadTracerQueue::drain_data(aqlprofile_handle_t handle, rocprofiler_user_data_t data)
+{
+    size_t idx = 0;
+    {
+        std::unique_lock<std::mutex> lk(staging_mut);
+        staging_cv.wait(lk, [&]() {
+            for(idx = 0; idx < staging.size(); idx++)
+                if(!staging.at(idx).busy) return true;
+            return false;
+        });
+        staging.at(idx).busy = true;
+    }
+
+    auto& buffer    = staging.at(idx);
+    buffer.userdata = data;
+    buffer.data.clear();
+    buffer.chunks.clear();
+
+    auto copy_fn = [](uint32_t shader, void* ptr, uint64_t size, void* userdata) {
+        auto&       _buffer = *static_cast<staging_buffer_t*>(userdata);
+        const auto* bytes   = static_cast<const uint8_t*>(ptr);
+
+        _buffer.chunks.push_back({shader, _buffer.data.size(), size});
+        _buffer.data.insert(_buffer.data.end(), bytes, bytes + size);
+        return HSA_STATUS_SUCCESS;
+    };
+
+    auto status = aqlprofile_att_iterate_data(handle, copy_fn, &buffer);
+    CHECK_HSA(status, "Failed to iterate ATT data");
+
+    active_traces.fetch_sub(1);
+
+    if(drain_group)
+        drain_group->exec([this, idx]() { deliver_staged(idx); });
+    else
+        deliver_staged(idx);
+}
+
+void
+ThreadTracerQueue::deliver_staged(size_t idx)
+{
+    auto& buffer = staging.at(idx);
+
+    for(const auto& chunk : buffer.chunks)
+    {
+        params.shader_cb_fn(chunk.shader_engine_id,
+                            buffer.data.data() + chunk.offset,
+                            chunk.size,
+                            buffer.userdata);
+    }
+
+    {
+        std::unique_lock<std::mutex> lk(staging_mut);
+        buffer.busy = false;
+    }
+    staging_cv.notify_all();
+}
+
+void
+ThreadTracerQueue::wait_drained()
+{
+    if(drain_group) drain_group->wait();
+}
+
 void
 ThreadTracerQueue::load_codeobj(code_object_id_t id, uint64_t addr, uint64_t size)
 {
@@ -340,6 +417,17 @@ DispatchThreadTracer::pre_kernel_call(const hsa::Queue&              queue,
         });
     };
 
+    // the sampling policy is immutable once the configuration is locked. The decision is shared
+    // with the dispatch counting service of the context for the same dispatch
+    const auto* ctx = context::get_registered_context(params.context_id);
+    if(ctx && ctx->dispatch_sampling &&
+       !ctx->dispatch_sampling->sample_dispatch(kernel_id, dispatch_id))
+    {
+        auto empty = std::make_unique<hsa::EmptyAQLPacket>();
+        maybe_add_serialization(empty);
+        return empty;
+    }
+
     auto control_flags = params.dispatch_cb_fn(queue.get_id(),
                                                queue.get_agent().get_rocp_agent(),
                                                rocprof_corr_id,
@@ -407,7 +495,7 @@ DispatchThreadTracer::post_kernel_call(DispatchThreadTracer::inst_pkt_t&       a
 
         auto it = agents.find(pkt->GetAgent());
         if(it != agents.end() && it->second != nullptr)
-            it->second->iterate_data(pkt->GetHandle(), session.user_data);
+            it->second->drain_data(pkt->GetHandle(), session.user_data);
     }
 }
 
@@ -453,6 +541,11 @@ DispatchThreadTracer::stop_context()  // NOLINT(readability-convert-member-funct
 
     auto* controller = hsa::get_queue_controller();
     if(controller) controller->disable_serialization();
+
+    // Deliver the data of the dispatches that completed before the context was stopped
+    std::shared_lock<std::shared_mutex> lk(agents_map_mut);
+    for(auto& [_, tracer] : agents)
+        if(tracer) tracer->wait_drained();
 }
 
 void
@@ -26,6 +26,7 @@
 #include "lib/rocprofiler-sdk/hsa/agent_cache.hpp"
 #include "lib/rocprofiler-sdk/hsa/aql_packet.hpp"
 #include "lib/rocprofiler-sdk/hsa/queue_info_session.hpp"
+#include "lib/rocprofiler-sdk/internal_threading.hpp"
 #include "lib/rocprofiler-sdk/thread_trace/code_object.hpp"
 
 #include <rocprofiler-sdk/amd_detail/thread_trace.h>
@@ -33,7 +34,9 @@
 #include <rocprofiler-sdk/cxx/hash.hpp>
 #include <rocprofiler-sdk/cxx/operators.hpp>
 
+#include <array>
 #include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -95,6 +98,10 @@ public:
 
     std::unique_ptr<hsa::TraceControlAQLPacket> get_control(bool bStart);
     void iterate_data(aqlprofile_handle_t handle, rocprofiler_user_data_t data);
+    // Copies the trace data into a staging buffer, which is delivered by the drain thread
+    void drain_data(aqlprofile_handle_t handle, rocprofiler_user_data_t data);
+    // Blocks until all the staged data has been delivered to the client
+    void wait_drained();
 
     hsa_queue_t*                queue = nullptr;
     std::mutex                  trace_resources_mut;
@@ -120,6 +127,30 @@ public:
     }
 
 private:
+    static constexpr size_t NUM_STAGING_BUFFERS = 2;
+
+    struct staging_chunk_t
+    {
+        int64_t shader_engine_id = 0;
+        size_t  offset           = 0;
+        size_t  size             = 0;
+    };
+
+    struct staging_buffer_t
+    {
+        bool                         busy = false;
+        rocprofiler_user_data_t      userdata{.value = 0};
+        std::vector<uint8_t>         data{};
+        std::vector<staging_chunk_t> chunks{};
+    };
+
+    void deliver_staged(size_t idx);
+
+    std::array<staging_buffer_t, NUM_STAGING_BUFFERS> staging{};
+    std::mutex                                        staging_mut;
+    std::condition_variable                           staging_cv;
+    std::unique_ptr<internal_threading::TaskGroup>    drain_group{nullptr};
+
     std::unique_ptr<code_object::CodeobjCallbackRegistry> codeobj_reg{nullptr};
 
     rocprofiler_agent_id_t agent_id;
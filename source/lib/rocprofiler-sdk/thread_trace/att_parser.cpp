@@ -22,11 +22,19 @@
 
 #include <rocprofiler-sdk/amd_detail/thread_trace.h>
 #include <rocprofiler-sdk/rocprofiler.h>
-#include <atomic>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string_view>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 #include "lib/rocprofiler-sdk/aql/aql_profile_v2.h"
+#include "lib/rocprofiler-sdk/internal_threading.hpp"
 
 #define AQLPROFILE_OCCUPANCY_RESOLUTION 8
 
@@ -72,14 +80,33 @@ forward_hsa_error(hsa_status_t error_code)
     return ROCPROFILER_STATUS_ERROR;
 }
 
+/**
+ * @brief Records of a chunk decoded by a worker thread, kept until they can be delivered in order.
+ */
+struct decoded_chunk_t
+{
+    rocprofiler_att_parser_data_type_t                 type              = {};
+    std::vector<rocprofiler_att_data_type_isa_t>       isa_records       = {};
+    std::vector<rocprofiler_att_data_type_occupancy_t> occupancy_records = {};
+};
+
 struct userdata_callback_table_t
 {
-    rocprofiler_att_parser_trace_callback_t   trace;
-    rocprofiler_att_parser_isa_callback_t     isa;
-    rocprofiler_att_parser_se_data_callback_t se_data;
-    void*                                     user;
+    rocprofiler_att_parser_trace_callback_t       trace;
+    rocprofiler_att_parser_trace_batch_callback_t trace_batch;
+    rocprofiler_att_parser_isa_callback_t         isa;
+    rocprofiler_att_parser_se_data_callback_t     se_data;
+    void*                                         user;
+    void*                                         se_user;  // Passed to se_data
 
     std::vector<pcinfo_t> kernel_id_map;
+
+    // Reused across chunks to deliver the converted records
+    std::vector<rocprofiler_att_data_type_isa_t>       isa_records;
+    std::vector<rocprofiler_att_data_type_occupancy_t> occupancy_records;
+
+    // When set, chunks are kept here instead of being delivered to the client
+    std::vector<decoded_chunk_t>* decoded = nullptr;
 };
 
 thread_local int TRACE_DATA_ID{-1};
@@ -97,6 +124,39 @@ iterate_trace_type(int id, const char* metadata, void*)
         TRACE_DATA_ID = id;
 }
 
+/**
+ * @brief Returns the converted records of a chunk to the client, either as a single batch or
+ * one record per call.
+ */
+template <typename Tp>
+void
+deliver(const userdata_callback_table_t&   table,
+        rocprofiler_att_parser_data_type_t type,
+        std::vector<Tp>&                   records)
+{
+    if(records.empty()) return;
+
+    if(table.decoded)
+    {
+        auto& chunk = table.decoded->emplace_back();
+        chunk.type  = type;
+        if constexpr(std::is_same<Tp, rocprofiler_att_data_type_isa_t>::value)
+            chunk.isa_records = records;
+        else
+            chunk.occupancy_records = records;
+        return;
+    }
+
+    if(table.trace_batch)
+    {
+        table.trace_batch(type, records.data(), records.size(), table.user);
+        return;
+    }
+
+    for(auto& itr : records)
+        table.trace(type, &itr, table.user);
+}
+
 hsa_status_t
 trace_callback(int trace_type_id,
                int /* correlation_id */,
@@ -117,34 +177,41 @@ trace_callback(int trace_type_id,
     }
     else if(trace_type_id == OCCUPANCY_ID)
     {
-        const auto* events = reinterpret_cast<const att_occupancy_info_t*>(trace_events);
+        const auto* events  = reinterpret_cast<const att_occupancy_info_t*>(trace_events);
+        auto&       records = table.occupancy_records;
+        records.resize(trace_size);
+
         for(size_t i = 0; i < trace_size; i++)
         {
-            rocprofiler_att_data_type_occupancy_t occ{};
+            auto& occ     = records[i];
+            occ           = {};
             occ.timestamp = events[i].time * AQLPROFILE_OCCUPANCY_RESOLUTION;
             occ.enabled   = events[i].enable;
-            try
+            // Not having a kernel_id_map entry is unexpected, but valid
+            if(events[i].kernel_id < table.kernel_id_map.size())
             {
-                pcinfo_t kernel_id_addr = table.kernel_id_map.at(events[i].kernel_id);
-                occ.marker_id           = kernel_id_addr.marker_id;
-                occ.offset              = kernel_id_addr.addr;
-            } catch(...)
-            {}  // Not having a kernel_id_map entry is unexpected, but valid
-            table.trace(ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY, (void*) &occ, table.user);
+                const auto& kernel_id_addr = table.kernel_id_map[events[i].kernel_id];
+                occ.marker_id              = kernel_id_addr.marker_id;
+                occ.offset                 = kernel_id_addr.addr;
+            }
         }
+        deliver(table, ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY, records);
     }
     else if(trace_type_id == TRACE_DATA_ID)
     {
-        const auto* events = reinterpret_cast<const att_trace_event_t*>(trace_events);
+        const auto* events  = reinterpret_cast<const att_trace_event_t*>(trace_events);
+        auto&       records = table.isa_records;
+        records.resize(trace_size);
+
         for(size_t i = 0; i < trace_size; i++)
         {
-            rocprofiler_att_data_type_isa_t isa{};
+            auto& isa     = records[i];
             isa.marker_id = events[i].pc.marker_id;
             isa.offset    = events[i].pc.addr;
             isa.hitcount  = events[i].hitcount;
             isa.latency   = events[i].latency;
-            table.trace(ROCPROFILER_ATT_PARSER_DATA_TYPE_ISA, (void*) &isa, table.user);
         }
+        deliver(table, ROCPROFILER_ATT_PARSER_DATA_TYPE_ISA, records);
     }
 
     return HSA_STATUS_SUCCESS;
@@ -176,18 +243,16 @@ se_data_callback(int* seid, uint8_t** buffer, uint64_t* buffer_size, void* userd
 {
     assert(userdata);
     auto& table = *reinterpret_cast<userdata_callback_table_t*>(userdata);
-    return table.se_data(seid, buffer, buffer_size, table.user);
+    return table.se_data(seid, buffer, buffer_size, table.se_user);
 }
 
 }  // namespace att_parser
 }  // namespace rocprofiler
 
-extern "C" {
+namespace
+{
 rocprofiler_status_t
-rocprofiler_att_parse_data(rocprofiler_att_parser_se_data_callback_t user_se_data_callback,
-                           rocprofiler_att_parser_trace_callback_t   user_trace_callback,
-                           rocprofiler_att_parser_isa_callback_t     user_isa_callback,
-                           void*                                     userdata)
+parse_data(rocprofiler::att_parser::userdata_callback_table_t& table)
 {
     static thread_local bool bInit = []() {
         aqlprofile_att_parser_iterate_event_list(rocprofiler::att_parser::iterate_trace_type,
@@ -196,12 +261,6 @@ rocprofiler_att_parse_data(rocprofiler_att_parser_se_data_callback_t user_se_dat
     }();
     (void) bInit;
 
-    rocprofiler::att_parser::userdata_callback_table_t table;
-    table.trace   = user_trace_callback;
-    table.isa     = user_isa_callback;
-    table.se_data = user_se_data_callback;
-    table.user    = userdata;
-
     hsa_status_t status = aqlprofile_att_parse_data(rocprofiler::att_parser::se_data_callback,
                                                     rocprofiler::att_parser::trace_callback,
                                                     rocprofiler::att_parser::isa_callback,
@@ -210,4 +269,304 @@ rocprofiler_att_parse_data(rocprofiler_att_parser_se_data_callback_t user_se_dat
     if(status != HSA_STATUS_SUCCESS) return rocprofiler::att_parser::forward_hsa_error(status);
     return ROCPROFILER_STATUS_SUCCESS;
 }
+
+/**
+ * @brief Feeds a single in-memory shader engine stream to the parser.
+ */
+struct se_stream_t
+{
+    rocprofiler_att_parser_se_data_t se_data  = {};
+    bool                             consumed = false;
+};
+
+uint64_t
+se_stream_callback(int* seid, uint8_t** buffer, uint64_t* buffer_size, void* userdata)
+{
+    auto& stream = *static_cast<se_stream_t*>(userdata);
+    if(stream.consumed) return 0;
+
+    stream.consumed = true;
+    *seid           = static_cast<int>(stream.se_data.shader_engine_id);
+    *buffer         = const_cast<uint8_t*>(stream.se_data.data);
+    *buffer_size    = stream.se_data.size;
+    return *buffer_size;
+}
+
+/**
+ * @brief Threads shared by all rocprofiler_att_parse_data_parallel calls. They are created on
+ * first use and live until the process exits, hence the number of decoding threads is bounded no
+ * matter how many calls are made.
+ */
+class decode_pool
+{
+public:
+    explicit decode_pool(size_t num_workers)
+    {
+        rocprofiler::internal_threading::notify_pre_internal_thread_create(ROCPROFILER_LIBRARY);
+        for(size_t i = 0; i < num_workers; ++i)
+            threads.emplace_back(&decode_pool::run, this);
+        rocprofiler::internal_threading::notify_post_internal_thread_create(ROCPROFILER_LIBRARY);
+    }
+
+    decode_pool(const decode_pool&) = delete;
+    decode_pool& operator=(const decode_pool&) = delete;
+
+    size_t size() const { return threads.size(); }
+
+    void submit(std::function<void()>&& task)
+    {
+        {
+            std::unique_lock<std::mutex> lk(mut);
+            tasks.emplace_back(std::move(task));
+        }
+        cv.notify_one();
+    }
+
+private:
+    void run()
+    {
+        while(true)
+        {
+            auto task = std::function<void()>{};
+            {
+                std::unique_lock<std::mutex> lk(mut);
+                cv.wait(lk, [this]() { return !tasks.empty(); });
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex                        mut     = {};
+    std::condition_variable           cv      = {};
+    std::deque<std::function<void()>> tasks   = {};
+    std::vector<std::thread>          threads = {};
+};
+
+decode_pool*
+get_decode_pool()
+{
+    // the calling thread decodes too. Never destroyed: the threads may still be waiting for tasks
+    static auto* _v =
+        new decode_pool{std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1};
+    return _v;
+}
+
+/**
+ * @brief State of one rocprofiler_att_parse_data_parallel call, shared with the pool tasks. A task
+ * which starts after the call returned finds it finished and does not touch the caller's data.
+ */
+struct parallel_parse_t
+{
+    struct stream_result_t
+    {
+        std::vector<rocprofiler::att_parser::decoded_chunk_t> chunks = {};
+        rocprofiler_status_t                                  status = ROCPROFILER_STATUS_SUCCESS;
+        bool                                                  done   = false;
+    };
+
+    const rocprofiler_att_parser_se_data_t* se_data      = nullptr;
+    size_t                                  num_se_data  = 0;
+    size_t                                  window       = 0;  // max streams decoded ahead
+    rocprofiler_att_parser_isa_callback_t   isa_callback = nullptr;
+    void*                                   userdata     = nullptr;
+
+    std::mutex                   mut         = {};
+    std::condition_variable      cv          = {};
+    std::vector<stream_result_t> results     = {};
+    size_t                       next_stream = 0;  // next stream to be claimed
+    size_t                       delivered   = 0;  // streams delivered to the client
+    size_t                       active      = 0;  // pool tasks taking part in the call
+    bool                         finished    = false;
+};
+
+rocprofiler_status_t
+decode_stream(const parallel_parse_t&                       state,
+              size_t                                        idx,
+              rocprofiler_att_parser_trace_batch_callback_t trace_callback,
+              std::vector<rocprofiler::att_parser::decoded_chunk_t>* decoded)
+{
+    auto stream = se_stream_t{state.se_data[idx], false};
+
+    rocprofiler::att_parser::userdata_callback_table_t table{};
+    table.trace_batch = trace_callback;
+    table.isa         = state.isa_callback;
+    table.se_data     = se_stream_callback;
+    table.se_user     = &stream;
+    table.user        = state.userdata;
+    table.decoded     = decoded;
+
+    return parse_data(table);
+}
+
+/**
+ * @brief Claims and decodes streams ahead of the delivery, keeping at most state.window streams
+ * decoded but not yet delivered.
+ */
+void
+decode_ahead(const std::shared_ptr<parallel_parse_t>& state)
+{
+    std::unique_lock<std::mutex> lk(state->mut);
+    if(state->finished) return;
+    ++state->active;
+
+    while(true)
+    {
+        state->cv.wait(lk, [&state]() {
+            return state->finished || state->next_stream >= state->num_se_data ||
+                   state->next_stream < state->delivered + state->window;
+        });
+        if(state->finished || state->next_stream >= state->num_se_data) break;
+
+        auto  idx    = state->next_stream++;
+        auto& result = state->results.at(idx);
+        lk.unlock();
+
+        auto status = decode_stream(*state, idx, nullptr, &result.chunks);
+
+        lk.lock();
+        result.status = status;
+        result.done   = true;
+        state->cv.notify_all();
+    }
+
+    --state->active;
+    state->cv.notify_all();
+}
+
+/**
+ * @brief Decodes the shader engine streams of se_data on up to num_threads threads, including the
+ * calling thread, and delivers the records stream by stream in the order of se_data as soon as
+ * each stream is ready. The calling thread decodes the next stream to deliver itself when no
+ * worker claimed it, delivering its records directly. Workers decode at most num_threads streams
+ * ahead, which bounds the memory of the decoded but undelivered records.
+ */
+rocprofiler_status_t
+parse_data_parallel(const rocprofiler_att_parser_se_data_t*       se_data,
+                    size_t                                        num_se_data,
+                    rocprofiler_att_parser_trace_batch_callback_t trace_callback,
+                    rocprofiler_att_parser_isa_callback_t         isa_callback,
+                    size_t                                        num_threads,
+                    void*                                         userdata)
+{
+    auto state          = std::make_shared<parallel_parse_t>();
+    state->se_data      = se_data;
+    state->num_se_data  = num_se_data;
+    state->window       = std::max<size_t>(num_threads, 1);
+    state->isa_callback = isa_callback;
+    state->userdata     = userdata;
+    state->results.resize(num_se_data);
+
+    auto num_workers = std::min(num_threads, num_se_data);
+    if(num_workers > 1)
+    {
+        auto* pool  = get_decode_pool();
+        num_workers = std::min(num_workers - 1, pool->size());
+        for(size_t i = 0; i < num_workers; ++i)
+            pool->submit([state]() { decode_ahead(state); });
+    }
+
+    auto deliver = [&](rocprofiler::att_parser::decoded_chunk_t& chunk) {
+        if(chunk.type == ROCPROFILER_ATT_PARSER_DATA_TYPE_ISA)
+            trace_callback(
+                chunk.type, chunk.isa_records.data(), chunk.isa_records.size(), userdata);
+        else
+            trace_callback(chunk.type,
+                           chunk.occupancy_records.data(),
+                           chunk.occupancy_records.size(),
+                           userdata);
+    };
+
+    auto status = ROCPROFILER_STATUS_SUCCESS;
+    auto lk     = std::unique_lock<std::mutex>{state->mut};
+    while(state->delivered < num_se_data)
+    {
+        auto idx           = state->delivered;
+        auto stream_status = ROCPROFILER_STATUS_SUCCESS;
+        if(state->next_stream == idx)
+        {
+            // nobody claimed the next stream to deliver: decode it and deliver it directly
+            ++state->next_stream;
+            lk.unlock();
+            stream_status = decode_stream(*state, idx, trace_callback, nullptr);
+        }
+        else
+        {
+            state->cv.wait(lk, [&state, idx]() { return state->results.at(idx).done; });
+            auto chunks   = std::move(state->results.at(idx).chunks);
+            stream_status = state->results.at(idx).status;
+            lk.unlock();
+
+            for(auto& itr : chunks)
+                deliver(itr);
+        }
+
+        if(status == ROCPROFILER_STATUS_SUCCESS) status = stream_status;
+
+        lk.lock();
+        ++state->delivered;
+        state->cv.notify_all();
+    }
+
+    // tasks which have not started yet return immediately. Wait for the ones which have since
+    // they use the callbacks and userdata of this call
+    state->finished = true;
+    state->cv.notify_all();
+    state->cv.wait(lk, [&state]() { return state->active == 0; });
+
+    return status;
+}
+}  // namespace
+
+extern "C" {
+rocprofiler_status_t
+rocprofiler_att_parse_data(rocprofiler_att_parser_se_data_callback_t user_se_data_callback,
+                           rocprofiler_att_parser_trace_callback_t   user_trace_callback,
+                           rocprofiler_att_parser_isa_callback_t     user_isa_callback,
+                           void*                                     userdata)
+{
+    rocprofiler::att_parser::userdata_callback_table_t table{};
+    table.trace   = user_trace_callback;
+    table.isa     = user_isa_callback;
+    table.se_data = user_se_data_callback;
+    table.se_user = userdata;
+    table.user    = userdata;
+
+    return parse_data(table);
+}
+
+rocprofiler_status_t
+rocprofiler_att_parse_data_batched(
+    rocprofiler_att_parser_se_data_callback_t     user_se_data_callback,
+    rocprofiler_att_parser_trace_batch_callback_t user_trace_callback,
+    rocprofiler_att_parser_isa_callback_t         user_isa_callback,
+    void*                                         userdata)
+{
+    rocprofiler::att_parser::userdata_callback_table_t table{};
+    table.trace_batch = user_trace_callback;
+    table.isa         = user_isa_callback;
+    table.se_data     = user_se_data_callback;
+    table.se_user     = userdata;
+    table.user        = userdata;
+
+    return parse_data(table);
+}
+
+rocprofiler_status_t
+rocprofiler_att_parse_data_parallel(const rocprofiler_att_parser_se_data_t*       se_data,
+                                    size_t                                        num_se_data,
+                                    rocprofiler_att_parser_trace_batch_callback_t trace_callback,
+                                    rocprofiler_att_parser_isa_callback_t         isa_callback,
+                                    size_t                                        num_threads,
+                                    void*                                         userdata)
+{
+    if(num_se_data > 0 && !se_data) return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+    if(!trace_callback || !isa_callback) return ROCPROFILER_STATUS_ERROR_INVALID_ARGUMENT;
+
+    if(num_threads == 0) num_threads = std::thread::hardware_concurrency();
+
+    return parse_data_parallel(
+        se_data, num_se_data, trace_callback, isa_callback, num_threads, userdata);
+}
 }
@@ -328,5 +328,74 @@ execute_buffer_record_emplace(const buffered_context_data_vec_t&   buffered_cont
         }
     }
 }
+
+// true if any of the contexts requested the arguments of the API calls in the domain
+inline bool
+has_buffered_api_args(const buffered_context_data_vec_t& buffered_contexts,
+                      rocprofiler_buffer_tracing_kind_t  domain)
+{
+    for(const auto& itr : buffered_contexts)
+    {
+        if(itr.ctx->buffered_tracer->api_args.at(domain)) return true;
+    }
+    return false;
+}
+
+// same as above but contexts which requested the arguments of the API calls receive args_record,
+// i.e. the record extended with the arguments and return value of the call. Only the leading
+// args_record_size bytes of args_record, i.e. up to the end of the arguments of the operation, are
+// placed in the buffer
+template <typename BufferRecordT,
+          typename ArgsRecordT,
+          typename OperationT = rocprofiler_tracing_operation_t>
+inline void
+execute_buffer_record_emplace(const buffered_context_data_vec_t&   buffered_contexts,
+                              rocprofiler_thread_id_t              thr_id,
+                              uint64_t                             internal_corr_id,
+                              const external_correlation_id_map_t& external_corr_ids,
+                              rocprofiler_buffer_tracing_kind_t    domain,
+                              OperationT                           operation,
+                              BufferRecordT&&                      base_record,
+                              ArgsRecordT&&                        args_record,
+                              size_t                               args_record_size)
+{
+    base_record.thread_id = thr_id;
+    base_record.kind      = domain;
+    base_record.operation = operation;
+    // external correlation will be updated right before record is placed in buffer
+    base_record.correlation_id = rocprofiler_correlation_id_t{internal_corr_id, empty_user_data};
+
+    args_record.thread_id       = base_record.thread_id;
+    args_record.kind            = base_record.kind;
+    args_record.operation       = base_record.operation;
+    args_record.correlation_id  = base_record.correlation_id;
+    args_record.start_timestamp = base_record.start_timestamp;
+    args_record.end_timestamp   = base_record.end_timestamp;
+
+    for(const auto& itr : buffered_contexts)
+    {
+        if(!context_filter(itr.ctx, domain, operation)) continue;
+
+        auto  buffer_id = itr.ctx->buffered_tracer->buffer_data.at(domain);
+        auto* buffer_v  = buffer::get_buffer(buffer_id);
+        if(buffer_v && buffer_v->context_id == itr.ctx->context_idx &&
+           buffer_v->buffer_id == buffer_id.handle)
+        {
+            const auto& extern_corr_id_v = external_corr_ids.at(itr.ctx);
+            if(itr.ctx->buffered_tracer->api_args.at(domain))
+            {
+                args_record.correlation_id.external = extern_corr_id_v;
+                buffer_v->emplace(
+                    ROCPROFILER_BUFFER_CATEGORY_TRACING, domain, args_record, args_record_size);
+            }
+            else
+            {
+                auto record_v                    = base_record;
+                record_v.correlation_id.external = extern_corr_id_v;
+                buffer_v->emplace(ROCPROFILER_BUFFER_CATEGORY_TRACING, domain, record_v);
+            }
+        }
+    }
+}
 }  // namespace tracing
 }  // namespace rocprofiler
@@ -30,6 +30,7 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <deque>
 #include <fstream>
 #include <limits>
 #include <typeinfo>
@@ -169,9 +170,9 @@ validate(const std::vector<rocprofiler_record_header_t*>& _headers,
 {
     (validate<Tp>(_headers, _seq), ...);
 }
-}  // namespace
 
-TEST(buffering, save_load)
+void
+save_load(bool _compress)
 {
     // this test launches 10 threads for each of the data types in test_data_types. Each thread
     // randomly generates 12 array of data of differing sizes and contends with the other threads
@@ -230,7 +231,7 @@ TEST(buffering, save_load)
     {
         auto _ofs = std::fstream{};
         _ofs.open("buffer-save-load.dat", std::ios::out);
-        _buffer.save(_ofs);
+        _buffer.save(_ofs, _compress);
         EXPECT_EQ(_buffer.clear(), num_variants);
     }
 
@@ -267,3 +268,65 @@ TEST(buffering, save_load)
     EXPECT_EQ(_buffer.reset(), 0) << "buffer should be empty after move";
     EXPECT_EQ(_buffer_v.reset(), num_variants);
 }
+}  // namespace
+
+TEST(buffering, save_load) { save_load(false); }
+
+TEST(buffering, save_load_compressed) { save_load(true); }
+
+TEST(buffering, save_load_wrapped)
+{
+    // this test verifies that only the used region of a buffer whose used region wraps around the
+    // end of the buffer is saved and that it is restored at the same positions
+    using ring_buffer_t = rocprofiler::common::container::ring_buffer<uint64_t>;
+
+    for(bool _compress : {false, true})
+    {
+        auto _buffer   = ring_buffer_t{ring_buffer_t::get_items_per_page() * 4};
+        auto _capacity = _buffer.capacity();
+
+        // advance the read pointer past the first half of the buffer and then wrap the write
+        // pointer around the end of the buffer
+        auto _expected = std::deque<uint64_t>{};
+        for(uint64_t i = 0; i < _capacity; ++i)
+        {
+            EXPECT_NE(_buffer.write(&i), nullptr);
+            _expected.emplace_back(i);
+        }
+        for(uint64_t i = 0; i < (_capacity / 2) + 3; ++i)
+        {
+            EXPECT_NE(_buffer.retrieve(), nullptr);
+            _expected.pop_front();
+        }
+        for(uint64_t i = 0; i < (_capacity / 4); ++i)
+        {
+            auto _v = (i % 3) + 1000;
+            EXPECT_NE(_buffer.write(&_v), nullptr);
+            _expected.emplace_back(_v);
+        }
+
+        EXPECT_EQ(_buffer.count(), _expected.size());
+
+        auto _fs = std::fstream{};
+        _fs.open("buffer-save-load-wrapped.dat",
+                 std::ios::binary | std::ios::out | std::ios::in | std::ios::trunc);
+        _buffer.save(_fs, _compress);
+
+        auto _size = static_cast<size_t>(_fs.tellp());
+        EXPECT_LT(_size, (_expected.size() * sizeof(uint64_t)) + 128) << "compress=" << _compress;
+
+        auto _loaded = ring_buffer_t{};
+        _fs.seekg(0);
+        _loaded.load(_fs);
+
+        EXPECT_EQ(_loaded.capacity(), _capacity);
+        ASSERT_EQ(_loaded.count(), _expected.size()) << "compress=" << _compress;
+        for(auto itr : _expected)
+        {
+            auto* _v = _loaded.retrieve();
+            ASSERT_NE(_v, nullptr);
+            EXPECT_EQ(*_v, itr) << "compress=" << _compress;
+        }
+        EXPECT_TRUE(_loaded.is_empty());
+    }
+}
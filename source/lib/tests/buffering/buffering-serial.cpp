@@ -22,6 +22,7 @@
 
 #include "buffering.hpp"
 #include "lib/common/container/record_header_buffer.hpp"
+#include "lib/common/units.hpp"
 
 #include <gtest/gtest.h>
 #include <pthread.h>
@@ -33,7 +34,8 @@
 
 namespace
 {
-namespace test = ::rocprofiler::test;
+namespace test  = ::rocprofiler::test;
+namespace units = ::rocprofiler::common::units;
 
 using uint_raw_array_t       = test::raw_array<uint64_t, 32>;
 using flt_raw_array_t        = test::raw_array<double, 64>;
@@ -170,3 +172,135 @@ TEST(buffering, serial)
                                     << _fp_rhs.to_string() << "\n";
     }
 }
+
+TEST(buffering, serial_emplace_n)
+{
+    // this test verifies that constructing records in-place via emplace_n produces one header
+    // per record, preserves the ordering of the records and stops placing records when the
+    // buffer does not have enough room for all of the requested records.
+
+    constexpr uint32_t category = 1;
+    constexpr uint32_t kind     = 2;
+    constexpr size_t   n        = 120;
+
+    auto _history = std::vector<uint_raw_array_t>{};
+    for(size_t i = 0; i < n; ++i)
+        _history.emplace_back(generate_array<uint64_t, 32>());
+
+    // a buffer which cannot hold all the data
+    auto _buffer   = record_header_buffer_t{(n / 2) * sizeof(uint_raw_array_t)};
+    auto _capacity = _buffer.free() / sizeof(uint_raw_array_t);
+    ASSERT_LT(_capacity, n);
+
+    size_t _offset = 0;
+    auto   _func   = [&_history, &_offset](uint_raw_array_t* _arr, size_t _num) {
+        for(size_t i = 0; i < _num; ++i)
+            new(&_arr[i]) uint_raw_array_t{_history.at(_offset + i)};
+        _offset += _num;
+    };
+
+    EXPECT_EQ(_buffer.emplace_n<uint_raw_array_t>(category, kind, 0, _func), 0);
+    EXPECT_EQ(_buffer.emplace_n<uint_raw_array_t>(category, kind, 1, _func), 1);
+    EXPECT_EQ(_buffer.emplace_n<uint_raw_array_t>(category, kind, n - 1, _func), _capacity - 1);
+    EXPECT_EQ(_buffer.emplace_n<uint_raw_array_t>(category, kind, n, _func), 0);
+    EXPECT_EQ(_offset, _capacity);
+    EXPECT_EQ(_buffer.size(), _capacity);
+
+    auto _headers = _buffer.get_record_headers();
+    ASSERT_EQ(_headers.size(), _capacity);
+    for(size_t i = 0; i < _headers.size(); ++i)
+    {
+        auto* itr = _headers.at(i);
+        ASSERT_TRUE(itr->payload) << "nullptr to payload not expected";
+        EXPECT_EQ(itr->category, category);
+        EXPECT_EQ(itr->kind, kind);
+        EXPECT_EQ(*static_cast<uint_raw_array_t*>(itr->payload), _history.at(i));
+    }
+}
+
+TEST(buffering, memory_options)
+{
+    // this test verifies that the memory placement options do not change the behavior of the
+    // buffer. Explicit huge pages fall back to transparent huge pages when none are reserved
+    // and NUMA node zero always exists so the binding is expected to succeed
+    using ring_buffer_options_t = rocprofiler::common::container::ring_buffer_options;
+
+    constexpr uint64_t n = 64;
+
+    auto _options = std::vector<ring_buffer_options_t>{};
+    for(int64_t numa_node : {-1, 0})
+    {
+        for(bool prefault : {false, true})
+        {
+            auto _opts      = ring_buffer_options_t{};
+            _opts.prefault  = prefault;
+            _opts.numa_node = numa_node;
+            _options.emplace_back(_opts);
+
+            _opts.huge_pages = true;
+            _options.emplace_back(_opts);
+
+            _opts.huge_pages             = false;
+            _opts.transparent_huge_pages = true;
+            _options.emplace_back(_opts);
+        }
+    }
+
+    for(const auto& opts : _options)
+    {
+        auto _buffer = record_header_buffer_t{};
+        ASSERT_TRUE(_buffer.allocate(n * sizeof(uint_raw_array_t), opts));
+        // one header per requested byte, regardless of the rounding up to the huge page size
+        EXPECT_EQ(_buffer.capacity(), n * sizeof(uint_raw_array_t));
+        EXPECT_TRUE(_buffer.is_empty());
+
+        auto _history = std::vector<uint_raw_array_t>{};
+        for(uint64_t i = 0; i < n; ++i)
+        {
+            _history.emplace_back(generate_array<uint64_t, 32>());
+            EXPECT_TRUE(_buffer.emplace(_history.back()));
+        }
+
+        auto _result = std::vector<uint_raw_array_t>{};
+        for(auto* itr : _buffer.get_record_headers())
+            extract_header(_result, itr);
+
+        EXPECT_EQ(_history, _result) << "huge_pages=" << opts.huge_pages
+                                     << ", transparent_huge_pages=" << opts.transparent_huge_pages
+                                     << ", prefault=" << opts.prefault
+                                     << ", numa_node=" << opts.numa_node;
+        EXPECT_EQ(_buffer.reset(), n);
+    }
+}
+
+TEST(buffering, header_count)
+{
+    // this test verifies that a buffer rounded up to the huge page size does not accept more
+    // records than it has headers, i.e. one per requested byte rounded up to the page size
+    const uint64_t n = units::get_page_size();
+
+    auto _opts       = rocprofiler::common::container::ring_buffer_options{};
+    _opts.huge_pages = true;
+
+    auto _buffer = record_header_buffer_t{};
+    ASSERT_TRUE(_buffer.allocate(100, _opts));
+    EXPECT_EQ(_buffer.capacity(), n);
+
+    for(uint64_t i = 0; i < n; ++i)
+    {
+        auto _v = static_cast<uint8_t>(i);
+        EXPECT_TRUE(_buffer.emplace(i + 1, _v));
+    }
+
+    auto _v = uint8_t{0};
+    EXPECT_FALSE(_buffer.emplace(n + 1, _v));
+    auto _fill = [](uint8_t* arr, size_t num) {
+        for(size_t i = 0; i < num; ++i)
+            arr[i] = 0;
+    };
+    EXPECT_EQ(_buffer.emplace_n<uint8_t>(0, 0, 4, _fill), 0);
+    EXPECT_TRUE(_buffer.is_full());
+    EXPECT_EQ(_buffer.get_record_headers().size(), n);
+    EXPECT_EQ(_buffer.clear(), n);
+    EXPECT_TRUE(_buffer.emplace(1, _v));
+}
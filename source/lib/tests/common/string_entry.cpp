@@ -0,0 +1,136 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/container/string_table.hpp"
+#include "lib/common/string_entry.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+namespace common = ::rocprofiler::common;
+
+// size of the direct-mapped per-thread cache in front of the string table
+constexpr size_t thread_cache_size = 64;
+
+size_t
+cache_index(const std::string& value)
+{
+    return common::container::string_table::hash(value) % thread_cache_size;
+}
+}  // namespace
+
+TEST(common, string_entry)
+{
+    auto _id = common::add_string_entry("string-entry-basic");
+    EXPECT_NE(_id, 0);
+    EXPECT_EQ(common::add_string_entry("string-entry-basic"), _id);
+
+    const auto* _value = common::get_string_entry("string-entry-basic");
+    ASSERT_NE(_value, nullptr);
+    EXPECT_EQ(*_value, "string-entry-basic");
+    EXPECT_EQ(common::get_string_entry(_id), _value);
+    EXPECT_EQ(common::get_string_entry(size_t{0}), nullptr);
+    EXPECT_EQ(common::get_dropped_string_entries(), 0);
+}
+
+TEST(common, string_entry_cache_collision)
+{
+    // two strings occupying the same entry of the per-thread cache evict each other: the lookups
+    // must keep resolving to the right string and id
+    auto _lhs = std::string{"string-entry-collision-0"};
+    auto _rhs = std::string{};
+    for(size_t i = 1; _rhs.empty(); ++i)
+    {
+        auto _candidate = "string-entry-collision-" + std::to_string(i);
+        if(cache_index(_candidate) == cache_index(_lhs)) _rhs = _candidate;
+    }
+
+    auto _lhs_id = common::add_string_entry(_lhs);
+    auto _rhs_id = common::add_string_entry(_rhs);
+    EXPECT_NE(_lhs_id, _rhs_id);
+
+    for(size_t i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(common::add_string_entry(_lhs), _lhs_id);
+        EXPECT_EQ(*common::get_string_entry(_lhs), _lhs);
+        EXPECT_EQ(common::add_string_entry(_rhs), _rhs_id);
+        EXPECT_EQ(*common::get_string_entry(_rhs), _rhs);
+    }
+
+    EXPECT_EQ(*common::get_string_entry(_lhs_id), _lhs);
+    EXPECT_EQ(*common::get_string_entry(_rhs_id), _rhs);
+}
+
+TEST(common, string_entry_cross_thread)
+{
+    // each thread has its own cache: the ids and interned strings must agree across threads
+    constexpr size_t num_threads = 4;
+    constexpr size_t num_strings = 2 * thread_cache_size;
+
+    auto _names = std::vector<std::string>{};
+    for(size_t i = 0; i < num_strings; ++i)
+        _names.emplace_back("string-entry-cross-thread-" + std::to_string(i));
+
+    auto _ids     = std::vector<std::vector<size_t>>(num_threads);
+    auto _values  = std::vector<std::vector<const std::string*>>(num_threads);
+    auto _threads = std::vector<std::thread>{};
+    for(size_t n = 0; n < num_threads; ++n)
+    {
+        _threads.emplace_back([&, n]() {
+            for(size_t k = 0; k < 4; ++k)
+            {
+                _ids.at(n).clear();
+                _values.at(n).clear();
+                for(const auto& itr : _names)
+                {
+                    _ids.at(n).emplace_back(common::add_string_entry(itr));
+                    _values.at(n).emplace_back(common::get_string_entry(itr));
+                }
+            }
+        });
+    }
+
+    for(auto& itr : _threads)
+        itr.join();
+
+    for(size_t i = 0; i < num_strings; ++i)
+    {
+        auto _id = _ids.front().at(i);
+        ASSERT_NE(_id, 0);
+        for(size_t n = 1; n < num_threads; ++n)
+        {
+            EXPECT_EQ(_ids.at(n).at(i), _id);
+            EXPECT_EQ(_values.at(n).at(i), _values.front().at(i));
+        }
+
+        // resolved on a thread which did not intern the string
+        ASSERT_NE(common::get_string_entry(_id), nullptr);
+        EXPECT_EQ(*common::get_string_entry(_id), _names.at(i));
+        EXPECT_EQ(common::get_string_entry(_id), _values.front().at(i));
+    }
+}
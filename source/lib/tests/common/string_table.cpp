@@ -0,0 +1,173 @@
+// MIT License
+//
+// Copyright (c) 2023 Advanced Micro Devices, Inc. All rights reserved.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "lib/common/container/string_table.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using string_table = ::rocprofiler::common::container::string_table;
+}  // namespace
+
+TEST(common, string_table_ids)
+{
+    auto _table = string_table{};
+
+    EXPECT_EQ(_table.size(), 1);
+    EXPECT_EQ(_table.find("foo"), 0);
+    EXPECT_EQ(_table.find(uint64_t{0}), nullptr);
+    EXPECT_EQ(_table.find(uint64_t{1}), nullptr);
+
+    // ids are assigned in insertion order starting at one
+    EXPECT_EQ(_table.emplace("foo"), 1);
+    EXPECT_EQ(_table.emplace("bar"), 2);
+    EXPECT_EQ(_table.emplace("foo"), 1);
+    EXPECT_EQ(_table.emplace(""), 3);
+    EXPECT_EQ(_table.size(), 4);
+
+    EXPECT_EQ(_table.find("bar"), 2);
+    EXPECT_EQ(_table.find("baz"), 0);
+    ASSERT_NE(_table.find(uint64_t{1}), nullptr);
+    EXPECT_EQ(*_table.find(uint64_t{1}), "foo");
+    EXPECT_EQ(*_table.find(uint64_t{3}), "");
+    EXPECT_EQ(_table.find(uint64_t{4}), nullptr);
+
+    // the interned copy is stable
+    auto [_id, _value] = _table.intern("foo", string_table::hash("foo"));
+    EXPECT_EQ(_id, 1);
+    EXPECT_EQ(_value, _table.find(uint64_t{1}));
+    EXPECT_EQ(_table.dropped(), 0);
+}
+
+TEST(common, string_table_growth)
+{
+    // enough strings for most of the buckets to be split at least once
+    constexpr size_t num_strings = 200000;
+
+    auto _table = string_table{};
+    for(size_t i = 0; i < num_strings; ++i)
+        ASSERT_EQ(_table.emplace(std::to_string(i)), i + 1);
+
+    EXPECT_EQ(_table.size(), num_strings + 1);
+    for(size_t i = 0; i < num_strings; ++i)
+    {
+        auto _name = std::to_string(i);
+        ASSERT_EQ(_table.find(_name), i + 1);
+        ASSERT_EQ(*_table.find(uint64_t{i + 1}), _name);
+        ASSERT_EQ(_table.emplace(_name), i + 1);
+    }
+}
+
+TEST(common, string_table_hash_collisions)
+{
+    // strings with identical hashes cannot be told apart by splitting the bucket: the list keeps
+    // growing once the hash bits are exhausted
+    constexpr size_t num_strings = 4 * string_table::max_chain_length;
+    constexpr size_t same_hash   = 0xdeadbeef;
+
+    auto _table = string_table{};
+    for(size_t i = 0; i < num_strings; ++i)
+        EXPECT_EQ(_table.emplace(std::to_string(i), same_hash), i + 1);
+
+    for(size_t i = 0; i < num_strings; ++i)
+    {
+        EXPECT_EQ(_table.find(std::to_string(i), same_hash), i + 1);
+        EXPECT_EQ(_table.emplace(std::to_string(i), same_hash), i + 1);
+    }
+    EXPECT_EQ(_table.find(std::to_string(num_strings), same_hash), 0);
+}
+
+TEST(common, string_table_exhausted)
+{
+    constexpr size_t max_ids = 8;
+
+    auto _table = string_table{max_ids};
+    for(size_t i = 1; i < max_ids; ++i)
+        EXPECT_EQ(_table.emplace(std::to_string(i)), i);
+    EXPECT_EQ(_table.dropped(), 0);
+
+    // the new strings are still interned but do not get an id
+    auto [_id, _value] = _table.intern("overflow", string_table::hash("overflow"));
+    EXPECT_EQ(_id, 0);
+    ASSERT_NE(_value, nullptr);
+    EXPECT_EQ(*_value, "overflow");
+    EXPECT_EQ(_table.intern("overflow", string_table::hash("overflow")).second, _value);
+    EXPECT_EQ(_table.emplace("overflow"), 0);
+    EXPECT_EQ(_table.find("overflow"), 0);
+    EXPECT_EQ(_table.dropped(), 3);
+
+    // the strings interned before keep their ids
+    EXPECT_EQ(_table.emplace("1"), 1);
+    EXPECT_EQ(_table.size(), max_ids);
+    EXPECT_EQ(_table.find(uint64_t{max_ids}), nullptr);
+}
+
+TEST(common, string_table_concurrent)
+{
+    constexpr size_t num_threads = 8;
+    // enough strings for the buckets to be split while the threads insert
+    constexpr size_t num_strings = 100000;
+
+    auto _table = string_table{};
+    auto _ids   = std::vector<std::vector<uint64_t>>(num_threads);
+
+    auto _threads = std::vector<std::thread>{};
+    for(size_t n = 0; n < num_threads; ++n)
+    {
+        _threads.emplace_back([&_table, &_ids, n]() {
+            auto& _thread_ids = _ids.at(n);
+            _thread_ids.resize(num_strings, 0);
+            // every thread interns the same strings, half of them in the reverse order
+            for(size_t i = 0; i < num_strings; ++i)
+            {
+                auto _idx            = (n % 2 == 0) ? i : (num_strings - i - 1);
+                _thread_ids.at(_idx) = _table.emplace(std::to_string(_idx));
+            }
+        });
+    }
+
+    for(auto& itr : _threads)
+        itr.join();
+
+    // each string has a single id which resolves to the string
+    auto _unique = std::set<uint64_t>{};
+    for(size_t i = 0; i < num_strings; ++i)
+    {
+        auto _id = _ids.front().at(i);
+        ASSERT_NE(_id, 0);
+        for(size_t n = 1; n < num_threads; ++n)
+            ASSERT_EQ(_ids.at(n).at(i), _id);
+        ASSERT_NE(_table.find(_id), nullptr);
+        EXPECT_EQ(*_table.find(_id), std::to_string(i));
+        EXPECT_EQ(_table.find(std::to_string(i)), _id);
+        _unique.emplace(_id);
+    }
+    EXPECT_EQ(_unique.size(), num_strings);
+}
@@ -32,6 +32,7 @@
 #include <rocprofiler-sdk/cxx/codeobj/code_printing.hpp>
 #include "common.hpp"
 
+#include <array>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
@@ -43,6 +44,7 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace ATTTest
 {
@@ -55,14 +57,31 @@ using Instruction             = rocprofiler::sdk::codeobj::disassembly::Instruct
 
 CodeobjAddressTranslate* codeobjTranslate = nullptr;
 
+// Type, marker_id, offset and the two values of an ISA or occupancy record
+using parsed_record_t = std::array<uint64_t, 5>;
+
 struct trace_data_t
 {
-    int64_t   id;
-    uint8_t*  data;
-    uint64_t  size;
-    ToolData* tool;
+    int64_t                       id;
+    uint8_t*                      data;
+    uint64_t                      size;
+    ToolData*                     tool;
+    std::vector<parsed_record_t>* records = nullptr;
 };
 
+parsed_record_t
+make_record(rocprofiler_att_parser_data_type_t type, const void* att_data)
+{
+    if(type == ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY)
+    {
+        const auto& ev = *static_cast<const rocprofiler_att_data_type_occupancy_t*>(att_data);
+        return {static_cast<uint64_t>(type), ev.marker_id, ev.offset, ev.timestamp, ev.enabled};
+    }
+
+    const auto& ev = *static_cast<const rocprofiler_att_data_type_isa_t*>(att_data);
+    return {static_cast<uint64_t>(type), ev.marker_id, ev.offset, ev.hitcount, ev.latency};
+}
+
 void
 tool_codeobj_tracing_callback(rocprofiler_callback_tracing_record_t record,
                               rocprofiler_user_data_t* /* user_data */,
@@ -115,6 +134,8 @@ get_trace_data(rocprofiler_att_parser_data_type_t type, void* att_data, void* us
     assert(trace_data.tool && "ISA callback passed null!");
     ToolData& tool = *reinterpret_cast<ToolData*>(trace_data.tool);
 
+    if(trace_data.records) trace_data.records->emplace_back(make_record(type, att_data));
+
     std::unique_lock<std::mutex> lk(tool.isa_map_mut);
 
     if(type == ROCPROFILER_ATT_PARSER_DATA_TYPE_OCCUPANCY)
@@ -153,6 +174,24 @@ get_trace_data(rocprofiler_att_parser_data_type_t type, void* att_data, void* us
     C_API_END
 }
 
+void
+get_trace_batch(rocprofiler_att_parser_data_type_t type,
+                void*                              att_data,
+                size_t                             num_records,
+                void*                              userdata)
+{
+    assert(userdata && "Trace callback passed null!");
+    trace_data_t& trace_data = *reinterpret_cast<trace_data_t*>(userdata);
+    assert(trace_data.records && "Trace callback passed null!");
+
+    size_t record_size = (type == ROCPROFILER_ATT_PARSER_DATA_TYPE_ISA)
+                             ? sizeof(rocprofiler_att_data_type_isa_t)
+                             : sizeof(rocprofiler_att_data_type_occupancy_t);
+    for(size_t i = 0; i < num_records; i++)
+        trace_data.records->emplace_back(
+            make_record(type, static_cast<const uint8_t*>(att_data) + i * record_size));
+}
+
 uint64_t
 copy_trace_data(int* seid, uint8_t** buffer, uint64_t* buffer_size, void* userdata)
 {
@@ -201,8 +240,10 @@ isa_callback(char*     isa_instruction,
     memcpy(isa_instruction, instruction->inst.data(), *isa_size);
     *isa_memory_size = instruction->size;
 
+    // May be called concurrently by rocprofiler_att_parse_data_parallel
     auto ptr  = std::make_unique<TrackedIsa>();
     ptr->inst = instruction->inst;
+    std::unique_lock<std::mutex> unique_lock(tool.isa_map_mut);
     tool.isa_map.emplace(pcInfo{offset, marker_id}, std::move(ptr));
     return ROCPROFILER_STATUS_SUCCESS;
     C_API_END
@@ -219,10 +260,38 @@ shader_data_callback(int64_t                 se_id,
     assert(userdata.ptr && "Shader callback passed null!");
     ToolData& tool = *reinterpret_cast<ToolData*>(userdata.ptr);
 
-    trace_data_t data{.id = se_id, .data = (uint8_t*) se_data, .size = data_size, .tool = &tool};
+    auto serial_records = std::vector<parsed_record_t>{};
+    trace_data_t data{.id      = se_id,
+                      .data    = (uint8_t*) se_data,
+                      .size    = data_size,
+                      .tool    = &tool,
+                      .records = &serial_records};
     auto status = rocprofiler_att_parse_data(copy_trace_data, get_trace_data, isa_callback, &data);
     if(status != ROCPROFILER_STATUS_SUCCESS)
         std::cerr << "shader_data_callback failed with status " << status << std::endl;
+
+    // The parallel parser must deliver the same records, stream by stream in the given order
+    auto parallel_records = std::vector<parsed_record_t>{};
+    trace_data_t parallel_data{.id      = se_id,
+                               .data    = (uint8_t*) se_data,
+                               .size    = data_size,
+                               .tool    = &tool,
+                               .records = &parallel_records};
+
+    auto streams = std::vector<rocprofiler_att_parser_se_data_t>(
+        2, rocprofiler_att_parser_se_data_t{se_id, (const uint8_t*) se_data, data_size});
+    auto parallel_status = rocprofiler_att_parse_data_parallel(
+        streams.data(), streams.size(), get_trace_batch, isa_callback, 2, &parallel_data);
+
+    auto expected = serial_records;
+    expected.insert(expected.end(), serial_records.begin(), serial_records.end());
+    if(parallel_status != status || parallel_records != expected)
+    {
+        std::cerr << "rocprofiler_att_parse_data_parallel returned " << parallel_records.size()
+                  << " records with status " << parallel_status << ", expected "
+                  << expected.size() << " records with status " << status << std::endl;
+        exit(EXIT_FAILURE);
+    }
     C_API_END
 }
 